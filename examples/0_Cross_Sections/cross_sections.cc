@@ -74,6 +74,11 @@ namespace
     oss << "                               - Photoelectric" << std::endl;
     oss << "                               - Rayleigh" << std::endl;
     oss << "[--energy X]               Energy in MeV" << std::endl;
+    oss << std::endl;
+    oss << "Benchmark:" << std::endl;
+    oss << "----------" << std::endl;
+    oss << "[--benchmark X]            Number of energy bin lookups measured on device" << std::endl;
+    oss << "                           (X=0, by default, no benchmark)" << std::endl;
     throw std::invalid_argument(oss.str());
   }
 
@@ -111,6 +116,7 @@ int main(int argc, char** argv)
     std::string material_name = "";
     std::string process_name = "";
     GGfloat energy_MeV = 0.0f;
+    GGsize number_of_lookups = 0;
 
     // Loop while there is an argument
     GGint counter(0);
@@ -123,11 +129,12 @@ int main(int argc, char** argv)
         {"material", required_argument, nullptr, 'm'},
         {"device", required_argument, nullptr, 'd'},
         {"process", required_argument, nullptr, 'p'},
-        {"energy", required_argument, nullptr, 'e'}
+        {"energy", required_argument, nullptr, 'e'},
+        {"benchmark", required_argument, nullptr, 'b'}
       };
 
       // Getting the options
-      counter = getopt_long(argc, argv, "hv:m:d:p:e:", sLongOptions, &option_index);
+      counter = getopt_long(argc, argv, "hv:m:d:p:e:b:", sLongOptions, &option_index);
 
       // Exit the loop if -1
       if (counter == -1) break;
@@ -162,6 +169,10 @@ int main(int argc, char** argv)
           ParseCommandLine(optarg, &energy_MeV);
           break;
         }
+        case 'b': {
+          ParseCommandLine(optarg, &number_of_lookups);
+          break;
+        }
         default: {
           PrintHelpAndQuit("Out of switch options!!!", argv[0]);
         }
@@ -229,6 +240,9 @@ int main(int argc, char** argv)
 
     std::cout << "At " << energy_MeV << " MeV, cross section is " << cross_sections.GetPhotonCrossSection(process_name, material_name, energy_MeV, "MeV") << " cm2.g-1" << std::endl;
 
+    // Measuring lookups per second of energy bin in cross section table
+    if (number_of_lookups > 0) cross_sections.BenchmarkEnergyBinLookup(number_of_lookups);
+
     // Cleaning object
     materials.Clean();
     cross_sections.Clean();
@@ -32,6 +32,7 @@ parser.add_argument('-m', '--material', required=True, type=str, help="Set a mat
 parser.add_argument('-p', '--process', required=True, type=str, help="Set a physical process", choices=['Compton', 'Photoelectric', 'Rayleigh'])
 parser.add_argument('-e', '--energy', required=True, type=float, help="Set an energy in MeV")
 parser.add_argument('-v', '--verbose', required=False, type=int, default=0, help="Set level of verbosity")
+parser.add_argument('-b', '--benchmark', required=False, type=int, default=0, help="Number of energy bin lookups measured on device, 0 to skip")
 
 args = parser.parse_args()
 
@@ -41,6 +42,7 @@ energy_MeV = args.energy
 process_name = args.process
 device_id = args.device
 verbosity_level = args.verbose
+number_of_lookups = args.benchmark
 
 # ------------------------------------------------------------------------------
 # STEP 0: Level of verbosity during GGEMS execution
@@ -97,6 +99,10 @@ print('    Energy attenuation: ', attenuations.get_mu_en(material_name, energy_M
 
 print('At ', energy_MeV, ' MeV, cross section is ', cross_sections.get_cs(process_name, material_name, energy_MeV, 'MeV'), 'cm2.g-1')
 
+# Measuring lookups per second of energy bin in cross section table
+if number_of_lookups > 0:
+  cross_sections.benchmark_energy_bin_lookup(number_of_lookups)
+
 # ------------------------------------------------------------------------------
 # STEP 7: Exit safely
 materials.clean()
@@ -88,6 +88,9 @@ namespace {
     oss << "                          (X=1000000, default)" << std::endl;
     oss << "[--seed X]                Seed of pseudo generator number" << std::endl;
     oss << "                          (X=777, default)" << std::endl;
+    oss << "[--woodcock]              Activating Woodcock tracking in phantom" << std::endl;
+    oss << "[--output X]              Basename of projection" << std::endl;
+    oss << "                          (X=data/projection, default)" << std::endl;
     throw std::invalid_argument(oss.str());
   }
 
@@ -125,6 +128,8 @@ int main(int argc, char** argv)
     std::string device = "0";
     std::string device_balance = "";
     GGuint seed = 777;
+    static GGint is_woodcock = 0;
+    std::string output_basename = "data/projection";
 
     // Loop while there is an argument
     GGint counter(0);
@@ -137,11 +142,13 @@ int main(int argc, char** argv)
         {"n-particles", required_argument, nullptr, 'p'},
         {"device", required_argument, nullptr, 'd'},
         {"balance", required_argument, nullptr, 'b'},
-        {"seed", required_argument, nullptr, 's'}
+        {"seed", required_argument, nullptr, 's'},
+        {"woodcock", no_argument, &is_woodcock, 1},
+        {"output", required_argument, nullptr, 'o'}
       };
 
       // Getting the options
-      counter = getopt_long(argc, argv, "hv:p:d:b:s:", sLongOptions, &option_index);
+      counter = getopt_long(argc, argv, "hv:p:d:b:s:o:", sLongOptions, &option_index);
 
       // Exit the loop if -1
       if (counter == -1) break;
@@ -176,6 +183,10 @@ int main(int argc, char** argv)
           ParseCommandLine(optarg, &seed);
           break;
         }
+        case 'o': {
+          output_basename = optarg;
+          break;
+        }
         default: {
           PrintHelpAndQuit("Out of switch options!!!", argv[0]);
         }
@@ -232,6 +243,7 @@ int main(int argc, char** argv)
     phantom.SetPhantomFile("data/phantom.mhd", "data/range_phantom.txt");
     phantom.SetRotation(0.0f, 0.0f, 0.0f, "deg");
     phantom.SetPosition(0.0f, 0.0f, 0.0f, "mm");
+    if (is_woodcock) phantom.SetWoodcockTracking(true);
 
     GGEMSCTSystem ct_detector("Stellar");
     ct_detector.SetCTSystemType("curved");
@@ -243,7 +255,7 @@ int main(int argc, char** argv)
     ct_detector.SetSourceIsocenterDistance(595.0f, "mm");
     ct_detector.SetRotation(0.0f, 0.0f, 0.0f, "deg");
     ct_detector.SetThreshold(10.0f, "keV");
-    ct_detector.StoreOutput("data/projection");
+    ct_detector.StoreOutput(output_basename);
     ct_detector.StoreScatter(true);
 
     // Physics
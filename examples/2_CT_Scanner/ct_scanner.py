@@ -33,6 +33,8 @@ parser.add_argument('-b', '--balance', required=False, type=str, help="X;Y;Z...
 parser.add_argument('-n', '--nparticles', required=False, type=int, default=1000000, help="Number of particles")
 parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number")
 parser.add_argument('-v', '--verbose', required=False, type=int, default=0, help="Set level of verbosity")
+parser.add_argument('-w', '--woodcock', required=False, action='store_true', help="Activating Woodcock tracking in phantom")
+parser.add_argument('-o', '--output', required=False, type=str, default='data/projection', help="Basename of projection")
 
 args = parser.parse_args()
 
@@ -42,6 +44,8 @@ verbosity_level = args.verbose
 number_of_particles = args.nparticles
 device_balancing = args.balance
 seed = args.seed
+is_woodcock = args.woodcock
+output_basename = args.output
 
 # ------------------------------------------------------------------------------
 # STEP 0: Level of verbosity during computation
@@ -100,6 +104,7 @@ phantom = GGEMSVoxelizedPhantom('phantom')
 phantom.set_phantom('data/phantom.mhd', 'data/range_phantom.txt')
 phantom.set_rotation(0.0, 0.0, 0.0, 'deg')
 phantom.set_position(0.0, 0.0, 0.0, 'mm')
+phantom.set_woodcock_tracking(is_woodcock)
 
 ct_detector = GGEMSCTSystem('Stellar')
 ct_detector.set_ct_type('curved')
@@ -111,7 +116,7 @@ ct_detector.set_source_detector_distance(1085.6, 'mm')
 ct_detector.set_source_isocenter_distance(595.0, 'mm')
 ct_detector.set_rotation(0.0, 0.0, 0.0, 'deg')
 ct_detector.set_threshold(10.0, 'keV')
-ct_detector.save('data/projection')
+ct_detector.save(output_basename)
 ct_detector.store_scatter(True)
 
 # ------------------------------------------------------------------------------
@@ -82,6 +82,9 @@ namespace {
     oss << "                               --balance 0.5;0.5 means 50% of computation on device 0, and 50% of computation on device 1" << std::endl;
     oss << "                               --balance 0.32;0.68 means 32% of computation on device 0, and 68% of computation on device 1" << std::endl;
     oss << "                           Total balance has to be equal to 1" << std::endl;
+    oss << "[--particle-stack X]       Number of particles simulated in parallel on each device" << std::endl;
+    oss << "                           (X=0, default, computed from device memory)" << std::endl;
+    oss << "[--blocking-stages]        Host waits after each transport stage instead of chaining stages with events" << std::endl;
     oss << std::endl;
     oss << "Simulation parameters:" << std::endl;
     oss << "----------------------" << std::endl;
@@ -90,6 +93,22 @@ namespace {
     oss << "[--seed X]                Seed of pseudo generator number" << std::endl;
     oss << "                          (X=777, default)" << std::endl;
     oss << "[--tle]                   Activating TLE method" << std::endl;
+    oss << "[--woodcock]              Activating Woodcock tracking in phantom" << std::endl;
+    oss << "[--output X]              Basename of dosimetry outputs" << std::endl;
+    oss << "                          (X=data/dosimetry, default)" << std::endl;
+    oss << "[--label-layout X]        Layout of phantom labels in device memory (linear, brick4, brick8, morton)" << std::endl;
+    oss << "                          (X=linear, default)" << std::endl;
+    oss << "[--benchmark X]           Number of rays measuring label reads of each layout, 0 to skip" << std::endl;
+    oss << "                          (X=0, default)" << std::endl;
+    oss << "[--load-benchmark X]      Number of 512x512 slices measuring conversion of image to labels with 40 ranges, 0 to skip" << std::endl;
+    oss << "                          (X=0, default)" << std::endl;
+    oss << "[--scoring X]             Backend scoring energy deposits (atomic, replicated)" << std::endl;
+    oss << "                          (X=atomic, default)" << std::endl;
+    oss << "[--fixed-point]           Scoring energy deposits as 64 bits integers (quantum of 1 eV)" << std::endl;
+    oss << "[--scoring-benchmark X]   Number of deposits measuring each scoring backend, 0 to skip" << std::endl;
+    oss << "                          (X=0, default)" << std::endl;
+    oss << "[--bvh-benchmark X]       Number of rays searching closest solid in rings of 1 to 512 CT modules, 0 to skip" << std::endl;
+    oss << "                          (X=0, default)" << std::endl;
     throw std::invalid_argument(oss.str());
   }
 
@@ -126,8 +145,19 @@ int main(int argc, char** argv)
     GGsize number_of_particles = 1000000;
     std::string device = "all";
     std::string device_balance = "";
+    GGsize particle_stack_size = 0;
     GGuint seed = 777;
     static GGint is_tle = 0;
+    static GGint is_woodcock = 0;
+    std::string output_basename = "data/dosimetry";
+    static GGint is_fixed_point = 0;
+    static GGint is_blocking_stages = 0;
+    std::string label_layout = "linear";
+    GGsize number_of_rays = 0;
+    GGsize number_of_slices = 0;
+    std::string scoring_backend = "atomic";
+    GGsize number_of_deposits = 0;
+    GGsize number_of_bvh_rays = 0;
 
     // Loop while there is an argument
     GGint counter(0);
@@ -141,11 +171,22 @@ int main(int argc, char** argv)
         {"device", required_argument, nullptr, 'd'},
         {"balance", required_argument, nullptr, 'b'},
         {"seed", required_argument, nullptr, 's'},
+        {"particle-stack", required_argument, nullptr, 'k'},
+        {"blocking-stages", no_argument, &is_blocking_stages, 1},
         {"tle", no_argument, &is_tle, 1},
+        {"woodcock", no_argument, &is_woodcock, 1},
+        {"output", required_argument, nullptr, 'o'},
+        {"label-layout", required_argument, nullptr, 'l'},
+        {"benchmark", required_argument, nullptr, 'r'},
+        {"load-benchmark", required_argument, nullptr, 'x'},
+        {"scoring", required_argument, nullptr, 'c'},
+        {"fixed-point", no_argument, &is_fixed_point, 1},
+        {"scoring-benchmark", required_argument, nullptr, 'e'},
+        {"bvh-benchmark", required_argument, nullptr, 'g'},
       };
 
       // Getting the options
-      counter = getopt_long(argc, argv, "hv:p:d:b:s:", sLongOptions, &option_index);
+      counter = getopt_long(argc, argv, "hv:p:d:b:s:k:o:l:r:x:c:e:g:", sLongOptions, &option_index);
 
       // Exit the loop if -1
       if (counter == -1) break;
@@ -180,6 +221,38 @@ int main(int argc, char** argv)
           ParseCommandLine(optarg, &seed);
           break;
         }
+        case 'k': {
+          ParseCommandLine(optarg, &particle_stack_size);
+          break;
+        }
+        case 'o': {
+          output_basename = optarg;
+          break;
+        }
+        case 'l': {
+          label_layout = optarg;
+          break;
+        }
+        case 'r': {
+          ParseCommandLine(optarg, &number_of_rays);
+          break;
+        }
+        case 'x': {
+          ParseCommandLine(optarg, &number_of_slices);
+          break;
+        }
+        case 'c': {
+          scoring_backend = optarg;
+          break;
+        }
+        case 'e': {
+          ParseCommandLine(optarg, &number_of_deposits);
+          break;
+        }
+        case 'g': {
+          ParseCommandLine(optarg, &number_of_bvh_rays);
+          break;
+        }
         default: {
           PrintHelpAndQuit("Out of switch options!!!", argv[0]);
         }
@@ -207,6 +280,12 @@ int main(int argc, char** argv)
     // Device balancing
     if (!device_balance.empty()) opencl_manager.DeviceBalancing(device_balance);
 
+    // Particle stack size, computed from device memory if not set
+    if (particle_stack_size) opencl_manager.SetParticleStackSize(particle_stack_size);
+
+    // Waiting on host after each transport stage, for benchmark of event chain
+    if (is_blocking_stages) opencl_manager.SetBlockingStages(true);
+
     // Enter material database
     material_manager.SetMaterialsDatabase("data/materials.txt");
 
@@ -236,15 +315,19 @@ int main(int argc, char** argv)
     phantom.SetPhantomFile("data/phantom.mhd", "data/range_phantom.txt");
     phantom.SetRotation(0.0f, 0.0f, 0.0f, "deg");
     phantom.SetPosition(0.0f, 0.0f, 0.0f, "mm");
+    if (is_woodcock) phantom.SetWoodcockTracking(true);
+    phantom.SetLabelLayout(label_layout);
 
     // Dosimetry
     GGEMSDosimetryCalculator dosimetry;
     dosimetry.AttachToNavigator("phantom");
-    dosimetry.SetOutputDosimetryBasename("data/dosimetry");
+    dosimetry.SetOutputDosimetryBasename(output_basename);
     dosimetry.SetDoselSizes(0.5f, 0.5f, 0.5f);
     dosimetry.SetWaterReference(false);
     dosimetry.SetMinimumDensity(0.1f, "g/cm3");
     if (is_tle) dosimetry.SetTLE(true);
+    dosimetry.SetScoringBackend(scoring_backend);
+    if (is_fixed_point) dosimetry.SetFixedPointScoring(true, 1.0f, "eV");
 
     dosimetry.SetUncertainty(true);
     dosimetry.SetPhotonTracking(true);
@@ -291,6 +374,18 @@ int main(int argc, char** argv)
     // Initializing the GGEMS simulation
     ggems.Initialize(seed);
 
+    // Comparing label layouts, isotropic and beams along X and Z
+    if (number_of_rays) phantom.BenchmarkLabelLayouts(number_of_rays);
+
+    // Comparing scan of each range, sorted intervals and look-up table converting image to labels
+    if (number_of_slices) phantom.BenchmarkLabelConversion(number_of_slices);
+
+    // Comparing atomic and replicated scoring in a hot-spot
+    if (number_of_deposits) dosimetry.BenchmarkScoring(number_of_deposits);
+
+    // Comparing BVH and linear search of closest solid for 1 to 512 CT modules
+    if (number_of_bvh_rays) ggems.BenchmarkFindSolid(number_of_bvh_rays);
+
     // Start GGEMS simulation
     ggems.Run();
   }
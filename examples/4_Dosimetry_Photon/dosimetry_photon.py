@@ -33,7 +33,18 @@ parser.add_argument('-b', '--balance', required=False, type=str, help="X;Y;Z...
 parser.add_argument('-n', '--nparticles', required=False, type=int, default=1000000, help="Number of particles")
 parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number")
 parser.add_argument('-v', '--verbose', required=False, type=int, default=0, help="Set level of verbosity")
+parser.add_argument('-k', '--particle-stack', required=False, type=int, default=0, help="Number of particles simulated in parallel on each device, computed from device memory if 0")
+parser.add_argument('-a', '--blocking-stages', required=False, action='store_true', help="Host waits after each transport stage instead of chaining stages with events")
 parser.add_argument('-t', '--tle', required=False, action='store_true', help="Activating TLE method")
+parser.add_argument('-w', '--woodcock', required=False, action='store_true', help="Activating Woodcock tracking in phantom")
+parser.add_argument('-o', '--output', required=False, type=str, default='data/dosimetry', help="Basename of dosimetry outputs")
+parser.add_argument('-l', '--label-layout', required=False, type=str, default='linear', help="Layout of phantom labels in device memory", choices=['linear', 'brick4', 'brick8', 'morton'])
+parser.add_argument('-r', '--benchmark', required=False, type=int, default=0, help="Number of rays measuring label reads of each layout, 0 to skip")
+parser.add_argument('-x', '--load-benchmark', required=False, type=int, default=0, help="Number of 512x512 slices measuring conversion of image to labels with 40 ranges (800 for a large CT), 0 to skip")
+parser.add_argument('-c', '--scoring', required=False, type=str, default='atomic', help="Backend scoring energy deposits", choices=['atomic', 'replicated'])
+parser.add_argument('-f', '--fixed-point', required=False, action='store_true', help="Scoring energy deposits as 64 bits integers (quantum of 1 eV)")
+parser.add_argument('-e', '--scoring-benchmark', required=False, type=int, default=0, help="Number of deposits measuring each scoring backend, 0 to skip")
+parser.add_argument('-g', '--bvh-benchmark', required=False, type=int, default=0, help="Number of rays searching closest solid in rings of 1 to 512 CT modules, 0 to skip")
 
 args = parser.parse_args()
 
@@ -44,6 +55,17 @@ number_of_particles = args.nparticles
 device_balancing = args.balance
 seed = args.seed
 is_tle = args.tle
+is_woodcock = args.woodcock
+output_basename = args.output
+label_layout = args.label_layout
+number_of_rays = args.benchmark
+number_of_slices = args.load_benchmark
+scoring_backend = args.scoring
+is_fixed_point = args.fixed_point
+number_of_deposits = args.scoring_benchmark
+number_of_bvh_rays = args.bvh_benchmark
+particle_stack_size = args.particle_stack
+is_blocking_stages = args.blocking_stages
 
 # ------------------------------------------------------------------------------
 # STEP 0: Level of verbosity during computation
@@ -71,6 +93,12 @@ else:
 if (device_balancing):
   opencl_manager.set_device_balancing(device_balancing)
 
+if (particle_stack_size):
+  opencl_manager.set_particle_stack_size(particle_stack_size)
+
+if (is_blocking_stages):
+  opencl_manager.set_blocking_stages(True)
+
 # ------------------------------------------------------------------------------
 # STEP 3: Setting GGEMS materials
 materials_database_manager.set_materials('data/materials.txt')
@@ -102,16 +130,20 @@ phantom = GGEMSVoxelizedPhantom('phantom')
 phantom.set_phantom('data/phantom.mhd', 'data/range_phantom.txt')
 phantom.set_rotation(0.0, 0.0, 0.0, 'deg')
 phantom.set_position(0.0, 0.0, 0.0, 'mm')
+phantom.set_woodcock_tracking(is_woodcock)
+phantom.set_label_layout(label_layout)
 
 # ------------------------------------------------------------------------------
 # STEP 5: Dosimetry
 dosimetry = GGEMSDosimetryCalculator()
 dosimetry.attach_to_navigator('phantom')
-dosimetry.set_output_basename('data/dosimetry')
+dosimetry.set_output_basename(output_basename)
 dosimetry.set_dosel_size(0.5, 0.5, 0.5, 'mm')
 dosimetry.water_reference(False)
 dosimetry.minimum_density(0.1, 'g/cm3')
 dosimetry.set_tle(is_tle)
+dosimetry.set_scoring_backend(scoring_backend)
+dosimetry.set_fixed_point_scoring(is_fixed_point, 1.0, 'eV')
 
 dosimetry.uncertainty(True)
 dosimetry.photon_tracking(True)
@@ -162,6 +194,22 @@ ggems.tracking_verbose(False, 0)
 # Initializing the GGEMS simulation
 ggems.initialize(seed)
 
+# Comparing label layouts, isotropic and beams along X and Z
+if number_of_rays:
+  phantom.benchmark_label_layouts(number_of_rays)
+
+# Comparing scan of each range, sorted intervals and look-up table converting image to labels
+if number_of_slices:
+  phantom.benchmark_label_conversion(number_of_slices)
+
+# Comparing atomic and replicated scoring in a hot-spot
+if number_of_deposits:
+  dosimetry.benchmark_scoring(number_of_deposits)
+
+# Comparing BVH and linear search of closest solid for 1 to 512 CT modules
+if number_of_bvh_rays:
+  ggems.benchmark_find_solid(number_of_bvh_rays)
+
 # Start GGEMS simulation
 ggems.run()
 
@@ -0,0 +1,71 @@
+# ************************************************************************
+# * This file is part of GGEMS.                                          *
+# *                                                                      *
+# * GGEMS is free software: you can redistribute it and/or modify        *
+# * it under the terms of the GNU General Public License as published by *
+# * the Free Software Foundation, either version 3 of the License, or    *
+# * (at your option) any later version.                                  *
+# *                                                                      *
+# * GGEMS is distributed in the hope that it will be useful,             *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+# * GNU General Public License for more details.                         *
+# *                                                                      *
+# * You should have received a copy of the GNU General Public License    *
+# * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+# *                                                                      *
+# ************************************************************************
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# ------------------------------------------------------------------------------
+# Read arguments
+parser = argparse.ArgumentParser(
+  prog='particle_stack_sweep.py',
+  description='-->> 4 - Dosimetry Example, throughput against particle stack size <<--',
+  epilog='Each stack size runs dosimetry_photon.py in a new process, throughput is computed from elapsed time of GGEMS run (transport and saving, initialization excluded)',
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter
+)
+
+parser.add_argument('-d', '--device', required=False, type=str, default='all', help="OpenCL device (all, cpu, gpu, gpu_nvidia, gpu_intel, gpu_amd, X;Y;Z...)")
+parser.add_argument('-n', '--nparticles', required=False, type=int, default=10000000, help="Number of particles")
+parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number")
+parser.add_argument('-m', '--min-stack', required=False, type=int, default=16384, help="Smallest particle stack size")
+parser.add_argument('-M', '--max-stack', required=False, type=int, default=16777216, help="Biggest particle stack size, sizes are doubled from smallest one")
+parser.add_argument('-a', '--automatic', required=False, action='store_true', help="Also running with stack size computed from device memory")
+
+args = parser.parse_args()
+
+stack_sizes = []
+stack_size = args.min_stack
+while stack_size <= args.max_stack:
+  stack_sizes.append(stack_size)
+  stack_size *= 2
+if args.automatic:
+  stack_sizes.append(0)
+
+# Elapsed time printed by GGEMSChrono::DisplayTime at the end of run
+time_pattern = re.compile(r'Elapsed time \(GGEMS simulation\): (\d+) hours (\d+) mins (\d+) secs (\d+) ms')
+
+example_dir = os.path.dirname(os.path.abspath(__file__))
+
+print('{:>12} {:>12} {:>18}'.format('Stack size', 'Time (s)', 'Particles/s'))
+for stack_size in stack_sizes:
+  command = [sys.executable, os.path.join(example_dir, 'dosimetry_photon.py'),
+    '-d', args.device, '-n', str(args.nparticles), '-s', str(args.seed), '-k', str(stack_size)]
+  process = subprocess.run(command, cwd=example_dir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+
+  stack_name = str(stack_size) if stack_size else 'auto'
+  match = time_pattern.search(process.stdout)
+  if process.returncode != 0 or not match:
+    print('{:>12} {:>12}'.format(stack_name, 'failed'))
+    continue
+
+  hours, mins, secs, ms = (int(x) for x in match.groups())
+  elapsed_time = hours*3600.0 + mins*60.0 + secs + ms/1000.0
+  throughput = args.nparticles / elapsed_time if elapsed_time > 0.0 else float('inf')
+  print('{:>12} {:>12.3f} {:>18.0f}'.format(stack_name, elapsed_time, throughput))
@@ -0,0 +1,72 @@
+# ************************************************************************
+# * This file is part of GGEMS.                                          *
+# *                                                                      *
+# * GGEMS is free software: you can redistribute it and/or modify        *
+# * it under the terms of the GNU General Public License as published by *
+# * the Free Software Foundation, either version 3 of the License, or    *
+# * (at your option) any later version.                                  *
+# *                                                                      *
+# * GGEMS is distributed in the hope that it will be useful,             *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+# * GNU General Public License for more details.                         *
+# *                                                                      *
+# * You should have received a copy of the GNU General Public License    *
+# * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+# *                                                                      *
+# ************************************************************************
+
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# ------------------------------------------------------------------------------
+# Read arguments
+parser = argparse.ArgumentParser(
+  prog='stage_chain_benchmark.py',
+  description='-->> 4 - Dosimetry Example, wall time of transport stages chained by events against blocking stages <<--',
+  epilog='Each run is dosimetry_photon.py in a new process, wall time is elapsed time of GGEMS run (transport and saving, initialization excluded)',
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter
+)
+
+parser.add_argument('-d', '--device', required=False, type=str, default='cpu', help="OpenCL device (all, cpu, gpu, gpu_nvidia, gpu_intel, gpu_amd, X;Y;Z...)")
+parser.add_argument('-n', '--nparticles', required=False, type=int, default=1000000, help="Number of particles")
+parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number")
+parser.add_argument('-k', '--particle-stack', required=False, type=int, default=0, help="Number of particles simulated in parallel on each device, computed from device memory if 0")
+parser.add_argument('-r', '--repeats', required=False, type=int, default=3, help="Number of runs of each mode, best time is kept")
+
+args = parser.parse_args()
+
+# Elapsed time printed by GGEMSChrono::DisplayTime at the end of run
+time_pattern = re.compile(r'Elapsed time \(GGEMS simulation\): (\d+) hours (\d+) mins (\d+) secs (\d+) ms')
+
+example_dir = os.path.dirname(os.path.abspath(__file__))
+
+modes = [('blocking', ['--blocking-stages']), ('event chain', [])]
+best_times = {}
+
+print('{:>12} {:>8} {:>12} {:>18}'.format('Mode', 'Run', 'Time (s)', 'Particles/s'))
+for mode_name, mode_options in modes:
+  for run in range(args.repeats):
+    command = [sys.executable, os.path.join(example_dir, 'dosimetry_photon.py'),
+      '-d', args.device, '-n', str(args.nparticles), '-s', str(args.seed), '-k', str(args.particle_stack)] + mode_options
+    process = subprocess.run(command, cwd=example_dir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+
+    match = time_pattern.search(process.stdout)
+    if process.returncode != 0 or not match:
+      print('{:>12} {:>8} {:>12}'.format(mode_name, run, 'failed'))
+      continue
+
+    hours, mins, secs, ms = (int(x) for x in match.groups())
+    elapsed_time = hours*3600.0 + mins*60.0 + secs + ms/1000.0
+    throughput = args.nparticles / elapsed_time if elapsed_time > 0.0 else float('inf')
+    print('{:>12} {:>8} {:>12.3f} {:>18.0f}'.format(mode_name, run, elapsed_time, throughput))
+
+    if mode_name not in best_times or elapsed_time < best_times[mode_name]:
+      best_times[mode_name] = elapsed_time
+
+if len(best_times) == len(modes) and best_times['event chain'] > 0.0:
+  print('Speedup of event chain against blocking stages (best times): {:.3f}'.format(best_times['blocking'] / best_times['event chain']))
@@ -0,0 +1,184 @@
+# ************************************************************************
+# * This file is part of GGEMS.                                          *
+# *                                                                      *
+# * GGEMS is free software: you can redistribute it and/or modify        *
+# * it under the terms of the GNU General Public License as published by *
+# * the Free Software Foundation, either version 3 of the License, or    *
+# * (at your option) any later version.                                  *
+# *                                                                      *
+# * GGEMS is distributed in the hope that it will be useful,             *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+# * GNU General Public License for more details.                         *
+# *                                                                      *
+# * You should have received a copy of the GNU General Public License    *
+# * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+# *                                                                      *
+# ************************************************************************
+
+
+import argparse
+import array
+import math
+import os
+import re
+import subprocess
+import sys
+
+# ------------------------------------------------------------------------------
+# Read arguments
+parser = argparse.ArgumentParser(
+  prog='woodcock_benchmark.py',
+  description='-->> 4 - Dosimetry Example, Woodcock tracking against exact tracking in phantom <<--',
+  epilog='Each mode runs dosimetry_photon.py (dose) and ../2_CT_Scanner/ct_scanner.py (histograms) in a new process with a different seed. Throughput is computed from elapsed time of GGEMS run, dosels and pixels are compared using their statistical uncertainty',
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter
+)
+
+parser.add_argument('-d', '--device', required=False, type=str, default='all', help="OpenCL device (all, cpu, gpu, gpu_nvidia, gpu_intel, gpu_amd, X;Y;Z...)")
+parser.add_argument('-n', '--nparticles', required=False, type=int, default=10000000, help="Number of particles")
+parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number of exact tracking, seed+1 for Woodcock tracking")
+parser.add_argument('-m', '--min-dose', required=False, type=float, default=0.01, help="Dosels with dose below this fraction of maximum dose are not compared")
+parser.add_argument('-c', '--skip-ct', required=False, action='store_true', help="Not comparing histograms of CT scanner example")
+
+args = parser.parse_args()
+
+# Elapsed time printed by GGEMSChrono::DisplayTime at the end of run
+time_pattern = re.compile(r'Elapsed time \(GGEMS simulation\): (\d+) hours (\d+) mins (\d+) secs (\d+) ms')
+
+example_dir = os.path.dirname(os.path.abspath(__file__))
+ct_example_dir = os.path.join(os.path.dirname(example_dir), '2_CT_Scanner')
+
+# ------------------------------------------------------------------------------
+def run_example(directory, script, options):
+  """Run an example in a new process and return its elapsed time in s, None if failed"""
+  command = [sys.executable, os.path.join(directory, script)] + options
+  process = subprocess.run(command, cwd=directory, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+
+  match = time_pattern.search(process.stdout)
+  if process.returncode != 0 or not match:
+    print(process.stdout)
+    return None
+
+  hours, mins, secs, ms = (int(x) for x in match.groups())
+  return hours*3600.0 + mins*60.0 + secs + ms/1000.0
+
+# ------------------------------------------------------------------------------
+def read_mhd(mhd_filename):
+  """Read values of a mhd/raw image written by GGEMS"""
+  header = {}
+  with open(mhd_filename) as mhd_file:
+    for line in mhd_file:
+      if '=' in line:
+        key, value = line.split('=', 1)
+        header[key.strip()] = value.strip()
+
+  typecode = {'MET_FLOAT': 'f', 'MET_DOUBLE': 'f', 'MET_INT': 'i', 'MET_UINT': 'I'}[header['ElementType']]
+  values = array.array(typecode)
+  with open(os.path.join(os.path.dirname(mhd_filename), header['ElementDataFile']), 'rb') as raw_file:
+    values.frombytes(raw_file.read())
+
+  if (header.get('BinaryDataByteOrderMSB', 'False') == 'True') != (sys.byteorder == 'big'):
+    values.byteswap()
+
+  return values
+
+# ------------------------------------------------------------------------------
+def compare(name, pairs):
+  """Compare values of both modes from (value_exact, sigma_exact, value_woodcock, sigma_woodcock), return True if compatible"""
+  number_of_values = 0
+  within_2_sigma = 0
+  within_3_sigma = 0
+  chi_square = 0.0
+  sum_exact, sum_woodcock, variance_exact, variance_woodcock = 0.0, 0.0, 0.0, 0.0
+
+  for value_exact, sigma_exact, value_woodcock, sigma_woodcock in pairs:
+    sigma = math.sqrt(sigma_exact*sigma_exact + sigma_woodcock*sigma_woodcock)
+    if sigma == 0.0:
+      continue
+
+    z = (value_woodcock - value_exact) / sigma
+    number_of_values += 1
+    if abs(z) <= 2.0: within_2_sigma += 1
+    if abs(z) <= 3.0: within_3_sigma += 1
+    chi_square += z*z
+
+    sum_exact += value_exact
+    sum_woodcock += value_woodcock
+    variance_exact += sigma_exact*sigma_exact
+    variance_woodcock += sigma_woodcock*sigma_woodcock
+
+  if number_of_values == 0:
+    print('{}: nothing to compare'.format(name))
+    return False
+
+  # Difference of sums, values are taken as independent
+  total_sigma = math.sqrt(variance_exact + variance_woodcock)
+  total_z = (sum_woodcock - sum_exact) / total_sigma if total_sigma > 0.0 else 0.0
+
+  fraction_2_sigma = within_2_sigma / number_of_values
+  fraction_3_sigma = within_3_sigma / number_of_values
+  is_compatible = fraction_3_sigma >= 0.98 and abs(total_z) <= 3.0
+
+  print('{}: {} values, {:.2f}% within 2 sigma (95.45% expected), {:.2f}% within 3 sigma (99.73% expected), chi2/ndf {:.3f}'.format(
+    name, number_of_values, 100.0*fraction_2_sigma, 100.0*fraction_3_sigma, chi_square/number_of_values))
+  print('{}: sum exact {:.6e}, sum Woodcock {:.6e}, difference {:.2f} sigma -> {}'.format(
+    name, sum_exact, sum_woodcock, total_z, 'compatible' if is_compatible else 'NOT compatible'))
+
+  return is_compatible
+
+# ------------------------------------------------------------------------------
+# Running both modes
+modes = [('exact', args.seed, []), ('woodcock', args.seed + 1, ['--woodcock'])]
+elapsed_times = {}
+is_compatible = True
+
+print('{:>10} {:>10} {:>12} {:>18}'.format('Example', 'Mode', 'Time (s)', 'Particles/s'))
+for mode_name, seed, mode_options in modes:
+  options = ['-d', args.device, '-n', str(args.nparticles), '-s', str(seed)] + mode_options
+  runs = [('dosimetry', example_dir, 'dosimetry_photon.py', options + ['-o', 'data/woodcock_benchmark_' + mode_name])]
+  if not args.skip_ct:
+    runs.append(('ct', ct_example_dir, 'ct_scanner.py', options + ['-o', 'data/woodcock_benchmark_' + mode_name]))
+
+  for example_name, directory, script, run_options in runs:
+    elapsed_time = run_example(directory, script, run_options)
+    elapsed_times[(example_name, mode_name)] = elapsed_time
+    if elapsed_time is None:
+      print('{:>10} {:>10} {:>12}'.format(example_name, mode_name, 'failed'))
+      continue
+
+    throughput = args.nparticles / elapsed_time if elapsed_time > 0.0 else float('inf')
+    print('{:>10} {:>10} {:>12.3f} {:>18.0f}'.format(example_name, mode_name, elapsed_time, throughput))
+
+for example_name in ('dosimetry', 'ct'):
+  exact_time, woodcock_time = elapsed_times.get((example_name, 'exact')), elapsed_times.get((example_name, 'woodcock'))
+  if exact_time and woodcock_time:
+    print('Speedup of Woodcock tracking ({}): {:.3f}'.format(example_name, exact_time / woodcock_time))
+
+# ------------------------------------------------------------------------------
+# Dose, relative uncertainty of each dosel from dosimetry outputs
+if elapsed_times[('dosimetry', 'exact')] is not None and elapsed_times[('dosimetry', 'woodcock')] is not None:
+  basename = os.path.join(example_dir, 'data', 'woodcock_benchmark_')
+  dose_exact, dose_woodcock = read_mhd(basename + 'exact_dose.mhd'), read_mhd(basename + 'woodcock_dose.mhd')
+  uncertainty_exact, uncertainty_woodcock = read_mhd(basename + 'exact_uncertainty.mhd'), read_mhd(basename + 'woodcock_uncertainty.mhd')
+
+  min_dose = args.min_dose * max(max(dose_exact), max(dose_woodcock))
+  is_compatible &= compare('Dose', (
+    (dose_exact[i], dose_exact[i]*uncertainty_exact[i], dose_woodcock[i], dose_woodcock[i]*uncertainty_woodcock[i])
+    for i in range(len(dose_exact)) if max(dose_exact[i], dose_woodcock[i]) > min_dose))
+else:
+  is_compatible = False
+
+# ------------------------------------------------------------------------------
+# Histograms of primary and scattered photons, Poisson uncertainty of counts
+if not args.skip_ct:
+  if elapsed_times[('ct', 'exact')] is not None and elapsed_times[('ct', 'woodcock')] is not None:
+    basename = os.path.join(ct_example_dir, 'data', 'woodcock_benchmark_')
+    for histogram_name, suffix in (('Histogram', '.mhd'), ('Scatter histogram', '-scatter.mhd')):
+      counts_exact, counts_woodcock = read_mhd(basename + 'exact' + suffix), read_mhd(basename + 'woodcock' + suffix)
+      is_compatible &= compare(histogram_name, (
+        (counts_exact[i], math.sqrt(counts_exact[i]), counts_woodcock[i], math.sqrt(counts_woodcock[i]))
+        for i in range(len(counts_exact))))
+  else:
+    is_compatible = False
+
+sys.exit(0 if is_compatible else 1)
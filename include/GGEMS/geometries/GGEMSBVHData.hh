@@ -0,0 +1,61 @@
+#ifndef GUARD_GGEMS_GEOMETRIES_GGEMSBVHDATA_HH
+#define GUARD_GGEMS_GEOMETRIES_GGEMSBVHDATA_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSBVHData.hh
+
+  \brief Structures storing the bounding volume hierarchy (BVH) built over all the solids of the navigators
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/geometries/GGEMSPrimitiveGeometries.hh"
+
+#define BVH_STACK_SIZE 64 /*!< Size of the stack used to traverse BVH on OpenCL device */
+
+/*!
+  \struct GGEMSBVHNode_t
+  \brief Structure storing a node of BVH, a leaf stores one solid
+*/
+typedef struct GGEMSBVHNode_t
+{
+  GGfloat3 border_min_xyz_; /*!< Min. of AABB border in global frame */
+  GGfloat3 border_max_xyz_; /*!< Max. of AABB border in global frame */
+  GGint left_child_; /*!< Index of left child node, -1 for a leaf */
+  GGint right_child_; /*!< Index of right child node, -1 for a leaf */
+  GGint solid_index_; /*!< Index of solid in BVH solid buffer for a leaf, -1 for an internal node */
+} GGEMSBVHNode; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+/*!
+  \struct GGEMSBVHSolid_t
+  \brief Structure storing geometry of a solid referenced by BVH
+*/
+typedef struct GGEMSBVHSolid_t
+{
+  GGEMSOBB obb_geometry_; /*!< OBB of solid */
+  GGint solid_id_; /*!< Global index of solid */
+} GGEMSBVHSolid; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+#endif // GUARD_GGEMS_GEOMETRIES_GGEMSBVHDATA_HH
@@ -37,6 +37,7 @@
 
 #include "GGEMS/geometries/GGEMSGeometryConstants.hh"
 #include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
+#include "GGEMS/geometries/GGEMSBVHData.hh"
 
 #include "GGEMS/maths/GGEMSMatrixOperations.hh"
 #include "GGEMS/maths/GGEMSReferentialTransformation.hh"
@@ -325,6 +326,127 @@ inline GGfloat ComputeDistanceToOBB(GGfloat3 const* position, GGfloat3 const* di
   );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat ComputeEntryDistanceToAABB(GGfloat3 const* position, GGfloat3 const* direction, GGfloat3 const border_min, GGfloat3 const border_max)
+  \param position - pointer on position of primary particle
+  \param direction - pointer on direction of primary particle
+  \param border_min - min. border of AABB in X, Y and Z
+  \param border_max - max. border of AABB in X, Y and Z
+  \return entry distance in AABB, 0 if particle is inside AABB, OUT_OF_WORLD if AABB is not crossed
+  \brief Compute the entry distance in AABB using slab method, used to skip BVH nodes
+*/
+inline GGfloat ComputeEntryDistanceToAABB(GGfloat3 const* position, GGfloat3 const* direction, GGfloat3 const border_min, GGfloat3 const border_max)
+{
+  GGfloat tmin = 0.0f;
+  GGfloat tmax = OUT_OF_WORLD;
+  GGfloat t1 = 0.0f;
+  GGfloat t2 = 0.0f;
+
+  // On X axis
+  if (fabs(direction->x) < EPSILON6) {
+    if (position->x < border_min.x || position->x > border_max.x) return OUT_OF_WORLD;
+  }
+  else {
+    t1 = (border_min.x - position->x) / direction->x;
+    t2 = (border_max.x - position->x) / direction->x;
+    tmin = fmax(tmin, fmin(t1, t2));
+    tmax = fmin(tmax, fmax(t1, t2));
+  }
+
+  // On Y axis
+  if (fabs(direction->y) < EPSILON6) {
+    if (position->y < border_min.y || position->y > border_max.y) return OUT_OF_WORLD;
+  }
+  else {
+    t1 = (border_min.y - position->y) / direction->y;
+    t2 = (border_max.y - position->y) / direction->y;
+    tmin = fmax(tmin, fmin(t1, t2));
+    tmax = fmin(tmax, fmax(t1, t2));
+  }
+
+  // On Z axis
+  if (fabs(direction->z) < EPSILON6) {
+    if (position->z < border_min.z || position->z > border_max.z) return OUT_OF_WORLD;
+  }
+  else {
+    t1 = (border_min.z - position->z) / direction->z;
+    t2 = (border_max.z - position->z) / direction->z;
+    tmin = fmax(tmin, fmin(t1, t2));
+    tmax = fmin(tmax, fmax(t1, t2));
+  }
+
+  if (tmin > tmax) return OUT_OF_WORLD;
+
+  return tmin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void FindClosestSolidInBVH(GGfloat3 const* position, GGfloat3 const* direction, global GGEMSBVHNode const* bvh_nodes, global GGEMSBVHSolid const* bvh_solids, GGfloat* closest_distance, GGint* closest_solid_id)
+  \param position - pointer on position of primary particle
+  \param direction - pointer on direction of primary particle
+  \param bvh_nodes - pointer to nodes of BVH, root is the first node
+  \param bvh_solids - pointer to solids referenced by BVH leaves, stored in navigator order
+  \param closest_distance - distance to closest solid, updated if a closer solid is found in BVH
+  \param closest_solid_id - global index of closest solid, updated if a closer solid is found in BVH
+  \brief Traverse BVH and find the closest solid, selected solid is the same than testing solids one by one in navigator order
+*/
+inline void FindClosestSolidInBVH(GGfloat3 const* position, GGfloat3 const* direction, global GGEMSBVHNode const* bvh_nodes, global GGEMSBVHSolid const* bvh_solids, GGfloat* closest_distance, GGint* closest_solid_id)
+{
+  // Index of closest solid in BVH, -1 means solid found before traversal
+  GGint closest_index = -1;
+
+  // Stack of nodes to visit, starting with root
+  GGint stack[BVH_STACK_SIZE];
+  GGint stack_size = 0;
+  stack[stack_size++] = 0;
+
+  while (stack_size > 0) {
+    global GGEMSBVHNode const* node = &bvh_nodes[stack[--stack_size]];
+
+    // Skipping node if not crossed or farther than the closest solid
+    GGfloat node_distance = ComputeEntryDistanceToAABB(position, direction, node->border_min_xyz_, node->border_max_xyz_);
+    if (node_distance == OUT_OF_WORLD || node_distance > *closest_distance) continue;
+
+    // Internal node, visiting the closest child first
+    if (node->solid_index_ < 0) {
+      global GGEMSBVHNode const* left_node = &bvh_nodes[node->left_child_];
+      global GGEMSBVHNode const* right_node = &bvh_nodes[node->right_child_];
+      GGfloat left_distance = ComputeEntryDistanceToAABB(position, direction, left_node->border_min_xyz_, left_node->border_max_xyz_);
+      GGfloat right_distance = ComputeEntryDistanceToAABB(position, direction, right_node->border_min_xyz_, right_node->border_max_xyz_);
+
+      if (left_distance <= right_distance) {
+        stack[stack_size++] = node->right_child_;
+        stack[stack_size++] = node->left_child_;
+      }
+      else {
+        stack[stack_size++] = node->left_child_;
+        stack[stack_size++] = node->right_child_;
+      }
+      continue;
+    }
+
+    // Leaf, distance to solid, 0 if particle inside solid
+    global GGEMSBVHSolid const* solid = &bvh_solids[node->solid_index_];
+    GGfloat distance = 0.0f;
+    if (!IsParticleInOBB(position, &solid->obb_geometry_)) distance = ComputeDistanceToOBB(position, direction, &solid->obb_geometry_);
+
+    // Storing the minimum value, for same distance the first solid in navigator order is kept
+    if (distance < *closest_distance || (distance == *closest_distance && distance != OUT_OF_WORLD && closest_index >= 0 && node->solid_index_ < closest_index)) {
+      *closest_distance = distance;
+      *closest_solid_id = solid->solid_id_;
+      closest_index = node->solid_index_;
+    }
+  }
+}
+
 #endif
 
 #endif // End of GUARD_GGEMS_GEOMETRIES_GGEMSRAYTRACING_HH
@@ -35,6 +35,7 @@
 
 #include "GGEMS/io/GGEMSTextReader.hh"
 #include "GGEMS/io/GGEMSHistogramMode.hh"
+#include "GGEMS/geometries/GGEMSPrimitiveGeometries.hh"
 #include "GGEMS/tools/GGEMSRAMManager.hh"
 #include "GGEMS/navigators/GGEMSNavigatorManager.hh"
 
@@ -175,6 +176,22 @@ class GGEMS_EXPORT GGEMSSolid
     template<typename T>
     void SetSolidID(GGsize const& solid_id, GGsize const& thread_index);
 
+    /*!
+      \fn GGint GetSolidID(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return the global solid index
+      \brief get the global solid index
+    */
+    virtual GGint GetSolidID(GGsize const& thread_index) const = 0;
+
+    /*!
+      \fn GGEMSOBB GetOBBGeometry(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return OBB of solid in global frame
+      \brief get the OBB geometry of solid
+    */
+    virtual GGEMSOBB GetOBBGeometry(GGsize const& thread_index) const = 0;
+
     /*!
       \fn void UpdateTransformationMatrix(GGsize const& thread_index)
       \param thread_index - index of the thread (= activated device index)
@@ -248,6 +265,27 @@ class GGEMS_EXPORT GGEMSSolid
     */
     inline cl::Buffer* GetScatterHistogram(GGsize const& thread_index) const {return histogram_.scatter_[thread_index];}
 
+    /*!
+      \fn inline GGsize GetNumberOfHistogramElements(void) const
+      \return number of elements in histogram
+      \brief get the number of elements in histogram
+    */
+    inline GGsize GetNumberOfHistogramElements(void) const {return histogram_.number_of_elements_;}
+
+    /*!
+      \fn inline bool IsLocalHistogram(void) const
+      \return true if tracking kernel counts hits in a local copy of histogram
+      \brief check if histogram is counted in local memory by work-group
+    */
+    inline bool IsLocalHistogram(void) const {return histogram_.is_local_;}
+
+    /*!
+      \fn inline std::string GetKernelOption(void) const
+      \return preprocessor options used to compile solid kernels
+      \brief get the preprocessor options of solid kernels
+    */
+    inline std::string GetKernelOption(void) const {return kernel_option_;}
+
     /*!
       \fn void SetVisible(bool const& is_visible)
       \param is_visible - true if navigator is drawn using OpenGL
@@ -301,6 +339,7 @@ class GGEMS_EXPORT GGEMSSolid
     cl::Buffer** solid_data_; /*!< Data about solid */
     cl::Buffer** label_data_; /*!< Pointer storing the buffer about label data, useful for voxelized solid only */
     std::size_t number_of_voxels_; /*!< Number of voxel 1 for GGEMSSolidBox */
+    std::size_t label_data_size_; /*!< Number of labels allocated, voxels of incomplete bricks included */
     GGsize number_activated_devices_; /*!< Number of activated device */
 
     // Geometric transformation applyied to solid
@@ -111,6 +111,22 @@ class GGEMS_EXPORT GGEMSSolidBox : public GGEMSSolid
     */
     void UpdateTransformationMatrix(GGsize const& thread_index) override;
 
+    /*!
+      \fn GGint GetSolidID(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return the global solid index
+      \brief get the global solid index
+    */
+    GGint GetSolidID(GGsize const& thread_index) const override;
+
+    /*!
+      \fn GGEMSOBB GetOBBGeometry(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return OBB of solid in global frame
+      \brief get the OBB geometry of solid
+    */
+    GGEMSOBB GetOBBGeometry(GGsize const& thread_index) const override;
+
   private:
     /*!
       \fn void InitializeKernel(void)
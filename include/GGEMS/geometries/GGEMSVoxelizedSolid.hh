@@ -31,8 +31,44 @@
   \date Wednesday June 10, 2020
 */
 
+#ifdef _MSC_VER
+#pragma warning(disable: 4251) // Deleting warning exporting STL members!!!
+#endif
+
+#include <thread>
+#include <type_traits>
+
 #include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
 #include "GGEMS/geometries/GGEMSSolid.hh"
+#include "GGEMS/io/GGEMSMHDImage.hh"
+#include "GGEMS/tools/GGEMSChrono.hh"
+
+/*!
+  \struct GGEMSRangeLabels_t
+  \brief Ranges of a range file split in sorted intervals without overlap, the last range of the file wins
+*/
+typedef struct GGEMSRangeLabels_t
+{
+  std::vector<GGfloat> bounds_; /*!< Sorted bounds of ranges */
+  std::vector<GGuchar> bound_labels_; /*!< Label of a value equal to a bound */
+  std::vector<GGuchar> interval_labels_; /*!< Label of values between a bound and the next one */
+
+  /*!
+    \fn void Build(std::vector<GGfloat> const& first_label_values, std::vector<GGfloat> const& last_label_values)
+    \param first_label_values - first value of each range, in file order
+    \param last_label_values - last value of each range, in file order
+    \brief split ranges [first, last[ (or [first, first] for a single value) in sorted intervals, label of a range is its index in file
+  */
+  void Build(std::vector<GGfloat> const& first_label_values, std::vector<GGfloat> const& last_label_values);
+
+  /*!
+    \fn GGuchar GetLabel(GGfloat const& value) const
+    \param value - value of voxel in image
+    \return label of the value, max of GGuchar if value is not in a range
+    \brief find label of a value with a binary search in sorted intervals
+  */
+  GGuchar GetLabel(GGfloat const& value) const;
+} GGEMSRangeLabels; /*!< Using C convention name of struct to C++ (_t deletion) */
 
 /*!
   \class GGEMSVoxelizedSolid
@@ -115,6 +151,14 @@ class GGEMS_EXPORT GGEMSVoxelizedSolid : public GGEMSSolid
     */
     void UpdateTransformationMatrix(GGsize const& thread_index) override;
 
+    /*!
+      \fn GGint GetSolidID(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return the global solid index
+      \brief get the global solid index
+    */
+    GGint GetSolidID(GGsize const& thread_index) const override;
+
     /*!
       \fn GGfloat3 GetVoxelSizes(GGsize const& thread_index) const
       \param thread_index - index of the thread (= activated device index)
@@ -129,19 +173,65 @@ class GGEMS_EXPORT GGEMSVoxelizedSolid : public GGEMSSolid
       \return OBB params for the object
       \brief return the parameters about OBB geometry
     */
-    GGEMSOBB GetOBBGeometry(GGsize const& thread_index) const;
+    GGEMSOBB GetOBBGeometry(GGsize const& thread_index) const override;
+
+    /*!
+      \fn void SetLabelLayout(std::string const& label_layout)
+      \param label_layout - layout of label data: linear, brick4, brick8 or morton
+      \brief Set the layout of label data in memory, must be called before initialization
+    */
+    void SetLabelLayout(std::string const& label_layout);
+
+    /*!
+      \fn void BenchmarkLabelLayouts(GGsize const& number_of_rays) const
+      \param number_of_rays - number of rays walking through the labels
+      \brief Measure label reads per second for each label layout, with isotropic directions and beams along X and along Z
+    */
+    void BenchmarkLabelLayouts(GGsize const& number_of_rays) const;
+
+    /*!
+      \fn static void BenchmarkLabelConversion(GGsize const& number_of_slices)
+      \param number_of_slices - number of 512x512 slices of the synthetic 16 bits image
+      \brief Measure conversion of an image to labels with 40 ranges, scanning all voxels for each range as before against sorted intervals and look-up table
+    */
+    static void BenchmarkLabelConversion(GGsize const& number_of_slices);
 
   private:
     /*!
-      \fn template <typename T> void ConvertImageToLabel(std::string const& raw_data_filename, std::string const& range_data_filename, GGEMSMaterials* materials)
+      \fn template <typename T> void ConvertImageToLabel(GGEMSMHDImage& mhd_image, std::string const& range_data_filename, GGEMSMaterials* materials)
       \tparam T - type of data
-      \param raw_data_filename - raw data filename from mhd
+      \param mhd_image - mhd image with header already read, raw data are mapped in memory
       \param range_data_filename - name of the file containing the range to material data
       \param materials - pointer on material for a phantom
       \brief convert image data to label data
     */
     template <typename T>
-    void ConvertImageToLabel(std::string const& raw_data_filename, std::string const& range_data_filename, GGEMSMaterials* materials);
+    void ConvertImageToLabel(GGEMSMHDImage& mhd_image, std::string const& range_data_filename, GGEMSMaterials* materials);
+
+    /*!
+      \fn void ReadRangeLabels(std::string const& range_data_filename, GGEMSMaterials* materials)
+      \param range_data_filename - name of the file containing the range to material data
+      \param materials - pointer on material for a phantom
+      \brief read range file once, and split ranges in sorted intervals without overlap, the last range of the file wins as before
+    */
+    void ReadRangeLabels(std::string const& range_data_filename, GGEMSMaterials* materials);
+
+    /*!
+      \fn template <typename T> static GGsize ConvertRawDataToLabel(T const* raw_data, bool const& is_byte_swapped, GGEMSRangeLabels const& range_labels, bool const& is_look_up_table, GGint const& label_layout, GGint3 const& number_of_voxels_xyz, std::vector<GGuchar>& label_data, GGsize& number_of_threads)
+      \tparam T - type of data
+      \param raw_data - values of voxels in linear order
+      \param is_byte_swapped - flag swapping bytes of values
+      \param range_labels - sorted intervals of ranges
+      \param is_look_up_table - flag converting with a table storing label of each possible value, only for integer types on 8 or 16 bits
+      \param label_layout - layout of label data
+      \param number_of_voxels_xyz - number of voxels in X, Y and Z
+      \param label_data - labels in the layout, voxels of incomplete bricks are never written
+      \param number_of_threads - number of host threads used for conversion
+      \return number of voxels not in a range
+      \brief convert values of voxels to labels, slices are converted by host threads
+    */
+    template <typename T>
+    static GGsize ConvertRawDataToLabel(T const* raw_data, bool const& is_byte_swapped, GGEMSRangeLabels const& range_labels, bool const& is_look_up_table, GGint const& label_layout, GGint3 const& number_of_voxels_xyz, std::vector<GGuchar>& label_data, GGsize& number_of_threads);
 
     /*!
       \fn void InitializeKernel(void)
@@ -152,6 +242,8 @@ class GGEMS_EXPORT GGEMSVoxelizedSolid : public GGEMSSolid
   private:
     std::string volume_header_filename_; /*!< Filename of MHD file for phantom */
     std::string range_filename_; /*!< Filename of file for range data */
+    GGint label_layout_; /*!< Layout of label data in memory */
+    GGEMSRangeLabels range_labels_; /*!< Sorted intervals of ranges read in range file */
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -159,101 +251,121 @@ class GGEMS_EXPORT GGEMSVoxelizedSolid : public GGEMSSolid
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename T>
-void GGEMSVoxelizedSolid::ConvertImageToLabel(std::string const& raw_data_filename, std::string const& range_data_filename, GGEMSMaterials* materials)
+void GGEMSVoxelizedSolid::ConvertImageToLabel(GGEMSMHDImage& mhd_image, std::string const& range_data_filename, GGEMSMaterials* materials)
 {
   GGcout("GGEMSVoxelizedSolid", "ConvertImageToLabel", 3) << "Converting image material data to label data..." << GGendl;
 
   // Get the OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
+  ChronoTime start_time = GGEMSChrono::Now();
+
+  // Layout of labels is chosen at loading, image is the same on each device
+  GGint3 number_of_voxels_xyz;
   for (GGsize d = 0; d < number_activated_devices_; ++d) {
-    // Get pointer on OpenCL device
     GGEMSVoxelizedSolidData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSVoxelizedSolidData>(solid_data_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSVoxelizedSolidData), d);
-
-    // Get information about mhd file
     number_of_voxels_ = static_cast<GGsize>(solid_data_device->number_of_voxels_);
-
-    // Release the pointer
+    number_of_voxels_xyz = solid_data_device->number_of_voxels_xyz_;
+    solid_data_device->label_layout_ = label_layout_;
     opencl_manager.ReleaseDeviceBuffer(solid_data_[d], solid_data_device, d);
+  }
+  label_data_size_ = GetLabelDataSize(label_layout_, number_of_voxels_xyz);
 
-    // Checking if file exists
-    std::ifstream in_raw_stream(raw_data_filename, std::ios::in | std::ios::binary);
-    GGEMSFileStream::CheckInputStream(in_raw_stream, raw_data_filename);
-
-    // Reading data to a tmp buffer
-    std::vector<T> tmp_raw_data;
-    tmp_raw_data.resize(number_of_voxels_);
-    in_raw_stream.read(reinterpret_cast<char*>(&tmp_raw_data[0]), static_cast<std::streamsize>(number_of_voxels_ * sizeof(T)));
+  // Raw data mapped once for all devices, read from page cache while converting, bytes swapped on the fly if needed
+  T const* raw_data = mhd_image.GetRawData<T>();
 
-    // Closing file
-    in_raw_stream.close();
+  ChronoTime read_time = GGEMSChrono::Now();
 
-    // Allocating memory on OpenCL device
-    label_data_[d] = opencl_manager.Allocate(nullptr, number_of_voxels_ * sizeof(GGuchar), d, CL_MEM_READ_WRITE, "GGEMSVoxelizedSolid");
+  // Reading range file once
+  ReadRangeLabels(range_data_filename, materials);
 
-    // Get pointer on OpenCL device
-    GGuchar* label_data_device = opencl_manager.GetDeviceBuffer<GGuchar>(label_data_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, number_of_voxels_ * sizeof(GGuchar), d);
+  // Small integer types are converted with a table storing label of each possible value
+  bool const kIsLookUpTable = std::is_integral<T>::value && sizeof(T) <= 2;
 
-    // Set value to max of GGuchar
-    std::fill(label_data_device, label_data_device + number_of_voxels_, std::numeric_limits<GGuchar>::max());
+  // Labels in the chosen layout, voxels of incomplete bricks are never read
+  std::vector<GGuchar> label_data(label_data_size_, static_cast<GGuchar>(0));
+  GGsize number_of_threads = 0;
+  GGsize total_not_converted = ConvertRawDataToLabel(raw_data, mhd_image.IsByteSwapped(), range_labels_, kIsLookUpTable, label_layout_, number_of_voxels_xyz, label_data, number_of_threads);
 
-    // Opening range data file
-    std::ifstream in_range_stream(range_data_filename, std::ios::in);
-    GGEMSFileStream::CheckInputStream(in_range_stream, range_data_filename);
+  mhd_image.UnmapRawData();
 
-    // Values in the range file
-    GGfloat first_label_value = 0.0f;
-    GGfloat last_label_value = 0.0f;
-    GGuchar label_index = 0;
-    std::string material_name("");
+  // Checking if all voxels converted
+  if (total_not_converted > 0) {
+    GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "ConvertImageToLabel", "Errors(s) in the range data file!!!");
+  }
+  GGcout("GGEMSVoxelizedSolid", "ConvertImageToLabel", 2) << "All your voxels are converted to label..." << GGendl;
 
-    // Reading range file
-    std::string line("");
-    while (std::getline(in_range_stream, line)) {
-      // Check if blank line
-      if (GGEMSTextReader::IsBlankLine(line)) continue;
+  ChronoTime convert_time = GGEMSChrono::Now();
 
-      // Getting the value in string stream
-      std::istringstream iss = GGEMSRangeReader::ReadRangeMaterial(line);
-      iss >> first_label_value >> last_label_value >> material_name;
+  // Same label volume uploaded on each device
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    label_data_[d] = opencl_manager.Allocate(nullptr, label_data_size_ * sizeof(GGuchar), d, CL_MEM_READ_WRITE, "GGEMSVoxelizedSolid");
+    GGuchar* label_data_device = opencl_manager.GetDeviceBuffer<GGuchar>(label_data_[d], CL_TRUE, CL_MAP_WRITE, label_data_size_ * sizeof(GGuchar), d);
+    std::copy(label_data.begin(), label_data.end(), label_data_device);
+    opencl_manager.ReleaseDeviceBuffer(label_data_[d], label_data_device, d);
+  }
 
-      // Adding the material only once
-      if (d == 0) materials->AddMaterial(material_name);
+  ChronoTime upload_time = GGEMSChrono::Now();
 
-      // Setting the label
-      for (GGsize i = 0; i < number_of_voxels_; ++i) {
-        // Getting the value of phantom
-        GGfloat value = static_cast<GGfloat>(tmp_raw_data[i]);
-        if (((value == first_label_value) && (value == last_label_value)) || ((value >= first_label_value) && (value < last_label_value))) {
-          label_data_device[i] = label_index;
-        }
-      }
+  GGcout("GGEMSVoxelizedSolid", "ConvertImageToLabel", 2) << "Loading " << number_of_voxels_ << " voxels: mapping " << std::chrono::duration_cast<Ms>(read_time - start_time).count() << " ms, converting "
+    << std::chrono::duration_cast<Ms>(convert_time - read_time).count() << " ms (" << (kIsLookUpTable ? "look-up table" : "sorted ranges") << ", " << number_of_threads << " threads), uploading to "
+    << number_activated_devices_ << " device(s) " << std::chrono::duration_cast<Ms>(upload_time - convert_time).count() << " ms" << GGendl;
+}
 
-      // Increment the label index
-      ++label_index;
-    }
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    // Final loop checking if a value is still max of GGuchar
-    bool all_converted = true;
-    for (GGsize i = 0; i < number_of_voxels_; ++i) {
-      if (label_data_device[i] == std::numeric_limits<GGuchar>::max()) all_converted = false;
+template <typename T>
+GGsize GGEMSVoxelizedSolid::ConvertRawDataToLabel(T const* raw_data, bool const& is_byte_swapped, GGEMSRangeLabels const& range_labels, bool const& is_look_up_table, GGint const& label_layout, GGint3 const& number_of_voxels_xyz, std::vector<GGuchar>& label_data, GGsize& number_of_threads)
+{
+  bool const kIsByteSwapped = sizeof(T) > 1 && is_byte_swapped;
+
+  // Table storing label of each possible value
+  bool const kIsLookUpTable = is_look_up_table && std::is_integral<T>::value && sizeof(T) <= 2;
+  std::vector<GGuchar> lut;
+  if (kIsLookUpTable) {
+    lut.resize(static_cast<GGsize>(std::numeric_limits<T>::max()) - static_cast<GGsize>(std::numeric_limits<T>::min()) + 1);
+    for (GGsize i = 0; i < lut.size(); ++i) {
+      lut[i] = range_labels.GetLabel(static_cast<GGfloat>(static_cast<GGdouble>(std::numeric_limits<T>::min()) + static_cast<GGdouble>(i)));
     }
+  }
 
-    // Closing file
-    in_range_stream.close();
-    tmp_raw_data.clear();
+  // Slices are converted by host threads, each voxel has its own place in label data
+  number_of_threads = std::max(static_cast<GGsize>(std::thread::hardware_concurrency()), static_cast<GGsize>(1));
+  number_of_threads = std::min(number_of_threads, static_cast<GGsize>(number_of_voxels_xyz.s[2]));
+  GGint slices_by_thread = static_cast<GGint>((static_cast<GGsize>(number_of_voxels_xyz.s[2]) + number_of_threads - 1) / number_of_threads);
+  std::vector<GGsize> not_converted(number_of_threads, 0);
+
+  std::vector<std::thread> threads;
+  for (GGsize t = 0; t < number_of_threads; ++t) {
+    GGint first_slice = static_cast<GGint>(t) * slices_by_thread;
+    GGint last_slice = std::min(first_slice + slices_by_thread, number_of_voxels_xyz.s[2]);
+    if (first_slice >= last_slice) break;
+    threads.emplace_back([&, t, first_slice, last_slice]() {
+      for (GGint k = first_slice; k < last_slice; ++k) {
+        GGsize voxel_id = static_cast<GGsize>(k) * static_cast<GGsize>(number_of_voxels_xyz.s[0]) * static_cast<GGsize>(number_of_voxels_xyz.s[1]);
+        for (GGint j = 0; j < number_of_voxels_xyz.s[1]; ++j) {
+          for (GGint i = 0; i < number_of_voxels_xyz.s[0]; ++i) {
+            T value = kIsByteSwapped ? GGEMSMHDImage::SwapBytes(raw_data[voxel_id]) : raw_data[voxel_id];
+            GGuchar label = kIsLookUpTable
+              ? lut[static_cast<GGsize>(static_cast<GGdouble>(value) - static_cast<GGdouble>(std::numeric_limits<T>::min()))]
+              : range_labels.GetLabel(static_cast<GGfloat>(value));
+            if (label == std::numeric_limits<GGuchar>::max()) ++not_converted[t];
+            label_data[LabelIndex(label_layout, i, j, k, number_of_voxels_xyz.s[0], number_of_voxels_xyz.s[1])] = label;
+            ++voxel_id;
+          }
+        }
+      }
+    });
+  }
+  for (auto&& thread : threads) thread.join();
+  number_of_threads = threads.size();
 
-    // Release the pointer
-    opencl_manager.ReleaseDeviceBuffer(label_data_[d], label_data_device, d);
+  GGsize total_not_converted = 0;
+  for (auto&& n : not_converted) total_not_converted += n;
 
-    // Checking if all voxels converted
-    if (all_converted) {
-      GGcout("GGEMSVoxelizedSolid", "ConvertImageToLabel", 2) << "All your voxels are converted to label..." << GGendl;
-    }
-    else {
-      GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "ConvertImageToLabel", "Errors(s) in the range data file!!!");
-    }
-  }
+  return total_not_converted;
 }
 
 #endif // End of GUARD_GGEMS_GEOMETRIES_GGEMSVOXELIZEDSOLID_HH
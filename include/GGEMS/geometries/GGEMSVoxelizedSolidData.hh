@@ -33,6 +33,11 @@
 
 #include "GGEMS/geometries/GGEMSPrimitiveGeometries.hh"
 
+#define LINEAR_LABEL_LAYOUT 0 /*!< Labels stored X fastest, then Y, then Z */
+#define BRICK4_LABEL_LAYOUT 1 /*!< Labels stored by bricks of 4x4x4 voxels, X fastest inside a brick */
+#define BRICK8_LABEL_LAYOUT 2 /*!< Labels stored by bricks of 8x8x8 voxels, X fastest inside a brick */
+#define MORTON_LABEL_LAYOUT 3 /*!< Labels stored by bricks of 8x8x8 voxels, Z-order (Morton) inside a brick */
+
 /*!
   \struct GGEMSVoxelizedSolidData_t
   \brief Structure storing the stack of data for voxelized solid
@@ -44,6 +49,82 @@ typedef struct GGEMSVoxelizedSolidData_t
   GGint3 number_of_voxels_xyz_; /*!< Number of voxel in X, Y and Z */
   GGint solid_id_; /*!< Navigator index */
   GGint number_of_voxels_; /*!< Total number of voxels */
+  GGint label_layout_; /*!< Layout of label data in memory, see LabelIndex */
 } GGEMSVoxelizedSolidData; /*!< Using C convention name of struct to C++ (_t deletion) */
 
+/*!
+  \fn inline GGint LabelBrickShift(GGint const label_layout)
+  \param label_layout - layout of label data
+  \return log2 of brick size, 0 for linear layout
+  \brief Get the size of bricks of a label layout as a shift
+*/
+inline GGint LabelBrickShift(GGint const label_layout)
+{
+  if (label_layout == LINEAR_LABEL_LAYOUT) return 0;
+  else if (label_layout == BRICK4_LABEL_LAYOUT) return 2;
+  else return 3;
+}
+
+/*!
+  \fn inline GGint LabelIndex(GGint const label_layout, GGint const voxel_x, GGint const voxel_y, GGint const voxel_z, GGint const number_of_voxels_x, GGint const number_of_voxels_y)
+  \param label_layout - layout of label data
+  \param voxel_x - index of voxel in X
+  \param voxel_y - index of voxel in Y
+  \param voxel_z - index of voxel in Z
+  \param number_of_voxels_x - number of voxels in X
+  \param number_of_voxels_y - number of voxels in Y
+  \return index of voxel in label data
+  \brief Get the index of a voxel in label data. In brick layouts, neighbour voxels along Y and Z share the same cache lines, bricks are stored X fastest
+*/
+inline GGint LabelIndex(GGint const label_layout, GGint const voxel_x, GGint const voxel_y, GGint const voxel_z, GGint const number_of_voxels_x, GGint const number_of_voxels_y)
+{
+  if (label_layout == LINEAR_LABEL_LAYOUT) return voxel_x + voxel_y * number_of_voxels_x + voxel_z * number_of_voxels_x * number_of_voxels_y;
+
+  GGint shift = LabelBrickShift(label_layout);
+  GGint mask = (1 << shift) - 1;
+
+  // Index of brick, number of bricks is rounded up
+  GGint number_of_bricks_x = (number_of_voxels_x + mask) >> shift;
+  GGint number_of_bricks_y = (number_of_voxels_y + mask) >> shift;
+  GGint brick_id = (voxel_x >> shift) + ((voxel_y >> shift) + (voxel_z >> shift) * number_of_bricks_y) * number_of_bricks_x;
+
+  // Index of voxel inside brick
+  GGint local_x = voxel_x & mask;
+  GGint local_y = voxel_y & mask;
+  GGint local_z = voxel_z & mask;
+  GGint local_id = 0;
+  if (label_layout == MORTON_LABEL_LAYOUT) {
+    // Interleaving the 3 bits of each local index
+    local_id =
+      ((local_x & 1) | ((local_x & 2) << 2) | ((local_x & 4) << 4)) |
+      (((local_y & 1) | ((local_y & 2) << 2) | ((local_y & 4) << 4)) << 1) |
+      (((local_z & 1) | ((local_z & 2) << 2) | ((local_z & 4) << 4)) << 2);
+  }
+  else {
+    local_id = local_x + (local_y << shift) + (local_z << (2 * shift));
+  }
+
+  return (brick_id << (3 * shift)) + local_id;
+}
+
+#ifndef __OPENCL_C_VERSION__
+/*!
+  \fn inline GGsize GetLabelDataSize(GGint const& label_layout, GGint3 const& number_of_voxels)
+  \param label_layout - layout of label data
+  \param number_of_voxels - number of voxels in X, Y and Z
+  \return number of labels stored, voxels of incomplete bricks included
+  \brief Get the number of labels to allocate for a layout
+*/
+inline GGsize GetLabelDataSize(GGint const& label_layout, GGint3 const& number_of_voxels)
+{
+  GGint shift = LabelBrickShift(label_layout);
+  GGint mask = (1 << shift) - 1;
+
+  GGsize size = 1;
+  for (GGint i = 0; i < 3; ++i) size *= static_cast<GGsize>(((number_of_voxels.s[i] + mask) >> shift) << shift);
+
+  return size;
+}
+#endif
+
 #endif // GUARD_GGEMS_GEOMETRIES_GGEMSVOXELIZEDSOLIDSTACK_HH
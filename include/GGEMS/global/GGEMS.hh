@@ -193,6 +193,33 @@ class GGEMS_EXPORT GGEMS
     */
     inline GGint GetParticleTrackingID(void) const {return particle_tracking_id_;}
 
+    /*!
+      \fn void SetAliveCheckPeriod(GGsize const& alive_check_period)
+      \param alive_check_period - number of navigation iterations between two checks of alive particles
+      \brief set the period checking if particles are alive, particles dead before the check are not tracked anymore
+    */
+    void SetAliveCheckPeriod(GGsize const& alive_check_period);
+
+    /*!
+      \fn void SetAsyncOutput(bool const& is_async_output)
+      \param is_async_output - flag for asynchronous output
+      \brief if activated, Run returns while output files are written in background
+    */
+    void SetAsyncOutput(bool const& is_async_output);
+
+    /*!
+      \fn void WaitOutput(void)
+      \brief wait until all output files are written
+    */
+    void WaitOutput(void);
+
+    /*!
+      \fn void BenchmarkFindSolid(GGsize const& number_of_rays) const
+      \param number_of_rays - number of rays searching their closest module
+      \brief compare BVH and linear search of closest solid on rings of 1 to 512 CT modules, must be called after initialization
+    */
+    void BenchmarkFindSolid(GGsize const& number_of_rays) const;
+
   private:
     /*!
       \fn void PrintBanner(void) const
@@ -219,6 +246,8 @@ class GGEMS_EXPORT GGEMS
     bool is_tracking_verbose_; /*!< Flag for tracking verbosity */
     bool is_profiling_verbose_; /*!< Flag for kernel time verbosity */
     GGint particle_tracking_id_; /*!< Particle if for tracking */
+    GGsize alive_check_period_; /*!< Number of navigation iterations between two checks of alive particles */
+    bool is_async_output_; /*!< Flag for output files written in background after Run */
 };
 
 /*!
@@ -324,6 +353,29 @@ extern "C" GGEMS_EXPORT void set_profiling_ggems(GGEMS* ggems, bool const is_pro
 */
 extern "C" GGEMS_EXPORT void set_tracking_ggems(GGEMS* ggems, bool const is_tracking_verbose, GGint const particle_id_tracking);
 
+/*!
+  \fn void set_alive_check_period_ggems(GGEMS* ggems, GGsize const alive_check_period)
+  \param ggems - pointer to GGEMS
+  \param alive_check_period - number of navigation iterations between two checks of alive particles
+  \brief Set the period checking alive particles
+*/
+extern "C" GGEMS_EXPORT void set_alive_check_period_ggems(GGEMS* ggems, GGsize const alive_check_period);
+
+/*!
+  \fn void set_async_output_ggems(GGEMS* ggems, bool const is_async_output)
+  \param ggems - pointer to GGEMS
+  \param is_async_output - flag for asynchronous output
+  \brief Set the output files written in background after run
+*/
+extern "C" GGEMS_EXPORT void set_async_output_ggems(GGEMS* ggems, bool const is_async_output);
+
+/*!
+  \fn void wait_output_ggems(GGEMS* ggems)
+  \param ggems - pointer to GGEMS
+  \brief Wait until all output files are written
+*/
+extern "C" GGEMS_EXPORT void wait_output_ggems(GGEMS* ggems);
+
 /*!
   \fn void run_ggems(GGEMS* ggems)
   \param ggems - pointer to GGEMS
@@ -331,4 +383,12 @@ extern "C" GGEMS_EXPORT void set_tracking_ggems(GGEMS* ggems, bool const is_trac
 */
 extern "C" GGEMS_EXPORT void run_ggems(GGEMS* ggems);
 
+/*!
+  \fn void benchmark_find_solid_ggems(GGEMS* ggems, GGsize const number_of_rays)
+  \param ggems - pointer to GGEMS
+  \param number_of_rays - number of rays searching their closest module
+  \brief Compare BVH and linear search of closest solid on rings of CT modules
+*/
+extern "C" GGEMS_EXPORT void benchmark_find_solid_ggems(GGEMS* ggems, GGsize const number_of_rays);
+
 #endif // End of GUARD_GGEMS_GLOBAL_GGEMS_HH
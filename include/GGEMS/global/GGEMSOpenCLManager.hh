@@ -55,6 +55,7 @@ typedef struct ComputingDevice_t
   GGsize index_; /*!< Index of computing device */
   cl::Context* context_; /*!< Context associated to computing device */
   cl::CommandQueue* queue_; /*!< Queue associated to computing device */
+  cl::CommandQueue* generation_queue_; /*!< Queue generating primary particles, overlapping transport on queue_ */
 
   /*!
     \fn void Clean(void)
@@ -71,6 +72,11 @@ typedef struct ComputingDevice_t
       delete queue_;
       queue_ = nullptr;
     }
+
+    if (generation_queue_) {
+      delete generation_queue_;
+      generation_queue_ = nullptr;
+    }
   }
 } ComputingDevice; /*!< Using C convention name of struct to C++ (_t deletion) */
 
@@ -232,6 +238,14 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     GGsize GetBestWorkItem(GGsize const& number_of_elements) const;
 
+    /*!
+      \fn bool IsLocalMemoryFitting(GGsize const& size) const
+      \param size - size in bytes of local buffers used by a work-group
+      \return true if local buffers fit in dedicated local memory of all activated devices
+      \brief check if local buffers of a kernel fit in local memory, devices emulating local memory in global memory are not fitting
+    */
+    bool IsLocalMemoryFitting(GGsize const& size) const;
+
     /*!
       \fn inline GGsize GetIndexOfActivatedDevice(GGsize const& thread_index) const
       \param thread_index - index of the thread (= activated device index)
@@ -256,6 +270,14 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     inline cl::CommandQueue* GetCommandQueue(GGsize const& thread_index) const {return computing_devices_[thread_index].queue_;}
 
+    /*!
+      \fn cl::CommandQueue* GetGenerationCommandQueue(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return the pointer on command queue generating primary particles
+      \brief Return the command queue generating primary particles, running in same time as transport command queue
+    */
+    inline cl::CommandQueue* GetGenerationCommandQueue(GGsize const& thread_index) const {return computing_devices_[thread_index].generation_queue_;}
+
     /*!
       \fn void DeviceToActivate(GGsize const& device_id)
       \param device_id - device index
@@ -274,7 +296,7 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     /*!
       \fn void DeviceBalancing(std::string const& device_balancing)
       \param device_balancing - device balancing
-      \brief change the device balancing, by default device balancing is the same for each device
+      \brief change the device balancing, by default device balancing is the same for each device. Balancing is the share of each device for first batchs, then the share follows the measured throughput
     */
     void DeviceBalancing(std::string const& device_balancing);
 
@@ -293,6 +315,59 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     inline GGsize GetNumberDeviceBalancing(void) const {return device_balancing_.size();}
 
+    /*!
+      \fn void SetParticleStackSize(GGsize const& particle_stack_size)
+      \param particle_stack_size - number of particles in particle buffers, 0 for automatic size
+      \brief set the number of particles in particle buffers on each device, rounded to work group size. Must be set before GGEMS initialization
+    */
+    void SetParticleStackSize(GGsize const& particle_stack_size);
+
+    /*!
+      \fn GGsize GetParticleStackSize(GGsize const& thread_index)
+      \param thread_index - index of the thread (= activated device index)
+      \return number of particles in particle buffers of the device
+      \brief get the number of particles in particle buffers, computed at first call from device limits if not set by user
+    */
+    GGsize GetParticleStackSize(GGsize const& thread_index);
+
+    /*!
+      \fn void SetBlockingStages(bool const& is_blocking_stages)
+      \param is_blocking_stages - flag waiting on host for the end of each transport stage
+      \brief wait on host after each transport stage instead of waiting only once per batch on the event chain, used to benchmark the event chain
+    */
+    void SetBlockingStages(bool const& is_blocking_stages);
+
+    /*!
+      \fn inline bool IsBlockingStages(void) const
+      \return true if host waits after each transport stage
+      \brief check if host waits after each transport stage
+    */
+    inline bool IsBlockingStages(void) const {return is_blocking_stages_;}
+
+    /*!
+      \fn std::vector<cl::Event> const* GetTransportWaitList(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return events the next transport stage has to wait for, nullptr if none
+      \brief give the wait list of the next command of the transport event chain
+    */
+    std::vector<cl::Event> const* GetTransportWaitList(GGsize const& thread_index) const;
+
+    /*!
+      \fn void ChainTransportEvent(GGsize const& thread_index, cl::Event const& event)
+      \param thread_index - index of the thread (= activated device index)
+      \param event - event of the last enqueued transport command
+      \brief append a command to the transport event chain, the next transport stage waits for it. In blocking mode host waits for the command
+    */
+    void ChainTransportEvent(GGsize const& thread_index, cl::Event const& event);
+
+    /*!
+      \fn void AddTransportDependency(GGsize const& thread_index, cl::Event const& event)
+      \param thread_index - index of the thread (= activated device index)
+      \param event - event enqueued on another command queue
+      \brief add an event from another command queue (generation queue) to the wait list of the next transport stage
+    */
+    void AddTransportDependency(GGsize const& thread_index, cl::Event const& event);
+
     /*!
       \fn inline bool IsReady(void) const
       \return true is OpenCL manager is ready to use, it means a device is activated
@@ -317,6 +392,46 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     void CompileKernel(std::string const& kernel_filename, std::string const& kernel_name, cl::Kernel** kernel_list, char* const custom_options = nullptr, char* const additional_options = nullptr);
 
+    /*!
+      \fn void SetKernelBinaryCache(bool const& is_kernel_binary_cache)
+      \param is_kernel_binary_cache - flag activating the on-disk cache of OpenCL program binaries
+      \brief activate or deactivate the on-disk cache of compiled OpenCL programs
+    */
+    void SetKernelBinaryCache(bool const& is_kernel_binary_cache);
+
+    /*!
+      \fn void SetKernelBinaryCachePath(std::string const& kernel_binary_cache_path)
+      \param kernel_binary_cache_path - directory storing the OpenCL program binaries
+      \brief set the directory of the OpenCL program binary cache
+    */
+    void SetKernelBinaryCachePath(std::string const& kernel_binary_cache_path);
+
+    /*!
+      \fn void InvalidateKernelBinaryCache(void)
+      \brief remove all the OpenCL program binaries stored on disk and reset the cache statistics
+    */
+    void InvalidateKernelBinaryCache(void);
+
+    /*!
+      \fn void PrintKernelBinaryCacheStatistics(void) const
+      \brief print hit/miss statistics of the OpenCL program binary cache
+    */
+    void PrintKernelBinaryCacheStatistics(void) const;
+
+    /*!
+      \fn inline GGsize GetKernelBinaryCacheHits(void) const
+      \return number of OpenCL programs loaded from the binary cache
+      \brief get the number of hits in the OpenCL program binary cache
+    */
+    inline GGsize GetKernelBinaryCacheHits(void) const {return kernel_binary_cache_hits_;}
+
+    /*!
+      \fn inline GGsize GetKernelBinaryCacheMisses(void) const
+      \return number of OpenCL programs compiled from source
+      \brief get the number of misses in the OpenCL program binary cache
+    */
+    inline GGsize GetKernelBinaryCacheMisses(void) const {return kernel_binary_cache_misses_;}
+
     /*!
       \return the pointer on host memory on write/read mode
       \brief Get the device pointer on host to write on it. ReleaseDeviceBuffer must be used after this method!!!
@@ -404,6 +519,13 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     void DisableCudaKernelCache(void) const;
 
+    /*!
+      \fn void ComputeParticleStackSize(GGsize const& thread_index)
+      \param thread_index - index of the thread (= activated device index)
+      \brief compute the number of particles in particle buffers from max buffer allocation size and available RAM on device
+    */
+    void ComputeParticleStackSize(GGsize const& thread_index);
+
     /*!
       \fn void SetOpenCLCompilationOptions(void)
       \brief Setting compilation options for OpenCL kernel
@@ -419,13 +541,13 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     std::string ErrorType(GGint const& error) const;
 
     /*!
-      \fn std::GGsize CheckKernel(std::string const& kernel_name, std::string const& compilation_options) const
+      \fn std::GGsize CheckKernel(std::string const& kernel_name, std::vector<std::string> const& compilation_options) const
       \param kernel_name - name of the kernel
-      \param compilation_options - arguments of compilation
-      \brief check if a kernel has been already compiled
+      \param compilation_options - arguments of compilation for each activated device, with particle stack size
+      \brief check if a kernel has been already compiled with same options on all devices
       \return index of kernel if already compiled
     */
-    GGsize CheckKernel(std::string const& kernel_name, std::string const& compilation_options) const;
+    GGsize CheckKernel(std::string const& kernel_name, std::vector<std::string> const& compilation_options) const;
 
     /*!
       \fn bool IsDoublePrecision(GGsize const& device_index) const
@@ -435,6 +557,45 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     bool IsDoublePrecision(GGsize const& device_index) const;
 
+    /*!
+      \fn void ReadKernelSourceWithIncludes(std::string const& filename, std::string& source_code, std::vector<std::string>& visited_files) const
+      \param filename - name of the kernel or header file
+      \param source_code - concatenation of the file and its transitive includes
+      \param visited_files - files already read, avoiding include loops
+      \brief read a kernel file and all the GGEMS headers it includes, used to build the key of the binary cache
+    */
+    void ReadKernelSourceWithIncludes(std::string const& filename, std::string& source_code, std::vector<std::string>& visited_files) const;
+
+    /*!
+      \fn std::string GetKernelBinaryCacheFilename(std::string const& kernel_filename, std::string const& source_code, std::string const& compilation_options, GGsize const& thread_index) const
+      \param kernel_filename - filename where is declared the kernel
+      \param source_code - kernel source with its transitive includes
+      \param compilation_options - arguments of compilation
+      \param thread_index - index of activated device
+      \return the filename of the program binary in cache
+      \brief compute the content-addressed filename of a program binary (source, includes, options, device name and driver)
+    */
+    std::string GetKernelBinaryCacheFilename(std::string const& kernel_filename, std::string const& source_code, std::string const& compilation_options, GGsize const& thread_index) const;
+
+    /*!
+      \fn bool LoadKernelBinary(std::string const& cache_filename, std::string const& compilation_options, GGsize const& thread_index, cl::Program& program) const
+      \param cache_filename - filename of the program binary in cache
+      \param compilation_options - arguments of compilation
+      \param thread_index - index of activated device
+      \param program - OpenCL program built from binary
+      \return true if the program has been built from the cached binary
+      \brief load and build an OpenCL program from a binary stored on disk
+    */
+    bool LoadKernelBinary(std::string const& cache_filename, std::string const& compilation_options, GGsize const& thread_index, cl::Program& program) const;
+
+    /*!
+      \fn void StoreKernelBinary(std::string const& cache_filename, cl::Program& program) const
+      \param cache_filename - filename of the program binary in cache
+      \param program - OpenCL program built from source
+      \brief store the binary of a built OpenCL program on disk
+    */
+    void StoreKernelBinary(std::string const& cache_filename, cl::Program& program) const;
+
     /*!
       \fn void HandleEvent(cl::Event& event, char* message)
       \param event - OpenCL event
@@ -526,6 +687,10 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     std::vector<GGuint> device_partition_max_sub_devices_; /*!< Partition affinity domain */
     std::vector<GGsize> device_profiling_timer_resolution_; /*!< Timer resolution */
     std::vector<GGfloat> device_balancing_; /*!< Device balancing */
+    std::vector<GGsize> particle_stack_size_; /*!< Number of particles in particle buffers for each activated device, 0 if not computed */
+    GGsize user_particle_stack_size_; /*!< Number of particles in particle buffers set by user, 0 for automatic size */
+    std::vector<std::vector<cl::Event>> transport_wait_lists_; /*!< Events of the transport event chain the next stage waits for, for each activated device */
+    bool is_blocking_stages_; /*!< Flag waiting on host after each transport stage */
 
     // Custom OpenCL members
     GGsize work_group_size_; /*!< Work group size by GGEMS, here 64 */
@@ -539,7 +704,13 @@ class GGEMS_EXPORT GGEMSOpenCLManager
 
     // OpenCL kernels
     std::vector<cl::Kernel*> kernels_; /*!< List of kernels for each device */
-    std::vector<std::string> kernel_compilation_options_; /*!< List of compilation options for kernel */
+    std::vector<std::string> kernel_compilation_options_; /*!< List of compilation options for kernel, with particle stack size of the device */
+
+    // OpenCL program binary cache
+    bool is_kernel_binary_cache_; /*!< Flag activating the on-disk program binary cache */
+    std::string kernel_binary_cache_path_; /*!< Directory storing program binaries */
+    GGsize kernel_binary_cache_hits_; /*!< Number of programs loaded from cache */
+    GGsize kernel_binary_cache_misses_; /*!< Number of programs compiled from source */
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -631,4 +802,50 @@ extern "C" GGEMS_EXPORT void clean_opencl_manager(GGEMSOpenCLManager* opencl_man
 */
 extern "C" GGEMS_EXPORT void set_device_balancing_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* device_balancing);
 
+/*!
+  \fn void set_particle_stack_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, GGsize const particle_stack_size)
+  \param opencl_manager - pointer on the singleton
+  \param particle_stack_size - number of particles in particle buffers, 0 for automatic size
+  \brief set the number of particles in particle buffers on each device
+*/
+extern "C" GGEMS_EXPORT void set_particle_stack_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, GGsize const particle_stack_size);
+
+/*!
+  \fn void set_blocking_stages_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_blocking_stages)
+  \param opencl_manager - pointer on the singleton
+  \param is_blocking_stages - flag waiting on host after each transport stage
+  \brief wait on host after each transport stage instead of chaining stages with events
+*/
+extern "C" GGEMS_EXPORT void set_blocking_stages_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_blocking_stages);
+
+/*!
+  \fn void set_kernel_binary_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_kernel_binary_cache)
+  \param opencl_manager - pointer on the singleton
+  \param is_kernel_binary_cache - flag activating the program binary cache
+  \brief activate or deactivate the on-disk cache of OpenCL program binaries
+*/
+extern "C" GGEMS_EXPORT void set_kernel_binary_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_kernel_binary_cache);
+
+/*!
+  \fn void set_kernel_binary_cache_path_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* kernel_binary_cache_path)
+  \param opencl_manager - pointer on the singleton
+  \param kernel_binary_cache_path - directory storing the program binaries
+  \brief set the directory of the OpenCL program binary cache
+*/
+extern "C" GGEMS_EXPORT void set_kernel_binary_cache_path_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* kernel_binary_cache_path);
+
+/*!
+  \fn void invalidate_kernel_binary_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager)
+  \param opencl_manager - pointer on the singleton
+  \brief remove all the OpenCL program binaries stored on disk
+*/
+extern "C" GGEMS_EXPORT void invalidate_kernel_binary_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager);
+
+/*!
+  \fn void print_kernel_binary_cache_statistics_opencl_manager(GGEMSOpenCLManager* opencl_manager)
+  \param opencl_manager - pointer on the singleton
+  \brief print hit/miss statistics of the OpenCL program binary cache
+*/
+extern "C" GGEMS_EXPORT void print_kernel_binary_cache_statistics_opencl_manager(GGEMSOpenCLManager* opencl_manager);
+
 #endif // GUARD_GGEMS_GLOBAL_GGEMSOPENCLMANAGER_HH
@@ -145,13 +145,13 @@ class GGEMS_EXPORT GGEMSOpenGLVolume
     void SetColorName(std::string const& color);
 
     /*!
-      \fn void SetMaterial(GGEMSMaterials const* materials, cl::Buffer* label, GGsize const& number_of_voxels)
+      \fn void SetMaterial(GGEMSMaterials const* materials, GGuchar const* label, GGsize const& number_of_voxels)
       \param materials - list of materials selected during simulation
-      \param label - label data corresponding to material
+      \param label - label data corresponding to material, X fastest then Y then Z
       \param number_of_voxels - number of voxels
       \brief Set material list and labels, to find color associated to material
     */
-    void SetMaterial(GGEMSMaterials const* materials, cl::Buffer* label, GGsize const& number_of_voxels);
+    void SetMaterial(GGEMSMaterials const* materials, GGuchar const* label, GGsize const& number_of_voxels);
 
     /*!
       \fn void SetMaterial(std::string const& material_name)
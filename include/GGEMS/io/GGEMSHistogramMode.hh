@@ -31,10 +31,12 @@
   \date Thursday December 3, 2020
 */
 
-#include <memory>
-
 #include "GGEMS/tools/GGEMSTypes.hh"
 
+#ifndef __OPENCL_C_VERSION__
+
+#include <memory>
+
 /*!
   \struct GGEMSHistogramMode_t
   \brief Structure storing histogram infos
@@ -44,6 +46,57 @@ typedef struct GGEMSHistogramMode_t
   cl::Buffer** histogram_; /*!< Buffer storing histogram counting */
   cl::Buffer** scatter_; /*!< Buffer storing scattered photon */
   GGsize number_of_elements_; /*!< Number of elements in hit buffer */
+  bool is_local_; /*!< Hits counted in a local copy of histogram by work-group, added to hit buffer at the end of work-group */
 } GGEMSHistogramMode; /*!< Using C convention name of struct to C++ (_t deletion) */
 
+#endif
+
+#ifdef __OPENCL_C_VERSION__
+
+/*!
+  \def HISTOGRAM_MEMORY
+  \brief Address space of histograms filled by tracking, a local copy by work-group with LOCAL_HISTOGRAM, global histogram otherwise
+*/
+#ifdef LOCAL_HISTOGRAM
+#define HISTOGRAM_MEMORY local
+#else
+#define HISTOGRAM_MEMORY global
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void ClearLocalHistogram(local GGint* local_histogram, GGsize const number_of_elements)
+  \param local_histogram - copy of histogram for the work-group
+  \param number_of_elements - number of elements in histogram
+  \brief Set the local copy of histogram to 0, shared by work-items of the work-group
+*/
+inline void ClearLocalHistogram(local GGint* local_histogram, GGsize const number_of_elements)
+{
+  for (GGsize i = get_local_id(0); i < number_of_elements; i += get_local_size(0)) local_histogram[i] = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void FlushLocalHistogram(local GGint const* local_histogram, global GGint* histogram, GGsize const number_of_elements)
+  \param local_histogram - copy of histogram for the work-group
+  \param histogram - histogram in global memory
+  \param number_of_elements - number of elements in histogram
+  \brief Add the local copy of histogram to global histogram, one atomic by non empty element
+*/
+inline void FlushLocalHistogram(local GGint const* local_histogram, global GGint* histogram, GGsize const number_of_elements)
+{
+  for (GGsize i = get_local_id(0); i < number_of_elements; i += get_local_size(0)) {
+    GGint count = local_histogram[i];
+    if (count) atomic_add(&histogram[i], count);
+  }
+}
+
+#endif
+
 #endif // End of GUARD_GGEMS_IO_GGEMSHISTOGRAMMODE_HH
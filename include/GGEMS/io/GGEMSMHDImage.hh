@@ -36,8 +36,10 @@
 #endif
 
 #include <fstream>
+#include <memory>
 
 #include "GGEMS/global/GGEMSOpenCLManager.hh"
+#include "GGEMS/io/GGEMSMHDWriterManager.hh"
 
 /*!
   \class GGEMSMHDImage
@@ -118,6 +120,15 @@ class GGEMS_EXPORT GGEMSMHDImage
     template<typename T>
     void Write(T* image);
 
+    /*!
+      \fn template <typename T> void WriteAsync(T* image)
+      \tparam T - type of the data
+      \param image - image allocated with new[], owned and deleted by writer
+      \brief write the mhd header/raw file in background thread, GGEMSMHDWriterManager::Wait waits for the file
+    */
+    template<typename T>
+    void WriteAsync(T* image);
+
     /*!
       \fn void SetElementSizes(GGfloat3 const& element_sizes)
       \param element_sizes - size of elements in X, Y, Z
@@ -153,6 +164,45 @@ class GGEMS_EXPORT GGEMSMHDImage
     */
     inline std::string GetRawMDHfilename(void) const {return mhd_raw_file_;}
 
+    /*!
+      \fn template <typename T> T const* GetRawData(void)
+      \tparam T - type of the data
+      \return pointer on raw data mapped in memory, in byte order of raw file
+      \brief map the raw file of the mhd header read before, data are read from page cache without copy. If IsByteSwapped, elements are swapped by the reader (SwapBytes)
+    */
+    template <typename T>
+    T const* GetRawData(void);
+
+    /*!
+      \fn inline bool IsByteSwapped(void) const
+      \return true if byte order of raw file (BinaryDataByteOrderMSB) is not the order of host
+      \brief check if elements of raw data have to be swapped
+    */
+    inline bool IsByteSwapped(void) const {return is_msb_ != IsHostMSB();}
+
+    /*!
+      \fn template <typename T> static inline T SwapBytes(T const& value)
+      \tparam T - type of the data
+      \param value - element of raw data
+      \return element with bytes in reverse order
+      \brief swap bytes of an element read from raw data
+    */
+    template <typename T>
+    static inline T SwapBytes(T const& value)
+    {
+      T swapped;
+      GGuchar const* bytes = reinterpret_cast<GGuchar const*>(&value);
+      GGuchar* swapped_bytes = reinterpret_cast<GGuchar*>(&swapped);
+      for (GGsize i = 0; i < sizeof(T); ++i) swapped_bytes[i] = bytes[sizeof(T) - 1 - i];
+      return swapped;
+    }
+
+    /*!
+      \fn void UnmapRawData(void)
+      \brief unmap the raw file, done by destructor if needed
+    */
+    void UnmapRawData(void);
+
     /*!
       \fn std::string GetOutputDirectory(void) const
       \brief get the output directory
@@ -177,6 +227,31 @@ class GGEMS_EXPORT GGEMSMHDImage
     template <typename T>
     void WriteRaw(cl::Buffer* image, GGsize const& thread_index) const;
 
+    /*!
+      \fn std::string GetHeader(void) const
+      \return content of mhd header file
+      \brief build the content of mhd header file
+    */
+    std::string GetHeader(void) const;
+
+    /*!
+      \fn void MapRawData(GGsize const& size)
+      \param size - size of raw data in bytes
+      \brief map the raw file in memory with read-only pages, and advise sequential reading
+    */
+    void MapRawData(GGsize const& size);
+
+    /*!
+      \fn static inline bool IsHostMSB(void)
+      \return true if most significant byte is first on host
+      \brief check the byte order of host
+    */
+    static inline bool IsHostMSB(void)
+    {
+      GGuint const kOne = 1;
+      return *reinterpret_cast<GGuchar const*>(&kOne) == 0;
+    }
+
   private:
     std::string mhd_header_file_; /*!< Name of the MHD header file */
     std::string mhd_raw_file_; /*!< Name of the MHD raw file */
@@ -184,6 +259,11 @@ class GGEMS_EXPORT GGEMSMHDImage
     std::string mhd_data_type_; /*!< Type of data */
     GGfloat3 element_sizes_; /*!< Size of elements */
     GGsize3 dimensions_; /*!< Dimension volume X, Y, Z */
+    bool is_msb_; /*!< Most significant byte first in raw file */
+    void* raw_data_; /*!< Raw file mapped in memory */
+    GGsize raw_data_size_; /*!< Size of mapped raw data in bytes */
+    void* raw_file_handle_; /*!< Handle of raw file, only on Windows */
+    void* raw_mapping_handle_; /*!< Handle of raw file mapping, only on Windows */
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -200,13 +280,7 @@ void GGEMSMHDImage::Write(T* image)
 
   // header data
   std::ofstream out_header_stream(mhd_header_file_, std::ios::out);
-  out_header_stream << "ObjectType = Image" << std::endl;
-  out_header_stream << "BinaryDataByteOrderMSB = False" << std::endl;
-  out_header_stream << "NDims = 3" << std::endl;
-  out_header_stream << "ElementSpacing = " << element_sizes_.s[0] << " " << element_sizes_.s[1] << " " << element_sizes_.s[2] << std::endl;
-  out_header_stream << "DimSize = " << dimensions_.x_ << " " << dimensions_.y_ << " " << dimensions_.z_ << std::endl;
-  out_header_stream << "ElementType = " << mhd_data_type_ << std::endl;
-  out_header_stream << "ElementDataFile = " << mhd_raw_file_ << std::endl;
+  out_header_stream << GetHeader();
   out_header_stream.close();
 
   // raw data
@@ -222,6 +296,47 @@ void GGEMSMHDImage::Write(T* image)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+template <typename T>
+void GGEMSMHDImage::WriteAsync(T* image)
+{
+  // Owning image first, it is deleted even if parameters are wrong
+  std::shared_ptr<void> data(image, [](void* image_data) {delete[] static_cast<T*>(image_data);});
+
+  // Checking parameters before to write
+  CheckParameters();
+
+  GGEMSMHDWriteJob job;
+  job.header_filename_ = mhd_header_file_;
+  job.header_ = GetHeader();
+  job.raw_filename_ = output_dir_ + mhd_raw_file_;
+  job.data_ = data;
+  job.size_ = dimensions_.x_ * dimensions_.y_ * dimensions_.z_ * sizeof(T);
+
+  GGEMSMHDWriterManager::GetInstance().Push(job);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+T const* GGEMSMHDImage::GetRawData(void)
+{
+  GGsize number_of_elements = dimensions_.x_ * dimensions_.y_ * dimensions_.z_;
+  MapRawData(number_of_elements * sizeof(T));
+
+  // Mapping is never written, bytes of elements are swapped by reader if needed
+  if (sizeof(T) > 1 && IsByteSwapped()) {
+    GGcout("GGEMSMHDImage", "GetRawData", 2) << "Byte order of raw data is not the order of host, elements are swapped while reading..." << GGendl;
+  }
+
+  return static_cast<T const*>(raw_data_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 void GGEMSMHDImage::WriteRaw(cl::Buffer* image, GGsize const& thread_index) const
 {
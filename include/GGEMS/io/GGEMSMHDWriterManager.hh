@@ -0,0 +1,157 @@
+#ifndef GUARD_GGEMS_IO_GGEMSMHDWRITERMANAGER_HH
+#define GUARD_GGEMS_IO_GGEMSMHDWRITERMANAGER_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSMHDWriterManager.hh
+
+  \brief GGEMS singleton writing MHD files in a background thread, host data of an image are written while the next image is read back from OpenCL devices
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4251) // Deleting warning exporting STL members!!!
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "GGEMS/global/GGEMSExport.hh"
+#include "GGEMS/tools/GGEMSTypes.hh"
+
+/*!
+  \struct GGEMSMHDWriteJob_t
+  \brief MHD file waiting to be written
+*/
+typedef struct GGEMSMHDWriteJob_t
+{
+  std::string header_filename_; /*!< Name of the MHD header file */
+  std::string header_; /*!< Content of the MHD header file */
+  std::string raw_filename_; /*!< Name of the MHD raw file */
+  std::shared_ptr<void> data_; /*!< Raw data on host, freed once written */
+  GGsize size_; /*!< Size of raw data in bytes */
+} GGEMSMHDWriteJob; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+/*!
+  \class GGEMSMHDWriterManager
+  \brief GGEMS singleton writing MHD files in a background thread, host data of an image are written while the next image is read back from OpenCL devices
+*/
+class GGEMS_EXPORT GGEMSMHDWriterManager
+{
+  private:
+    /*!
+      \brief Unable the constructor for the user
+    */
+    GGEMSMHDWriterManager(void);
+
+    /*!
+      \brief Unable the destructor for the user, waiting for files not written yet
+    */
+    ~GGEMSMHDWriterManager(void);
+
+  public:
+    /*!
+      \fn static GGEMSMHDWriterManager& GetInstance(void)
+      \brief Create at first time the Singleton
+      \return Object of type GGEMSMHDWriterManager
+    */
+    static GGEMSMHDWriterManager& GetInstance(void)
+    {
+      static GGEMSMHDWriterManager instance;
+      return instance;
+    }
+
+    /*!
+      \fn GGEMSMHDWriterManager(GGEMSMHDWriterManager const& mhd_writer_manager) = delete
+      \param mhd_writer_manager - reference on the mhd writer manager
+      \brief Avoid copy of the class by reference
+    */
+    GGEMSMHDWriterManager(GGEMSMHDWriterManager const& mhd_writer_manager) = delete;
+
+    /*!
+      \fn GGEMSMHDWriterManager& operator=(GGEMSMHDWriterManager const& mhd_writer_manager) = delete
+      \param mhd_writer_manager - reference on the mhd writer manager
+      \brief Avoid assignement of the class by reference
+    */
+    GGEMSMHDWriterManager& operator=(GGEMSMHDWriterManager const& mhd_writer_manager) = delete;
+
+    /*!
+      \fn GGEMSMHDWriterManager(GGEMSMHDWriterManager const&& mhd_writer_manager) = delete
+      \param mhd_writer_manager - rvalue reference on the mhd writer manager
+      \brief Avoid copy of the class by rvalue reference
+    */
+    GGEMSMHDWriterManager(GGEMSMHDWriterManager const&& mhd_writer_manager) = delete;
+
+    /*!
+      \fn GGEMSMHDWriterManager& operator=(GGEMSMHDWriterManager const&& mhd_writer_manager) = delete
+      \param mhd_writer_manager - rvalue reference on the mhd writer manager
+      \brief Avoid copy of the class by rvalue reference
+    */
+    GGEMSMHDWriterManager& operator=(GGEMSMHDWriterManager const&& mhd_writer_manager) = delete;
+
+    /*!
+      \fn void Push(GGEMSMHDWriteJob const& job)
+      \param job - MHD file to write
+      \brief add a file to write, the background thread is started at first file
+    */
+    void Push(GGEMSMHDWriteJob const& job);
+
+    /*!
+      \fn void Wait(void)
+      \brief wait until all files are written, an exception is thrown if a file could not be written
+    */
+    void Wait(void);
+
+  private:
+    /*!
+      \fn void WriteFiles(void)
+      \brief loop of background thread writing files
+    */
+    void WriteFiles(void);
+
+    /*!
+      \fn std::string WriteFile(GGEMSMHDWriteJob const& job) const
+      \param job - MHD file to write
+      \return empty string if file is written, error message otherwise
+      \brief write header and raw data of a file, raw data are written by large blocks
+    */
+    std::string WriteFile(GGEMSMHDWriteJob const& job) const;
+
+  private:
+    std::deque<GGEMSMHDWriteJob> jobs_; /*!< Files waiting to be written */
+    std::thread writer_thread_; /*!< Background thread writing files */
+    std::mutex mutex_; /*!< Mutex protecting jobs and states */
+    std::condition_variable job_condition_; /*!< Notify background thread of a new file or of the end */
+    std::condition_variable done_condition_; /*!< Notify waiting threads of a written file */
+    bool is_writing_; /*!< A file is being written */
+    bool is_stopped_; /*!< Background thread has to stop */
+    std::string error_; /*!< Errors of files not written */
+};
+
+#endif // End of GUARD_GGEMS_IO_GGEMSMHDWRITERMANAGER_HH
@@ -73,6 +73,40 @@ inline GGint BinarySearchLeft(GGfloat const key, GGfloat const* array, GGint con
   return min;
 }
 
+/*!
+  \fn inline GGint LogUniformBinIndex(GGfloat const key, GGfloat const* array, GGint const size, GGfloat const log_min, GGfloat const inverse_log_step)
+  \param key - value in array to find
+  \param array - log-uniform array where is the key value, array[i] = exp(log_min + i/inverse_log_step)
+  \param size - size of array, number of elements
+  \param log_min - log of the first element of array
+  \param inverse_log_step - inverse of the log step between two elements
+  \return index of key value in array, same result as BinarySearchLeft
+  \brief Find the index of the key value in a log-uniform array in constant time, only for log-uniform arrays (use BinarySearchLeft for the other ones)
+*/
+#ifdef __OPENCL_C_VERSION__
+inline GGint LogUniformBinIndex(GGfloat const key, global GGfloat const* array, GGint const size, GGfloat const log_min, GGfloat const inverse_log_step)
+#else
+inline GGint LogUniformBinIndex(GGfloat const key, GGfloat const* array, GGint const size, GGfloat const log_min, GGfloat const inverse_log_step)
+#endif
+{
+  // Position in grid clamped in [0, size-2] before conversion
+  #ifdef __OPENCL_C_VERSION__
+  GGfloat position = (log(key) - log_min) * inverse_log_step;
+  #else
+  GGfloat position = (std::log(key) - log_min) * inverse_log_step;
+  #endif
+  if (!(position > 0.0f)) position = 0.0f;
+  if (position > (GGfloat)(size - 2)) position = (GGfloat)(size - 2);
+
+  GGint index = (GGint)position;
+
+  // Rounding of log near a node is corrected using stored nodes
+  if (index > 0 && key < array[index]) --index;
+  else if (index < size - 2 && key >= array[index + 1]) ++index;
+
+  return index;
+}
+
 /*!
   \fn inline GGfloat LinearInterpolation(GGfloat xa, GGfloat ya, GGfloat xb, GGfloat yb, GGfloat x)
   \param xa - Coordinate x of point A
@@ -240,6 +240,14 @@ extern "C" GGEMS_EXPORT void set_save_ggems_ct_system(GGEMSCTSystem* ct_system,
 */
 extern "C" GGEMS_EXPORT void store_scatter_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_scatter);
 
+/*!
+  \fn void set_multi_solid_navigation_ggems_ct_system(GGEMSCTSystem* ct_system, bool const flag)
+  \param ct_system - pointer on ct system
+  \param flag - flag activating multi-solid navigation
+  \brief Navigate all the modules of ct system with a single kernel launch
+*/
+extern "C" GGEMS_EXPORT void set_multi_solid_navigation_ggems_ct_system(GGEMSCTSystem* ct_system, bool const flag);
+
 /*!
   \fn void set_visible_ggems_ct_system(GGEMSCTSystem* ct_system, bool const flag)
   \param ct_system - pointer on ct scanner
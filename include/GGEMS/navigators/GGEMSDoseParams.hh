@@ -46,6 +46,10 @@ typedef struct GGEMSDoseParams_t
   GGint3 number_of_dosels_; /*!< Number of dosels per dimension */
   GGint total_number_of_dosels_; /*!< Total number of dosels */
   GGint slice_number_of_dosels_; /*!< Number of dosels per slice */
+  GGint number_of_replicas_; /*!< Number of copies of edep, edep squared and hit maps, a work-item scores in copy global_id % number_of_replicas_ */
+  GGfloat edep_quantum_; /*!< Energy of a quantum with fixed-point scoring, edep squared is counted in edep_quantum_^2 */
+  GGfloat inverse_edep_quantum_; /*!< Inverse of energy of a quantum */
+  GGint fixed_point_overflow_; /*!< Set to 1 by fixed-point scoring if a sum of quanta overflowed */
 } GGEMSDoseParams; /*!< Using C convention name of struct to C++ (_t deletion) */
 
 #endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSDOSEPARAMS_HH
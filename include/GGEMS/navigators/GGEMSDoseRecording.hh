@@ -84,12 +84,16 @@ inline void dose_photon_tracking(global GGEMSDoseParams* dose_params, global GGi
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn void dose_record_standard(global GGEMSDoseParams* dose_params, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
+  \fn void dose_record_standard(global GGEMSDoseParams* dose_params, global GGEdepType* edep_tracking, global GGEdepType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
   \param dose_params - params associated to dosemap
-  \param
-  \brief Recording data for dosimetry
+  \param edep_tracking - buffer storing energy deposit
+  \param edep_squared_tracking - buffer storing energy deposit squared
+  \param hit_tracking - buffer storing hits
+  \param edep - energy deposit
+  \param position - position of deposit in local axis of dosemap
+  \brief Recording data for dosimetry, with replicated maps neighbour work-items do not score in the same copy, with DOSE_FIXED_POINT energy is summed as a number of quanta
 */
-inline void dose_record_standard(global GGEMSDoseParams* dose_params, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
+inline void dose_record_standard(global GGEMSDoseParams* dose_params, global GGEdepType* edep_tracking, global GGEdepType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
 {
   // Check position of photon inside dosemap limits
   if (position->x < dose_params->border_min_xyz_.x + EPSILON6 || position->x > dose_params->border_max_xyz_.x - EPSILON6) return;
@@ -105,8 +109,25 @@ inline void dose_record_standard(global GGEMSDoseParams* dose_params, global GGD
   if (dosel_id.y < 0 || dosel_id.y >= dose_params->number_of_dosels_.y) return;
   if (dosel_id.z < 0 || dosel_id.z >= dose_params->number_of_dosels_.z) return;
 
+  // Copy of dose maps used by this work-item, replicas are merged before computing dose
+  if (dose_params->number_of_replicas_ > 1) global_dosel_id += (GGint)(get_global_id(0) % dose_params->number_of_replicas_) * dose_params->total_number_of_dosels_;
+
   if (hit_tracking) atomic_add(&hit_tracking[global_dosel_id], 1);
-  #ifdef DOSIMETRY_DOUBLE_PRECISION
+  #ifdef DOSE_FIXED_POINT
+  // Deposit rounded to a number of quanta, clamped before conversion to integer, native 64 bits atomics and overflow detected from previous sum
+  GGfloat edep_scaled = edep * dose_params->inverse_edep_quantum_ + 0.5f;
+  GGulong edep_quanta = ULONG_MAX;
+  if (edep_scaled < (GGfloat)ULONG_MAX) edep_quanta = (GGulong)edep_scaled;
+  else dose_params->fixed_point_overflow_ = 1;
+  if (atom_add(&edep_tracking[global_dosel_id], edep_quanta) > ULONG_MAX - edep_quanta) dose_params->fixed_point_overflow_ = 1;
+  if (edep_squared_tracking) {
+    // Square of rounded deposit in integers (quantum^2 unit), exact up to 2^32 quanta by deposit
+    GGulong edep_squared_quanta = ULONG_MAX;
+    if (edep_quanta <= UINT_MAX) edep_squared_quanta = edep_quanta * edep_quanta;
+    else dose_params->fixed_point_overflow_ = 1;
+    if (atom_add(&edep_squared_tracking[global_dosel_id], edep_squared_quanta) > ULONG_MAX - edep_squared_quanta) dose_params->fixed_point_overflow_ = 1;
+  }
+  #elif defined(DOSIMETRY_DOUBLE_PRECISION)
   AtomicAddDouble(&edep_tracking[global_dosel_id], (GGDosiType)edep);
   if (edep_squared_tracking) AtomicAddDouble(&edep_squared_tracking[global_dosel_id], (GGDosiType)edep*(GGDosiType)edep);
   #else
@@ -179,6 +179,37 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     */
     void SetTLE(bool const& is_activated);
 
+    /*!
+      \fn void SetScoringBackend(std::string const& scoring_backend, GGsize const& number_of_replicas = 8)
+      \param scoring_backend - atomic (default) or replicated
+      \param number_of_replicas - number of copies of dose maps for replicated backend
+      \brief Select how energy deposits are scored: atomic adds in a single dose map, or in number_of_replicas copies of dose maps merged before computing dose (less contention on hot dosels, more memory)
+    */
+    void SetScoringBackend(std::string const& scoring_backend, GGsize const& number_of_replicas = 8);
+
+    /*!
+      \fn void SetFixedPointScoring(bool const& is_activated, GGfloat const& quantum = 1.0f, std::string const& unit = "eV")
+      \param is_activated - boolean activating fixed-point scoring
+      \param quantum - energy of a quantum
+      \param unit - unit of the energy
+      \brief Energy deposits are rounded to a number of quanta and summed with 64 bits integer atomics, sums do not depend on order of deposits
+    */
+    void SetFixedPointScoring(bool const& is_activated, GGfloat const& quantum = 1.0f, std::string const& unit = "eV");
+
+    /*!
+      \fn inline bool IsFixedPointScoring(void) const
+      \return true if energy deposits are summed as numbers of quanta
+      \brief check if fixed-point scoring is activated
+    */
+    inline bool IsFixedPointScoring(void) const {return is_fixed_point_;}
+
+    /*!
+      \fn void BenchmarkScoring(GGsize const& number_of_deposits) const
+      \param number_of_deposits - number of deposits scored for each backend
+      \brief Measure deposits per second in a hot-spot of 64 dosels, with atomic backend and replicated backend for several numbers of copies, in floating point and in fixed-point. Error of energy sums is compared to a reference computed on host
+    */
+    void BenchmarkScoring(GGsize const& number_of_deposits) const;
+
     /*!
       \fn inline cl::Buffer* GetPhotonTrackingBuffer(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
@@ -220,11 +251,10 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     inline cl::Buffer* GetDoseParams(GGsize const& thread_index) const {return dose_params_[thread_index];}
 
     /*!
-      \fn void ComputeDose(GGsize const& thread_index)
-      \param thread_index - index of activated device (thread index)
-      \brief computing dose
+      \fn void ComputeDose(void)
+      \brief merging energy deposits, squared deposits and hits of all devices on first device, and computing dose and uncertainty once
     */
-    void ComputeDose(GGsize const& thread_index);
+    void ComputeDose(void);
 
     /*!
       \fn void SaveResults(void) const
@@ -245,6 +275,23 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     */
     void InitializeKernel(void);
 
+    /*!
+      \fn inline GGsize GetEdepTypeSize(void) const
+      \return size in bytes of an element of edep and edep squared buffers
+      \brief get the size of an element of edep buffers, number of quanta with fixed-point scoring
+    */
+    inline GGsize GetEdepTypeSize(void) const {return is_fixed_point_ ? sizeof(GGulong) : sizeof(GGDosiType);}
+
+    /*!
+      \fn template <typename T> bool SumOverDevices(cl::Buffer** buffers) const
+      \tparam T - type of element in buffers
+      \param buffers - buffer of dosels on each activated device
+      \return true if a sum of unsigned integers overflowed
+      \brief adding buffers of all devices in buffer of first device, dosels are summed by host threads
+    */
+    template <typename T>
+    bool SumOverDevices(cl::Buffer** buffers) const;
+
     /*!
       \fn void SavePhotonTracking(void) const
       \brief save photon tracking
@@ -299,7 +346,12 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     GGchar is_water_reference_; /*!< Water reference for dose computation */
     GGfloat minimum_density_; /*!< Minimum density value for dose computation */
 
+    GGsize number_of_replicas_; /*!< Number of copies of edep, edep squared and hit maps, 1 for atomic backend */
+    bool is_fixed_point_; /*!< Energy deposits summed as numbers of quanta */
+    GGfloat edep_quantum_; /*!< Energy of a quantum for fixed-point scoring */
+
     cl::Kernel** kernel_compute_dose_; /*!< OpenCL kernel computing dose in voxelized solid */
+    cl::Kernel** kernel_reduce_dose_replicas_; /*!< OpenCL kernel merging copies of dose maps */
     GGsize number_activated_devices_; /*!< Number of activated device */
 };
 
@@ -409,6 +461,33 @@ extern "C" GGEMS_EXPORT void dose_uncertainty_dosimetry_calculator(GGEMSDosimetr
 */
 extern "C" GGEMS_EXPORT void dose_tle_navigator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated);
 
+/*!
+  \fn void scoring_backend_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, char const* scoring_backend, GGsize const number_of_replicas)
+  \param dose_calculator - pointer on dose calculator
+  \param scoring_backend - atomic or replicated
+  \param number_of_replicas - number of copies of dose maps for replicated backend
+  \brief select the backend scoring energy deposits
+*/
+extern "C" GGEMS_EXPORT void scoring_backend_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, char const* scoring_backend, GGsize const number_of_replicas);
+
+/*!
+  \fn void fixed_point_scoring_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated, GGfloat const quantum, char const* unit)
+  \param dose_calculator - pointer on dose calculator
+  \param is_activated - boolean activating fixed-point scoring
+  \param quantum - energy of a quantum
+  \param unit - unit of the energy
+  \brief energy deposits summed as numbers of quanta
+*/
+extern "C" GGEMS_EXPORT void fixed_point_scoring_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated, GGfloat const quantum, char const* unit);
+
+/*!
+  \fn void benchmark_scoring_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGsize const number_of_deposits)
+  \param dose_calculator - pointer on dose calculator
+  \param number_of_deposits - number of deposits scored for each backend
+  \brief measure deposits per second of scoring backends in a hot-spot
+*/
+extern "C" GGEMS_EXPORT void benchmark_scoring_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGsize const number_of_deposits);
+
 /*!
   \fn void attach_to_navigator_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, char const* navigator)
   \param dose_calculator - pointer on dose calculator
@@ -204,11 +204,10 @@ class GGEMS_EXPORT GGEMSNavigator
     virtual void SaveResults(void) = 0;
 
     /*!
-      \fn void ComputeDose(GGsize const& thread_index)
-      \param thread_index - index of activated device (thread index)
-      \brief Compute dose in volume
+      \fn void ComputeDose(void)
+      \brief Compute dose in volume, once all devices are done
     */
-    void ComputeDose(GGsize const& thread_index);
+    void ComputeDose(void);
 
     /*!
       \fn void StoreOutput(std::string basename)
@@ -270,6 +269,19 @@ class GGEMS_EXPORT GGEMSNavigator
     */
     void SetMaterialVisible(std::string const& material_name, bool const& is_material_visible);
 
+    /*!
+      \fn void SetMultiSolidNavigation(bool const& is_multi_solid)
+      \param is_multi_solid - flag activating multi-solid navigation
+      \brief launch one kernel per navigation step for all solid boxes of the navigator instead of one kernel per solid
+    */
+    void SetMultiSolidNavigation(bool const& is_multi_solid);
+
+    /*!
+      \fn void UnpackMultiSolidHistograms(void)
+      \brief copy packed histograms of multi-solid navigation to histograms of each solid
+    */
+    void UnpackMultiSolidHistograms(void);
+
   protected:
     /*!
       \fn void CheckParameters(void) const
@@ -277,6 +289,19 @@ class GGEMS_EXPORT GGEMSNavigator
     */
     virtual void CheckParameters(void) const;
 
+    /*!
+      \fn void InitializeMultiSolid(void)
+      \brief pack data of all solid boxes in a single buffer and compile multi-solid projection and tracking kernels, closest solid is found by BVH of navigator manager
+    */
+    void InitializeMultiSolid(void);
+
+    /*!
+      \fn bool IsMultiSolidCompatible(void) const
+      \return true if all solids can be navigated by a single kernel
+      \brief check if navigator contains only solid boxes with same histogram and kernel options
+    */
+    bool IsMultiSolidCompatible(void) const;
+
   protected:
     std::string navigator_name_; /*!< Name of the navigator */
 
@@ -305,6 +330,16 @@ class GGEMS_EXPORT GGEMSNavigator
     bool is_tle_;  /*!< Boolean checking if tle mode is activated */
     GGsize number_activated_devices_; /*!< Number of activated device */
 
+    // Multi-solid navigation
+    bool is_multi_solid_; /*!< Flag activating multi-solid navigation */
+    cl::Buffer** multi_solid_data_; /*!< Packed data of all solid boxes for each device, nullptr if multi-solid navigation is not used */
+    cl::Buffer** multi_solid_histogram_; /*!< Packed histograms of all solid boxes */
+    cl::Buffer** multi_solid_scatter_histogram_; /*!< Packed scatter histograms of all solid boxes */
+    GGsize multi_solid_histogram_stride_; /*!< Number of elements in histogram of one solid */
+    bool is_multi_solid_local_histogram_; /*!< Packed histograms counted in local memory by work-group */
+    cl::Kernel** kernel_multi_solid_project_to_solid_; /*!< OpenCL kernel moving particles to closest solid */
+    cl::Kernel** kernel_multi_solid_track_through_solid_; /*!< OpenCL kernel tracking particles through all solids */
+
     // OpenGL
     bool is_visible_; /*!< flag for opengl */
     MaterialRGBColorUMap custom_material_rgb_; /*!< Custom color for material */
@@ -106,11 +106,11 @@ class GGEMS_EXPORT GGEMSNavigatorManager
     void StoreWorld(GGEMSWorld* world);
 
     /*!
-      \fn void Initialize(bool const& is_tracking = false) const
+      \fn void Initialize(bool const& is_tracking = false)
       \param is_tracking - flag activating tracking
       \brief Initialize a GGEMS navigators
     */
-    void Initialize(bool const& is_tracking = false) const;
+    void Initialize(bool const& is_tracking = false);
 
     /*!
       \fn void PrintInfos(void)
@@ -201,11 +201,10 @@ class GGEMS_EXPORT GGEMSNavigatorManager
     void WorldTracking(GGsize const& thread_index) const;
 
     /*!
-      \fn void ComputeDose(GGsize const& thread_index)
-      \param thread_index - index of activated device (thread index)
-      \brief Compute dose in volume
+      \fn void ComputeDose(void)
+      \brief Compute dose in volume, once all devices are done
     */
-    void ComputeDose(GGsize const& thread_index);
+    void ComputeDose(void);
 
     /*!
       \fn void Clean(void)
@@ -213,10 +212,33 @@ class GGEMS_EXPORT GGEMSNavigatorManager
     */
     void Clean(void);
 
+    /*!
+      \fn void BenchmarkFindSolid(GGsize const& number_of_rays) const
+      \param number_of_rays - number of rays searching their closest module
+      \brief Measure wall time finding the closest solid with one distance kernel launch per solid and with BVH, for rings of 1 to 512 CT modules
+    */
+    void BenchmarkFindSolid(GGsize const& number_of_rays) const;
+
+  private:
+    /*!
+      \fn void InitializeBVH(void)
+      \brief build BVH over OBB of all the solids and copy it on each OpenCL device
+    */
+    void InitializeBVH(void);
+
   private:
     GGEMSNavigator** navigators_; /*!< Pointer on the navigators */
     GGsize number_of_navigators_; /*!< Number of navigators */
     GGEMSWorld* world_; /*!< Pointer on world volume */
+
+    // BVH over all the solids
+    cl::Buffer** bvh_nodes_; /*!< Nodes of BVH for each device, nullptr if BVH is not used */
+    cl::Buffer** bvh_solids_; /*!< Solids referenced by BVH for each device */
+    GGsize number_of_bvh_nodes_; /*!< Number of nodes in BVH */
+    GGsize number_of_bvh_solids_; /*!< Number of solids in BVH */
+    GGsize bvh_depth_; /*!< Depth of BVH */
+    cl::Kernel** kernel_particle_solid_distance_bvh_; /*!< OpenCL kernel computing distance between particles and closest solid using BVH */
+    GGsize number_activated_devices_; /*!< Number of activated device */
 };
 
 #endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSNAVIGATORMANAGER_HH
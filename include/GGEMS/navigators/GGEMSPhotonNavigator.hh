@@ -46,50 +46,98 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void GetPhotonNextInteraction(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const index_material, GGint const index_particle)
-  \param primary_particle - buffer of particles
+  \fn inline GGfloat GetPhotonTotalCrossSection(global GGEMSParticleCrossSections const* particle_cross_sections, GGuchar const index_material, GGint const energy_id)
+  \param particle_cross_sections - buffer of cross sections
+  \param index_material - index of the material
+  \param energy_id - index of energy bin in cross section table
+  \return sum of the cross sections of activated photon processes in mm-1
+  \brief Get the total photon cross section in a material, stored at the head of the (material, energy) record
+*/
+inline GGfloat GetPhotonTotalCrossSection(
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  GGuchar const index_material,
+  GGint const energy_id)
+{
+  return particle_cross_sections->photon_cross_sections_[PhotonTotalCrossSectionIndex(particle_cross_sections->number_of_bins_, index_material, energy_id)];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar SelectPhotonProcess(GGEMSParticle* particle, global GGEMSRandom* random, global GGEMSParticleCrossSections const* particle_cross_sections, GGuchar const index_material, GGint const energy_id, GGfloat const total_cross_section, GGint const particle_id)
+  \param particle - state of the particle in private memory
   \param random - pointer on random numbers
   \param particle_cross_sections - buffer of cross sections
   \param index_material - index of the material
-  \param index_particle - index of the particle
-  \brief Determine the next photon interaction
+  \param energy_id - index of energy bin in cross section table
+  \param total_cross_section - total photon cross section in the material
+  \param particle_id - index of the particle
+  \return index of the selected photon process
+  \brief Select the photon process of an interaction, each process is drawn with a probability proportional to its cross section
+*/
+inline GGchar SelectPhotonProcess(
+  GGEMSParticle* particle,
+  global GGEMSRandom* random,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  GGuchar const index_material,
+  GGint const energy_id,
+  GGfloat const total_cross_section,
+  GGint const particle_id)
+{
+  GGfloat cumulated_cross_section = ParticleUniform(particle, random, particle_id) * total_cross_section;
+  GGchar photon_process_id = NO_PROCESS;
+
+  // Loop over activated processes, last process is kept if rounding errors exhaust the loop
+  for (GGchar i = 0; i < particle_cross_sections->number_of_activated_photon_processes_; ++i) {
+    photon_process_id = particle_cross_sections->photon_cs_id_[i];
+    cumulated_cross_section -= particle_cross_sections->photon_cross_sections_[PhotonCrossSectionIndex(particle_cross_sections->number_of_bins_, photon_process_id, index_material, energy_id)];
+    if (cumulated_cross_section < 0.0f) break;
+  }
+
+  return photon_process_id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void GetPhotonNextInteraction(GGEMSParticle* particle, global GGEMSRandom* random, global GGEMSParticleCrossSections const* particle_cross_sections, GGuchar const index_material, GGint const particle_id)
+  \param particle - state of the particle in private memory
+  \param random - pointer on random numbers
+  \param particle_cross_sections - buffer of cross sections
+  \param index_material - index of the material
+  \param particle_id - index of the particle
+  \brief Determine the next photon interaction, the distance is sampled from the total cross section and the process is selected afterwards
 */
 inline void GetPhotonNextInteraction(
-  global GGEMSPrimaryParticles* primary_particle,
+  GGEMSParticle* particle,
   global GGEMSRandom* random,
   global GGEMSParticleCrossSections const* particle_cross_sections,
   GGuchar const index_material,
   GGint const particle_id)
 {
   // Getting energy of the particle and the index of energy in cross section table
-  GGint energy_id = BinarySearchLeft(primary_particle->E_[particle_id], particle_cross_sections->energy_bins_, particle_cross_sections->number_of_bins_, 0, 0);
+  GGint energy_id = LogUniformBinIndex(particle->E_, particle_cross_sections->energy_bins_, particle_cross_sections->number_of_bins_, particle_cross_sections->log_min_energy_, particle_cross_sections->inverse_log_energy_step_);
 
   // Initialization of next interaction distance
   GGfloat next_interaction_distance = OUT_OF_WORLD;
   GGchar next_discrete_process = NO_PROCESS;
-  GGchar photon_process_id = 0;
-  GGfloat interaction_distance = 0.0f;
-
-  // Loop over activated processes
-  for (GGchar i = 0; i < particle_cross_sections->number_of_activated_photon_processes_; ++i) {
-    // Getting index of process
-    photon_process_id = particle_cross_sections->photon_cs_id_[i];
 
-    // Getting the interaction distance
-    interaction_distance =
-      -log(KissUniform(random, particle_id))/
-      particle_cross_sections->photon_cross_sections_[photon_process_id][energy_id + particle_cross_sections->number_of_bins_*index_material];
+  // Total cross section and cross section of each process are read in the same record
+  GGfloat total_cross_section = GetPhotonTotalCrossSection(particle_cross_sections, index_material, energy_id);
 
-    if (interaction_distance < next_interaction_distance) {
-      next_interaction_distance = interaction_distance;
-      next_discrete_process = photon_process_id;
-    }
+  if (total_cross_section > 0.0f) {
+    next_interaction_distance = -log(ParticleUniform(particle, random, particle_id)) / total_cross_section;
+    next_discrete_process = SelectPhotonProcess(particle, random, particle_cross_sections, index_material, energy_id, total_cross_section, particle_id);
   }
 
-  // Storing results in particle buffer
-  primary_particle->E_index_[particle_id] = energy_id;
-  primary_particle->next_interaction_distance_[particle_id] = next_interaction_distance;
-  primary_particle->next_discrete_process_[particle_id] = next_discrete_process;
+  // Storing results in particle
+  particle->E_index_ = energy_id;
+  particle->next_interaction_distance_ = next_interaction_distance;
+  particle->next_discrete_process_ = next_discrete_process;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -97,17 +145,17 @@ inline void GetPhotonNextInteraction(
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void PhotonDiscreteProcess(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const material_id, GGint const particle_id)
-  \param primary_particle - buffer of particles
+  \fn inline void PhotonDiscreteProcess(GGEMSParticle* particle, global GGEMSRandom* random, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, GGuchar const material_id, GGint const particle_id)
+  \param particle - state of the particle in private memory
   \param random - pointer on random numbers
   \param materials - buffer of materials
   \param particle_cross_sections - pointer to cross sections activated in navigator
   \param material_id - index of the material
-  \param index_particle - index of the particle
+  \param particle_id - index of the particle
   \brief Launch sampling depending on photon process
 */
 inline void PhotonDiscreteProcess(
-  global GGEMSPrimaryParticles* primary_particle,
+  GGEMSParticle* particle,
   global GGEMSRandom* random,
   global GGEMSMaterialTables const* materials,
   global GGEMSParticleCrossSections const* particle_cross_sections,
@@ -116,17 +164,17 @@ inline void PhotonDiscreteProcess(
 )
 {
   // Get photon process
-  GGchar next_iteraction_process = primary_particle->next_discrete_process_[particle_id];
+  GGchar next_iteraction_process = particle->next_discrete_process_;
 
   // Select process
   if (next_iteraction_process == COMPTON_SCATTERING) {
-    KleinNishinaComptonSampleSecondaries(primary_particle, random, particle_id);
+    KleinNishinaComptonSampleSecondaries(particle, random, particle_id);
   }
   else if (next_iteraction_process == PHOTOELECTRIC_EFFECT) {
-    StandardPhotoElectricSampleSecondaries(primary_particle, particle_id);
+    StandardPhotoElectricSampleSecondaries(particle);
   }
   else if (next_iteraction_process == RAYLEIGH_SCATTERING) {
-    LivermoreRayleighSampleSecondaries(primary_particle, random, materials, particle_cross_sections, material_id, particle_id);
+    LivermoreRayleighSampleSecondaries(particle, random, materials, particle_cross_sections, material_id, particle_id);
   }
 }
 
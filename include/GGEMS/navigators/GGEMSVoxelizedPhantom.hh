@@ -86,6 +86,34 @@ class GGEMS_EXPORT GGEMSVoxelizedPhantom : public GGEMSNavigator
     */
     void SetPhantomFile(std::string const& voxelized_phantom_filename, std::string const& range_data_filename);
 
+    /*!
+      \fn void SetWoodcockTracking(bool const& is_woodcock)
+      \param is_woodcock - flag activating Woodcock tracking
+      \brief Track photons with Woodcock (delta) tracking, jumping between virtual interactions sampled with the majorant cross section instead of crossing each voxel. The majorant is a single maximum over all materials of the phantom, so in heterogeneous phantoms (bone or metal next to air or lung) most steps in low density regions are virtual interactions and Woodcock tracking can be slower than exact tracking
+    */
+    void SetWoodcockTracking(bool const& is_woodcock);
+
+    /*!
+      \fn void SetLabelLayout(std::string const& label_layout)
+      \param label_layout - layout of label data: linear (default), brick4, brick8 or morton
+      \brief Set the layout of labels in device memory, bricks keep neighbour voxels along Y and Z in the same cache lines
+    */
+    void SetLabelLayout(std::string const& label_layout);
+
+    /*!
+      \fn void BenchmarkLabelLayouts(GGsize const& number_of_rays) const
+      \param number_of_rays - number of rays walking through the labels
+      \brief Measure label reads per second for each label layout, the phantom has to be initialized
+    */
+    void BenchmarkLabelLayouts(GGsize const& number_of_rays) const;
+
+    /*!
+      \fn void BenchmarkLabelConversion(GGsize const& number_of_slices) const
+      \param number_of_slices - number of 512x512 slices of the synthetic image
+      \brief Measure conversion of a synthetic image to labels with 40 ranges, scan of each range against sorted intervals and look-up table
+    */
+    void BenchmarkLabelConversion(GGsize const& number_of_slices) const;
+
     /*!
       \fn void Initialize(void) override
       \brief Initialize the voxelized phantom
@@ -108,6 +136,8 @@ class GGEMS_EXPORT GGEMSVoxelizedPhantom : public GGEMSNavigator
   private:
     std::string voxelized_phantom_filename_; /*!< MHD file storing the voxelized phantom */
     std::string range_data_filename_; /*!< File for label to material matching */
+    bool is_woodcock_; /*!< Flag activating Woodcock tracking */
+    std::string label_layout_; /*!< Layout of label data */
 };
 
 /*!
@@ -127,6 +157,38 @@ extern "C" GGEMS_EXPORT GGEMSVoxelizedPhantom* create_ggems_voxelized_phantom(ch
 */
 extern "C" GGEMS_EXPORT void set_phantom_file_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, char const* phantom_filename, char const* range_data_filename);
 
+/*!
+  \fn void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_woodcock)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param is_woodcock - flag activating Woodcock tracking
+  \brief Activate Woodcock tracking in voxelized phantom
+*/
+extern "C" GGEMS_EXPORT void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_woodcock);
+
+/*!
+  \fn void set_label_layout_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, char const* label_layout)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param label_layout - layout of label data
+  \brief Set the layout of label data in voxelized phantom
+*/
+extern "C" GGEMS_EXPORT void set_label_layout_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, char const* label_layout);
+
+/*!
+  \fn void benchmark_label_layouts_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGsize const number_of_rays)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param number_of_rays - number of rays walking through the labels
+  \brief Measure label reads per second for each label layout
+*/
+extern "C" GGEMS_EXPORT void benchmark_label_layouts_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGsize const number_of_rays);
+
+/*!
+  \fn void benchmark_label_conversion_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGsize const number_of_slices)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param number_of_slices - number of 512x512 slices of the synthetic image
+  \brief Measure conversion of a synthetic image to labels
+*/
+extern "C" GGEMS_EXPORT void benchmark_label_conversion_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGsize const number_of_slices);
+
 /*!
   \fn void set_position_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGfloat const position_x, GGfloat const position_y, GGfloat const position_z, char const* unit)
   \param voxelized_phantom - pointer on voxelized phantom
@@ -128,6 +128,13 @@ class GGEMS_EXPORT GGEMSCrossSections
     */
     inline cl::Buffer* GetCrossSections(GGsize const& thread_index) const {return particle_cross_sections_[thread_index];}
 
+    /*!
+      \fn inline GGsize GetCrossSectionsSize(void) const
+      \return size in bytes of cross section tables on a OpenCL device
+      \brief return the size of OpenCL buffer storing cross sections, depending on number of materials and bins
+    */
+    inline GGsize GetCrossSectionsSize(void) const {return particle_cross_sections_size_;}
+
     /*!
       \fn GGfloat GetPhotonCrossSection(std::string const& process_name, std::string const& material_name, GGfloat const& energy, std::string const& unit) const
       \param process_name - name of the process
@@ -139,6 +146,13 @@ class GGEMS_EXPORT GGEMSCrossSections
     */
     GGfloat GetPhotonCrossSection(std::string const& process_name, std::string const& material_name, GGfloat const& energy, std::string const& unit) const;
 
+    /*!
+      \fn void BenchmarkEnergyBinLookup(GGsize const& number_of_lookups) const
+      \param number_of_lookups - number of energy bin lookups on each device
+      \brief Measure lookups per second of energy bin in cross section table on each device, with BinarySearchLeft and LogUniformBinIndex
+    */
+    void BenchmarkEnergyBinLookup(GGsize const& number_of_lookups) const;
+
     /*!
       \fn void Clean(void)
       \brief clean all cross sections on each OpenCL device
@@ -152,11 +166,20 @@ class GGEMS_EXPORT GGEMSCrossSections
     */
     void LoadPhysicTablesOnHost(void);
 
+    /*!
+      \fn void BuildTotalCrossSections(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief Compute for each material and energy bin the total photon cross section, and for each energy bin the maximum of total photon cross section over all materials of the navigator (Woodcock tracking)
+    */
+    void BuildTotalCrossSections(GGsize const& thread_index);
+
   private:
     GGEMSEMProcess** em_processes_list_; /*!< vector of electromagnetic processes */
     GGsize number_of_activated_processes_; /*!< Number of activated processes */
     std::vector<bool> is_process_activated_; /*!< Boolean checking if the process is already activated */
-    cl::Buffer** particle_cross_sections_; /*!< Pointer storing cross sections for each particles on OpenCL device */
+    cl::Buffer** particle_cross_sections_; /*!< Pointer storing cross sections for each particles on OpenCL device, owned by GGEMSPhysicTablesRegistry */
+    GGsize particle_cross_sections_size_; /*!< Size in bytes of cross section tables */
+    std::string physic_tables_key_; /*!< Key of cross section tables in GGEMSPhysicTablesRegistry */
     GGEMSParticleCrossSections* particle_cross_sections_host_; /*!< Pointer storing cross sections for each particles on host (RAM memory) */
     GGsize number_activated_devices_; /*!< Number of activated device */
     GGEMSMaterials* materials_; /*!< Pointer to material defined in a navigator */
@@ -199,6 +222,14 @@ extern "C" GGEMS_EXPORT void initialize_ggems_cross_sections(GGEMSCrossSections*
 */
 extern "C" GGEMS_EXPORT GGfloat get_cs_ggems_cross_sections(GGEMSCrossSections* cross_sections, char const* process_name, char const* material_name, GGfloat const energy, char const* unit);
 
+/*!
+  \fn void benchmark_energy_bin_lookup_ggems_cross_sections(GGEMSCrossSections* cross_sections, GGsize const number_of_lookups)
+  \param cross_sections - pointer on GGEMS cross sections
+  \param number_of_lookups - number of energy bin lookups on each device
+  \brief measure lookups per second of energy bin in cross section table
+*/
+extern "C" GGEMS_EXPORT void benchmark_energy_bin_lookup_ggems_cross_sections(GGEMSCrossSections* cross_sections, GGsize const number_of_lookups);
+
 /*!
   \fn void clean_ggems_cross_sections(GGEMSCrossSections* cross_sections)
   \param cross_sections - pointer on GGEMS cross sections
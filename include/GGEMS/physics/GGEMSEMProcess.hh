@@ -92,13 +92,14 @@ class GGEMS_EXPORT GGEMSEMProcess
     inline std::string GetProcessName(void) const {return process_name_;}
 
     /*!
-      \fn void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index)
+      \fn void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, GGsize const& particle_cross_sections_size, cl::Buffer* material_tables, GGsize const& thread_index)
       \param particle_cross_sections - OpenCL buffer storing all the cross section tables for each particles
+      \param particle_cross_sections_size - size in bytes of particle_cross_sections buffer
       \param material_tables - material tables on OpenCL device
       \param thread_index - index of activated device (thread index)
       \brief build cross section tables and storing them in particle_cross_sections
     */
-    virtual void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index);
+    virtual void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, GGsize const& particle_cross_sections_size, cl::Buffer* material_tables, GGsize const& thread_index);
 
   protected:
     /*!
@@ -31,11 +31,18 @@
   \date Friday April 3, 2020
 */
 
+#ifndef __OPENCL_C_VERSION__
+#include <cstddef>
+#endif
+
 #include "GGEMS/physics/GGEMSProcessConstants.hh"
 
+#define NUMBER_OF_CHEMICAL_ELEMENTS_IN_TABLE 101 /*!< 100 chemical elements + 1 first empty element in cross section per atom tables */
+#define PHOTON_CROSS_SECTION_RECORD_SIZE (NUMBER_PHOTON_PROCESSES+1) /*!< Total cross section + cross section of each photon process, for a material and an energy bin */
+
 /*!
   \struct GGEMSParticleCrossSections_t
-  \brief Structure storing the photon cross sections for OpenCL device
+  \brief Structure storing the photon cross sections for OpenCL device, the buffer on device is sized for the number of materials and bins of the table (GetParticleCrossSectionsSize)
 */
 typedef struct GGEMSParticleCrossSections_t
 {
@@ -44,17 +51,79 @@ typedef struct GGEMSParticleCrossSections_t
   GGsize number_of_materials_; /*!< Number of materials */
   GGfloat min_energy_; /*!< Min energy in the cross section table */
   GGfloat max_energy_; /*!< Max energy in the cross section table */
+  GGfloat log_min_energy_; /*!< Log of first energy bin, energy bins are log-uniform */
+  GGfloat inverse_log_energy_step_; /*!< Inverse of log step between energy bins, bin index is computed from log of energy (LogUniformBinIndex) */
   GGfloat energy_bins_[MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Energy in bin (220 by default) */
 
   // Photon
-  // 256: Max number of materials [0...255]
-  // MAX_CROSS_SECTION_TABLE_NUMBER_BINS: Max number of bins [0...2047]
-  GGfloat photon_cross_sections_[NUMBER_PHOTON_PROCESSES][256*MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Photon cross sections per material in mm-1 */
-  GGfloat photon_cross_sections_per_atom_[NUMBER_PHOTON_PROCESSES][101*MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Photon cross sections per atom in mm-1, 100 chemical elements + 1 first empty element */
   GGsize number_of_activated_photon_processes_; /*!< Number of activated photon processes, 3 processes -> 0: Compton, 1: Photoelectric, 2: Rayleigh */
   GGchar photon_cs_id_[NUMBER_PHOTON_PROCESSES]; /*!< Index of activated photon process, ex: if only Rayleigh activate index_photon_cs[0] = 2 */
+  GGfloat photon_majorant_cross_sections_[MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Maximum over materials of total photon cross section per energy bin in mm-1, used by Woodcock tracking */
 
   GGchar material_names_[256][64]; /*!< Name of the materials */
+
+  // Must be the last member, only number_of_materials_ and number_of_bins_ are allocated on device
+  // Cross sections per material in mm-1 first, then cross sections per atom in mm-1
+  // For a material and an energy bin, total cross section and cross section of each process are contiguous
+  // 256: Max number of materials [0...255]
+  // MAX_CROSS_SECTION_TABLE_NUMBER_BINS: Max number of bins [0...2047]
+  GGfloat photon_cross_sections_[(PHOTON_CROSS_SECTION_RECORD_SIZE*256+NUMBER_PHOTON_PROCESSES*NUMBER_OF_CHEMICAL_ELEMENTS_IN_TABLE)*MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Photon cross sections per material and per atom, see PhotonTotalCrossSectionIndex, PhotonCrossSectionIndex and PhotonCrossSectionPerAtomIndex */
 } GGEMSParticleCrossSections; /*!< Using C convention name of struct to C++ (_t deletion) */
 
+/*!
+  \fn inline GGsize PhotonTotalCrossSectionIndex(GGsize const number_of_bins, GGsize const material_id, GGsize const energy_id)
+  \param number_of_bins - number of bins in cross section table
+  \param material_id - index of material
+  \param energy_id - index of energy bin
+  \return index of total cross section per material in photon_cross_sections_
+  \brief Get index of the total cross section of activated photon processes for a material, cross sections of each process follow it
+*/
+inline GGsize PhotonTotalCrossSectionIndex(GGsize const number_of_bins, GGsize const material_id, GGsize const energy_id)
+{
+  return PHOTON_CROSS_SECTION_RECORD_SIZE*(energy_id + number_of_bins*material_id);
+}
+
+/*!
+  \fn inline GGsize PhotonCrossSectionIndex(GGsize const number_of_bins, GGsize const process_id, GGsize const material_id, GGsize const energy_id)
+  \param number_of_bins - number of bins in cross section table
+  \param process_id - index of photon process
+  \param material_id - index of material
+  \param energy_id - index of energy bin
+  \return index of cross section per material in photon_cross_sections_
+  \brief Get index of the cross section of a process for a material
+*/
+inline GGsize PhotonCrossSectionIndex(GGsize const number_of_bins, GGsize const process_id, GGsize const material_id, GGsize const energy_id)
+{
+  return PHOTON_CROSS_SECTION_RECORD_SIZE*(energy_id + number_of_bins*material_id) + 1 + process_id;
+}
+
+/*!
+  \fn inline GGsize PhotonCrossSectionPerAtomIndex(GGsize const number_of_bins, GGsize const number_of_materials, GGsize const process_id, GGsize const atomic_number, GGsize const energy_id)
+  \param number_of_bins - number of bins in cross section table
+  \param number_of_materials - number of materials in cross section table
+  \param process_id - index of photon process
+  \param atomic_number - Z number of chemical element
+  \param energy_id - index of energy bin
+  \return index of cross section per atom in photon_cross_sections_
+  \brief Get index of the cross section of a process for a chemical element, stored after the cross sections per material
+*/
+inline GGsize PhotonCrossSectionPerAtomIndex(GGsize const number_of_bins, GGsize const number_of_materials, GGsize const process_id, GGsize const atomic_number, GGsize const energy_id)
+{
+  return PHOTON_CROSS_SECTION_RECORD_SIZE*number_of_materials*number_of_bins + energy_id + number_of_bins*(atomic_number + NUMBER_OF_CHEMICAL_ELEMENTS_IN_TABLE*process_id);
+}
+
+#ifndef __OPENCL_C_VERSION__
+/*!
+  \fn inline GGsize GetParticleCrossSectionsSize(GGsize const& number_of_bins, GGsize const& number_of_materials)
+  \param number_of_bins - number of bins in cross section table
+  \param number_of_materials - number of materials in cross section table
+  \return size in bytes of GGEMSParticleCrossSections for number_of_bins and number_of_materials
+  \brief Get the size of GGEMSParticleCrossSections buffer, cross sections are allocated only for the used bins and materials
+*/
+inline GGsize GetParticleCrossSectionsSize(GGsize const& number_of_bins, GGsize const& number_of_materials)
+{
+  return offsetof(GGEMSParticleCrossSections, photon_cross_sections_) + sizeof(GGfloat) * (PHOTON_CROSS_SECTION_RECORD_SIZE * number_of_materials + NUMBER_PHOTON_PROCESSES * NUMBER_OF_CHEMICAL_ELEMENTS_IN_TABLE) * number_of_bins;
+}
+#endif
+
 #endif // GUARD_GGEMS_PHYSICS_GGEMSPARTICLECROSSSECTIONS_HH
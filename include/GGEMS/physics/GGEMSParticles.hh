@@ -99,6 +99,37 @@ class GGEMS_EXPORT GGEMSParticles
     */
     inline cl::Buffer* GetPrimaryParticles(GGsize const& thread_index) const {return primary_particles_[thread_index];}
 
+    /*!
+      \fn inline cl::Buffer* GetNextPrimaryParticles(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return pointer to OpenCL buffer storing particles of next batch
+      \brief return the pointer to OpenCL buffer where next batch is generated during transport of current batch
+    */
+    inline cl::Buffer* GetNextPrimaryParticles(GGsize const& thread_index) const {return next_primary_particles_[thread_index];}
+
+    /*!
+      \fn inline cl::Buffer* GetTrajectories(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return pointer to OpenCL buffer storing interactions of displayed particles, nullptr if OpenGL is not activated
+      \brief return the pointer to OpenCL buffer storing particle trajectories for OpenGL
+    */
+    inline cl::Buffer* GetTrajectories(GGsize const& thread_index) const {return trajectories_ ? trajectories_[thread_index] : nullptr;}
+
+    /*!
+      \fn inline cl::Buffer* GetNextTrajectories(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return pointer to OpenCL buffer storing interactions of displayed particles of next batch, nullptr if OpenGL is not activated
+      \brief return the pointer to OpenCL buffer storing particle trajectories of next batch for OpenGL
+    */
+    inline cl::Buffer* GetNextTrajectories(GGsize const& thread_index) const {return next_trajectories_ ? next_trajectories_[thread_index] : nullptr;}
+
+    /*!
+      \fn void SwapBuffers(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief particles of next batch become the transported particles
+    */
+    void SwapBuffers(GGsize const& thread_index);
+
     /*!
       \fn void SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles)
       \param thread_index - index of activated device (thread index)
@@ -115,11 +146,42 @@ class GGEMS_EXPORT GGEMSParticles
     */
     inline GGsize GetNumberOfParticles(GGsize const& thread_index) const {return number_of_particles_[thread_index];}
 
+    /*!
+      \fn inline GGsize GetNumberOfActiveParticles(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return number of particles navigation kernels are dispatched over
+      \brief Get the number of live particles found by last compaction, or the number of particles in buffer without compaction
+    */
+    inline GGsize GetNumberOfActiveParticles(GGsize const& thread_index) const
+    {
+      #ifdef PARTICLE_COMPACTION
+      return number_of_live_particles_[thread_index];
+      #else
+      return number_of_particles_[thread_index];
+      #endif
+    }
+
+    #ifdef PARTICLE_COMPACTION
+    /*!
+      \fn void CompactParticles(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \brief enqueue building of dense list of live particles, number of live particles is stored in alive counter
+    */
+    void CompactParticles(GGsize const& thread_index) const;
+    #endif
+
+    /*!
+      \fn void EnqueueAliveCount(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \brief enqueue counting of alive particles, result is read without blocking in pinned host memory
+    */
+    void EnqueueAliveCount(GGsize const& thread_index) const;
+
     /*!
       \fn bool IsAlive(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
       \return true if source is still alive, otherwize false
-      \brief check if some particles are alive in OpenCL particle buffer
+      \brief check if some particles are alive in OpenCL particle buffer, waiting only for the counting enqueued by EnqueueAliveCount
     */
     bool IsAlive(GGsize const& thread_index) const;
 
@@ -146,9 +208,26 @@ class GGEMS_EXPORT GGEMSParticles
   private:
     GGsize* number_of_particles_; /*!< Number of activated particles in buffer */
     cl::Buffer** primary_particles_; /*!< Pointer storing info about primary particles in batch on OpenCL device */
-    cl::Buffer** status_; /*!< Buffer storing status of particle */
+    cl::Buffer** next_primary_particles_; /*!< Pointer storing info about primary particles of next batch on OpenCL device */
+    cl::Buffer** trajectories_; /*!< Pointer storing interactions of displayed particles for OpenGL, only if OpenGL is activated */
+    cl::Buffer** next_trajectories_; /*!< Pointer storing interactions of displayed particles of next batch for OpenGL */
+    cl::Buffer** status_; /*!< Buffer storing number of alive particles */
+    cl::Buffer** alive_count_host_; /*!< Pinned host buffer receiving number of alive particles */
+    GGint** alive_count_; /*!< Pointer to pinned host buffer, mapped during all the simulation */
+    cl::Event* alive_count_event_; /*!< Event of reading number of alive particles */
+    bool* is_alive_count_enqueued_; /*!< Flag checking if a counting is enqueued */
     GGsize number_activated_devices_; /*!< Number of activated device */
     cl::Kernel** kernel_alive_; /*!< Kernel checking if particles are alive */
+
+    #ifdef PARTICLE_COMPACTION
+    GGsize* number_of_live_particles_; /*!< Number of live particles found by last compaction */
+    cl::Buffer** block_count_; /*!< Number of live particles in each work-group, then offset of work-group in dense list, followed by upper levels of prefix sum */
+    GGsize number_of_blocks_; /*!< Size of block_count_, maximum number of work-groups for compaction and upper levels of prefix sum */
+    cl::Kernel** kernel_count_live_; /*!< Kernel counting live particles in each work-group */
+    cl::Kernel** kernel_scan_live_; /*!< Kernel computing a level of prefix sum of work-group counts */
+    cl::Kernel** kernel_add_live_offsets_; /*!< Kernel adding offsets of upper level of prefix sum */
+    cl::Kernel** kernel_compact_live_; /*!< Kernel writing dense list of live particles */
+    #endif
 };
 
 #endif // End of GUARD_GGEMS_PHYSICS_GGEMSPARTICLES_HH
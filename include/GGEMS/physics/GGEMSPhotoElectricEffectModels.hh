@@ -38,18 +38,16 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void StandardPhotoElectricSampleSecondaries(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id)
-  \param primary_particle - buffer of particles
-  \param particle_id - index of the particle
+  \fn inline void StandardPhotoElectricSampleSecondaries(GGEMSParticle* particle)
+  \param particle - state of the particle in private memory
   \brief Standard Photoelectric model
 */
 inline void StandardPhotoElectricSampleSecondaries(
-  global GGEMSPrimaryParticles* primary_particle,
-  GGint const particle_id
+  GGEMSParticle* particle
 )
 {
-  primary_particle->status_[particle_id] = DEAD;
-  primary_particle->E_[particle_id] = 0.0f;
+  particle->status_ = DEAD;
+  particle->E_ = 0.0f;
 }
 
 #endif
@@ -0,0 +1,150 @@
+#ifndef GUARD_GGEMS_PHYSICS_GGEMSPHYSICTABLESREGISTRY_HH
+#define GUARD_GGEMS_PHYSICS_GGEMSPHYSICTABLESREGISTRY_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSPhysicTablesRegistry.hh
+
+  \brief GGEMS singleton storing the physic tables built on OpenCL devices, a table is built once for a set of materials, processes and energy grid and shared by navigators
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4251) // Deleting warning exporting STL members!!!
+#endif
+
+#include <map>
+#include <string>
+
+#include "GGEMS/global/GGEMSOpenCLManager.hh"
+#include "GGEMS/tools/GGEMSChrono.hh"
+
+/*!
+  \struct GGEMSPhysicTable_t
+  \brief Physic table stored on each activated OpenCL device and number of navigators using it
+*/
+typedef struct GGEMSPhysicTable_t
+{
+  cl::Buffer** buffers_; /*!< Table on each activated OpenCL device */
+  GGsize size_; /*!< Size of table in bytes on a device */
+  GGsize number_of_users_; /*!< Number of navigators sharing the table */
+  DurationNano build_time_; /*!< Time spent to build the table on all devices */
+} GGEMSPhysicTable; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+typedef std::map<std::string, GGEMSPhysicTable> PhysicTableMap; /*!< Map with key : description of table (materials, processes, energy grid), value : table */
+
+/*!
+  \class GGEMSPhysicTablesRegistry
+  \brief GGEMS singleton storing the physic tables built on OpenCL devices, a table is built once for a set of materials, processes and energy grid and shared by navigators
+*/
+class GGEMS_EXPORT GGEMSPhysicTablesRegistry
+{
+  private:
+    /*!
+      \brief Unable the constructor for the user
+    */
+    GGEMSPhysicTablesRegistry(void);
+
+    /*!
+      \brief Unable the destructor for the user
+    */
+    ~GGEMSPhysicTablesRegistry(void);
+
+  public:
+    /*!
+      \fn static GGEMSPhysicTablesRegistry& GetInstance(void)
+      \brief Create at first time the Singleton
+      \return Object of type GGEMSPhysicTablesRegistry
+    */
+    static GGEMSPhysicTablesRegistry& GetInstance(void)
+    {
+      static GGEMSPhysicTablesRegistry instance;
+      return instance;
+    }
+
+    /*!
+      \fn GGEMSPhysicTablesRegistry(GGEMSPhysicTablesRegistry const& physic_tables_registry) = delete
+      \param physic_tables_registry - reference on the physic tables registry
+      \brief Avoid copy of the class by reference
+    */
+    GGEMSPhysicTablesRegistry(GGEMSPhysicTablesRegistry const& physic_tables_registry) = delete;
+
+    /*!
+      \fn GGEMSPhysicTablesRegistry& operator=(GGEMSPhysicTablesRegistry const& physic_tables_registry) = delete
+      \param physic_tables_registry - reference on the physic tables registry
+      \brief Avoid assignement of the class by reference
+    */
+    GGEMSPhysicTablesRegistry& operator=(GGEMSPhysicTablesRegistry const& physic_tables_registry) = delete;
+
+    /*!
+      \fn GGEMSPhysicTablesRegistry(GGEMSPhysicTablesRegistry const&& physic_tables_registry) = delete
+      \param physic_tables_registry - rvalue reference on the physic tables registry
+      \brief Avoid copy of the class by rvalue reference
+    */
+    GGEMSPhysicTablesRegistry(GGEMSPhysicTablesRegistry const&& physic_tables_registry) = delete;
+
+    /*!
+      \fn GGEMSPhysicTablesRegistry& operator=(GGEMSPhysicTablesRegistry const&& physic_tables_registry) = delete
+      \param physic_tables_registry - rvalue reference on the physic tables registry
+      \brief Avoid copy of the class by rvalue reference
+    */
+    GGEMSPhysicTablesRegistry& operator=(GGEMSPhysicTablesRegistry const&& physic_tables_registry) = delete;
+
+    /*!
+      \fn cl::Buffer** GetCrossSections(std::string const& key)
+      \param key - description of table (materials, processes, energy grid)
+      \return cross section tables on each activated device, nullptr if table is not built
+      \brief Get cross section tables already built, the caller is registered as a user of the tables
+    */
+    cl::Buffer** GetCrossSections(std::string const& key);
+
+    /*!
+      \fn void StoreCrossSections(std::string const& key, cl::Buffer** cross_sections, GGsize const& size, DurationNano const& build_time)
+      \param key - description of table (materials, processes, energy grid)
+      \param cross_sections - cross section tables on each activated device
+      \param size - size of table in bytes on a device
+      \param build_time - time spent to build the tables
+      \brief Store cross section tables built by a navigator, the registry owns the buffers
+    */
+    void StoreCrossSections(std::string const& key, cl::Buffer** cross_sections, GGsize const& size, DurationNano const& build_time);
+
+    /*!
+      \fn void ReleaseCrossSections(std::string const& key)
+      \param key - description of table (materials, processes, energy grid)
+      \brief Release cross section tables, buffers are deallocated when the last user releases them
+    */
+    void ReleaseCrossSections(std::string const& key);
+
+    /*!
+      \fn void PrintInfos(void) const
+      \brief Print shared tables, memory and initialization time compared to a table for each navigator
+    */
+    void PrintInfos(void) const;
+
+  private:
+    PhysicTableMap cross_sections_; /*!< Cross section tables */
+};
+
+#endif // End of GUARD_GGEMS_PHYSICS_GGEMSPHYSICTABLESREGISTRY_HH
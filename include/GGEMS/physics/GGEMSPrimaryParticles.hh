@@ -31,13 +31,17 @@
   \date Monday December 16, 2019
 */
 
+#ifndef __OPENCL_C_VERSION__
+#include <cstddef>
+#endif
+
 #include "GGEMS/global/GGEMSConfiguration.hh"
 #include "GGEMS/tools/GGEMSTypes.hh"
 #include "GGEMS/physics/GGEMSParticleConstants.hh"
 
 /*!
   \struct GGEMSPrimaryParticles_t
-  \brief Structure storing informations about primary particles
+  \brief Structure storing informations about primary particles. Members with a fixed size are stored first, the size of particle arrays (MAXIMUM_PARTICLES) is given to OpenCL compiler for each device, on host only the fixed part is accessed
 */
 typedef struct GGEMSPrimaryParticles_t
 {
@@ -63,10 +67,145 @@ typedef struct GGEMSPrimaryParticles_t
   GGchar level_[MAXIMUM_PARTICLES]; /*!< Level of the particle */
   GGchar pname_[MAXIMUM_PARTICLES]; /*!< particle name (photon, electron, etc) */
 
+  #ifdef PARTICLE_COMPACTION
+  GGint live_index_[MAXIMUM_PARTICLES]; /*!< Dense list of live particle indices, built by compaction stage */
+  #endif
+} GGEMSPrimaryParticles; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+/*!
+  \struct GGEMSParticleTrajectories_t
+  \brief Structure storing interactions of displayed primary particles for OpenGL, allocated only if OpenGL visualization is activated
+*/
+typedef struct GGEMSParticleTrajectories_t
+{
   GGfloat px_gl_[MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS]; /*!< Position in X of primary particles interactions */
   GGfloat py_gl_[MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS]; /*!< Position in Y of primary particles interactions */
   GGfloat pz_gl_[MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS]; /*!< Position in Z of primary particles interactions */
   GGint stored_particles_gl_[MAXIMUM_DISPLAYED_PARTICLES]; /*!< index to current interaction particle to store */
-} GGEMSPrimaryParticles; /*!< Using C convention name of struct to C++ (_t deletion) */
+} GGEMSParticleTrajectories; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+#ifdef __OPENCL_C_VERSION__
+#include "GGEMS/randoms/GGEMSKissEngine.hh"
+#ifdef PHILOX_RANDOM
+#include "GGEMS/randoms/GGEMSPhiloxEngine.hh"
+#endif
+
+/*!
+  \struct GGEMSParticle_t
+  \brief State of a single particle in private memory of a work-item, loaded once when a kernel starts and stored once when it ends
+*/
+typedef struct GGEMSParticle_t
+{
+  GGfloat3 position_; /*!< Position of the particle */
+  GGfloat3 direction_; /*!< Direction of the particle */
+  GGfloat E_; /*!< Energy of the particle */
+  GGint E_index_; /*!< Energy index within CS and Mat tables */
+  GGfloat next_interaction_distance_; /*!< Distance to the next interaction */
+  GGchar next_discrete_process_; /*!< Next process */
+  GGchar status_; /*!< Status of the particle */
+  GGchar scatter_; /*!< Index of scattered photon */
+  #ifdef GGEMS_TRACKING
+  GGchar is_tracked_; /*!< Particle is the tracked particle */
+  #endif
+  #ifdef PHILOX_RANDOM
+  GGEMSPhiloxState random_state_; /*!< Counter and key of Philox engine */
+  #endif
+} GGEMSParticle; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+/*!
+  \fn inline GGEMSParticle LoadParticle(global GGEMSPrimaryParticles const* primary_particle, global GGEMSRandom const* random, GGint const particle_id)
+  \param primary_particle - buffer of particles
+  \param random - pointer on random numbers
+  \param particle_id - index of the particle
+  \return state of the particle in private memory
+  \brief Load a particle from global memory, with the state of Philox engine
+*/
+inline GGEMSParticle LoadParticle(global GGEMSPrimaryParticles const* primary_particle, global GGEMSRandom const* random, GGint const particle_id)
+{
+  GGEMSParticle particle;
+
+  particle.position_ = (GGfloat3)(primary_particle->px_[particle_id], primary_particle->py_[particle_id], primary_particle->pz_[particle_id]);
+  particle.direction_ = (GGfloat3)(primary_particle->dx_[particle_id], primary_particle->dy_[particle_id], primary_particle->dz_[particle_id]);
+  particle.E_ = primary_particle->E_[particle_id];
+  particle.E_index_ = primary_particle->E_index_[particle_id];
+  particle.next_interaction_distance_ = primary_particle->next_interaction_distance_[particle_id];
+  particle.next_discrete_process_ = primary_particle->next_discrete_process_[particle_id];
+  particle.status_ = primary_particle->status_[particle_id];
+  particle.scatter_ = primary_particle->scatter_[particle_id];
+  #ifdef GGEMS_TRACKING
+  particle.is_tracked_ = particle_id == primary_particle->particle_tracking_id;
+  #endif
+  #ifdef PHILOX_RANDOM
+  particle.random_state_ = LoadPhiloxState(random, particle_id);
+  #endif
+
+  return particle;
+}
+
+/*!
+  \fn inline void StoreParticle(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGEMSParticle const* particle, GGint const particle_id)
+  \param primary_particle - buffer of particles
+  \param random - pointer on random numbers
+  \param particle - state of the particle in private memory
+  \param particle_id - index of the particle
+  \brief Store a particle in global memory, with the number of draws of Philox engine
+*/
+inline void StoreParticle(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGEMSParticle const* particle, GGint const particle_id)
+{
+  primary_particle->px_[particle_id] = particle->position_.x;
+  primary_particle->py_[particle_id] = particle->position_.y;
+  primary_particle->pz_[particle_id] = particle->position_.z;
+  primary_particle->dx_[particle_id] = particle->direction_.x;
+  primary_particle->dy_[particle_id] = particle->direction_.y;
+  primary_particle->dz_[particle_id] = particle->direction_.z;
+  primary_particle->E_[particle_id] = particle->E_;
+  primary_particle->E_index_[particle_id] = particle->E_index_;
+  primary_particle->next_interaction_distance_[particle_id] = particle->next_interaction_distance_;
+  primary_particle->next_discrete_process_[particle_id] = particle->next_discrete_process_;
+  primary_particle->status_[particle_id] = particle->status_;
+  primary_particle->scatter_[particle_id] = particle->scatter_;
+  #ifdef PHILOX_RANDOM
+  StorePhiloxState(random, &particle->random_state_, particle_id);
+  #endif
+}
+
+/*!
+  \fn inline GGfloat ParticleUniform(GGEMSParticle* particle, global GGEMSRandom* random, GGint const particle_id)
+  \param particle - state of the particle in private memory
+  \param random - pointer on random numbers
+  \param particle_id - index of the particle
+  \return Uniform random float number
+  \brief Draw a random number for a particle, from private state of Philox engine or from global states of JKISS engine
+*/
+inline GGfloat ParticleUniform(GGEMSParticle* particle, global GGEMSRandom* random, GGint const particle_id)
+{
+  #ifdef PHILOX_RANDOM
+  return PhiloxUniform(&particle->random_state_);
+  #else
+  return KissUniform(random, particle_id);
+  #endif
+}
+#else
+/*!
+  \fn inline GGsize GetPrimaryParticlesFixedSize(void)
+  \return size in bytes of members of GGEMSPrimaryParticles not depending on number of particles
+  \brief Get the size of the part of GGEMSPrimaryParticles accessed on host
+*/
+inline GGsize GetPrimaryParticlesFixedSize(void)
+{
+  return offsetof(GGEMSPrimaryParticles, E_);
+}
+
+/*!
+  \fn inline GGsize GetPrimaryParticlesSize(GGsize const& number_of_particles)
+  \param number_of_particles - number of particles in particle arrays
+  \return size in bytes of GGEMSPrimaryParticles compiled on OpenCL device for number_of_particles
+  \brief Get the size of GGEMSPrimaryParticles buffer, size per particle is deduced from host declaration
+*/
+inline GGsize GetPrimaryParticlesSize(GGsize const& number_of_particles)
+{
+  return GetPrimaryParticlesFixedSize() + (sizeof(GGEMSPrimaryParticles) - GetPrimaryParticlesFixedSize()) / MAXIMUM_PARTICLES * number_of_particles;
+}
+#endif
 
 #endif // GUARD_GGEMS_PHYSICS_GGEMSPRIMARYPARTICLESSTACK_HH
@@ -31,7 +31,8 @@
   \date Monday December 16, 2019
 */
 
-#ifdef __OPENCL_C_VERSION__
+// JKISS states are not stored if counter-based Philox engine is used
+#if defined(__OPENCL_C_VERSION__) && !defined(PHILOX_RANDOM)
 
 #include "GGEMS/randoms/GGEMSRandom.hh"
 #include "GGEMS/global/GGEMSConstants.hh"
@@ -0,0 +1,159 @@
+#ifndef GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
+#define GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSPhiloxEngine.hh
+
+  \brief Functions for counter-based pseudo random number generator using Philox4x32-10 engine. This functions can be used only by an OpenCL kernel
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#ifdef __OPENCL_C_VERSION__
+
+#include "GGEMS/randoms/GGEMSRandom.hh"
+
+#define PHILOX_M4x32_0 0xD2511F53u /*!< First multiplier of Philox4x32 round */
+#define PHILOX_M4x32_1 0xCD9E8D57u /*!< Second multiplier of Philox4x32 round */
+#define PHILOX_W32_0 0x9E3779B9u /*!< First Weyl constant bumping the key */
+#define PHILOX_W32_1 0xBB67AE85u /*!< Second Weyl constant bumping the key */
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGuint4 Philox4x32(GGuint4 counter, GGuint2 key)
+  \param counter - 128 bits counter
+  \param key - 64 bits key
+  \return 4 random 32 bits integers
+  \brief Philox4x32-10 bijection (Salmon et al., Random123), passes the BigCrush tests in TestU01
+*/
+inline GGuint4 Philox4x32(GGuint4 counter, GGuint2 key)
+{
+  for (GGint i = 0; i < 10; ++i) {
+    GGuint hi_0 = mul_hi(PHILOX_M4x32_0, counter.x);
+    GGuint lo_0 = PHILOX_M4x32_0 * counter.x;
+    GGuint hi_1 = mul_hi(PHILOX_M4x32_1, counter.z);
+    GGuint lo_1 = PHILOX_M4x32_1 * counter.z;
+
+    counter = (GGuint4)(hi_1 ^ counter.y ^ key.x, lo_1, hi_0 ^ counter.w ^ key.y, lo_0);
+
+    key.x += PHILOX_W32_0;
+    key.y += PHILOX_W32_1;
+  }
+
+  return counter;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \struct GGEMSPhiloxState_t
+  \brief Counter and key of Philox engine for a particle, with outputs of the current block not drawn yet, in private memory of a work-item
+*/
+typedef struct GGEMSPhiloxState_t
+{
+  GGuint4 counter_; /*!< Number of draws and index of particle in source, a Philox block gives the 4 next draws */
+  GGuint2 key_; /*!< Seed and source index */
+  GGuint4 output_; /*!< Outputs of current Philox block, next draw in first lane */
+  GGchar is_output_; /*!< Flag checking if current block is computed, not stored between kernels */
+} GGEMSPhiloxState; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGEMSPhiloxState LoadPhiloxState(global GGEMSRandom const* random, GGint const index)
+  \param random - pointer on random buffer on OpenCL device
+  \param index - index of thread
+  \return state of Philox engine in private memory
+  \brief Load the number of draws of a particle and the key of the batch from global memory
+*/
+inline GGEMSPhiloxState LoadPhiloxState(global GGEMSRandom const* random, GGint const index)
+{
+  GGsize particle_index = random->first_particle_ + index;
+
+  GGEMSPhiloxState state;
+  state.counter_ = (GGuint4)(random->counter_[index], (GGuint)(particle_index & 0xffffffffu), (GGuint)(particle_index >> 32), 0);
+  state.key_ = (GGuint2)(random->key_[0], random->key_[1]);
+  state.is_output_ = 0;
+
+  return state;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void StorePhiloxState(global GGEMSRandom* random, GGEMSPhiloxState const* state, GGint const index)
+  \param random - pointer on random buffer on OpenCL device
+  \param state - state of Philox engine in private memory
+  \param index - index of thread
+  \brief Store the number of draws of a particle in global memory
+*/
+inline void StorePhiloxState(global GGEMSRandom* random, GGEMSPhiloxState const* state, GGint const index)
+{
+  random->counter_[index] = state->counter_.x;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat PhiloxUniform(GGEMSPhiloxState* state)
+  \param state - state of Philox engine in private memory
+  \return Uniform random float number in ]0;1[
+  \brief Draw a random number from counter (draw, particle index in source) and key (seed, source), without global memory access. Draw d is the lane d%4 of the Philox block d/4, so a block is computed once every 4 draws
+*/
+inline GGfloat PhiloxUniform(GGEMSPhiloxState* state)
+{
+  GGuint lane = state->counter_.x & 3u;
+
+  // New block every 4 draws, or at first draw of a kernel when previous kernel stopped inside a block
+  if (lane == 0u || !state->is_output_) {
+    state->output_ = Philox4x32((GGuint4)(state->counter_.x >> 2, state->counter_.y, state->counter_.z, state->counter_.w), state->key_);
+    state->is_output_ = 1;
+
+    // Skipping outputs drawn by previous kernel
+    for (GGuint i = 0; i < lane; ++i) state->output_ = state->output_.yzwx;
+  }
+
+  GGuint value = state->output_.x;
+  state->output_ = state->output_.yzwx;
+  state->counter_.x += 1;
+
+  // 23 bits of mantissa, centered in bin to exclude 0 and 1
+  return ((GGfloat)(value >> 9) + 0.5f) * (1.0f / 8388608.0f);
+}
+
+#endif
+
+#endif // End of GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
@@ -108,6 +108,32 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
     */
     inline cl::Buffer* GetPseudoRandomNumbers(GGsize const& thread_index) const {return pseudo_random_numbers_[thread_index];}
 
+    /*!
+      \fn inline cl::Buffer* GetNextPseudoRandomNumbers(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return pointer to OpenCL buffer storing random numbers of next batch
+      \brief return the pointer to OpenCL buffer storing random numbers of batch generated during transport of current batch
+    */
+    inline cl::Buffer* GetNextPseudoRandomNumbers(GGsize const& thread_index) const {return next_pseudo_random_numbers_[thread_index];}
+
+    /*!
+      \fn void SwapBuffers(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief random numbers of next batch become the random numbers of transported particles
+    */
+    void SwapBuffers(GGsize const& thread_index);
+
+    /*!
+      \fn cl::Event InitializeBatch(GGsize const& thread_index, GGsize const& source_index, GGsize const& first_particle, GGsize const& number_of_particles) const
+      \param thread_index - index of activated device (thread index)
+      \param source_index - index of the source
+      \param first_particle - index of first particle of batch in source
+      \param number_of_particles - number of particles in batch
+      \return OpenCL event of initialization
+      \brief set a deterministic random substream for each particle of next batch, depending only on seed, source and particle index, enqueued on generation command queue
+    */
+    cl::Event InitializeBatch(GGsize const& thread_index, GGsize const& source_index, GGsize const& first_particle, GGsize const& number_of_particles) const;
+
   private:
     /*!
       \fn void AllocateRandom(void)
@@ -116,10 +142,10 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
     void AllocateRandom(void);
 
     /*!
-      \fn void InitializeSeeds(void)
-      \brief Initialize seeds for random
+      \fn void InitializeKernel(void)
+      \brief Initialize kernel setting random substream of a batch
     */
-    void InitializeSeeds(void);
+    void InitializeKernel(void);
 
     /*!
       \fn GGuint GenerateSeed(void) const
@@ -130,8 +156,10 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
 
   private:
     cl::Buffer** pseudo_random_numbers_; /*!< Pointer storing the buffer about random numbers in activated device */
+    cl::Buffer** next_pseudo_random_numbers_; /*!< Pointer storing the buffer about random numbers of next batch in activated device */
     GGsize number_activated_devices_; /*!< Number of activated device */
     GGuint seed_; /*!< Initial seed generating state of GGEMS random */
+    cl::Kernel** kernel_initialize_batch_random_; /*!< Kernel setting random substream of a batch */
 };
 
 #endif // End of GUARD_GGEMS_RANDOMS_PSEUDO_RANDOM_GENERATOR_HH
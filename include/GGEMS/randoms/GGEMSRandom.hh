@@ -31,20 +31,47 @@
   \date Monday December 16, 2019
 */
 
+#ifndef __OPENCL_C_VERSION__
+#include <cstddef>
+#endif
+
 #include "GGEMS/global/GGEMSConfiguration.hh"
 #include "GGEMS/tools/GGEMSTypes.hh"
 
 /*!
   \struct GGEMSRandom_t
-  \brief Structure storing informations about random
+  \brief Structure storing informations about random, the size of state arrays (MAXIMUM_PARTICLES) is given to OpenCL compiler for each device
 */
 typedef struct GGEMSRandom_t
 {
+  #ifdef PHILOX_RANDOM
+  GGsize first_particle_; /*!< Index in source of first particle of batch */
+  GGuint key_[2]; /*!< Key of Philox engine, seed and source index */
+  GGuint counter_[MAXIMUM_PARTICLES]; /*!< Number of draws of each particle */
+  #else
   GGuint prng_state_1_[MAXIMUM_PARTICLES]; /*!< State 1 of the prng */
   GGuint prng_state_2_[MAXIMUM_PARTICLES]; /*!< State 2 of the prng */
   GGuint prng_state_3_[MAXIMUM_PARTICLES]; /*!< State 3 of the prng */
   GGuint prng_state_4_[MAXIMUM_PARTICLES]; /*!< State 4 of the prng */
   GGuint prng_state_5_[MAXIMUM_PARTICLES]; /*!< State 5 of the prng */
+  #endif
 } GGEMSRandom; /*!< Using C convention name of struct to C++ (_t deletion) */
 
+#ifndef __OPENCL_C_VERSION__
+/*!
+  \fn inline GGsize GetRandomSize(GGsize const& number_of_particles)
+  \param number_of_particles - number of particles in random state arrays
+  \return size in bytes of GGEMSRandom compiled on OpenCL device for number_of_particles
+  \brief Get the size of GGEMSRandom buffer, states are 5 contiguous arrays of GGuint for JKISS, or a key and a draw counter by particle for Philox
+*/
+inline GGsize GetRandomSize(GGsize const& number_of_particles)
+{
+  #ifdef PHILOX_RANDOM
+  return offsetof(GGEMSRandom, counter_) + sizeof(GGuint) * number_of_particles;
+  #else
+  return 5 * sizeof(GGuint) * number_of_particles;
+  #endif
+}
+#endif
+
 #endif // End of GUARD_GGEMS_RANDOMS_GGEMSRANDOM_HH
@@ -130,14 +130,6 @@ class GGEMS_EXPORT GGEMSSource
     */
     void EnableTracking(void);
 
-    /*!
-      \fn inline GGsize GetNumberOfBatchs(GGsize const& device_index) const
-      \param device_index - index of activated device
-      \return the number of batch of particle
-      \brief method returning the number of particles by batch
-    */
-    inline GGsize GetNumberOfBatchs(GGsize const& device_index) const {return number_of_batchs_[device_index];}
-
     /*!
       \fn inline GGsize GetNumberOfParticles(void) const
       \return the number of simulated particles
@@ -145,15 +137,6 @@ class GGEMS_EXPORT GGEMSSource
     */
     inline GGsize GetNumberOfParticles(void) const {return number_of_particles_;}
 
-    /*!
-      \fn inline GGulong GetNumberOfParticlesInBatch(GGsize const& device_index, GGsize const& batch_index)
-      \param device_index - index of activated device
-      \param batch_index - index of the batch
-      \return the number of particle for a specific batch
-      \brief method returning the number of particles in a specific batch
-    */
-    inline GGsize GetNumberOfParticlesInBatch(GGsize const& device_index, GGsize const& batch_index) {return number_of_particles_in_batch_[device_index][batch_index];}
-
     /*!
       \fn void CheckParameters(void) const
       \brief Check mandatory parameters for a source
@@ -171,7 +154,7 @@ class GGEMS_EXPORT GGEMSSource
       \fn void GetPrimaries(GGsize const& thread_index, GGsize const& number_of particles) = 0
       \param thread_index - index of activated device (thread index)
       \param number_of_particles - number of particles to generate
-      \brief Generate primary particles
+      \brief Generate primary particles in buffer of next batch, enqueued without blocking on generation command queue
     */
     virtual void GetPrimaries(GGsize const& thread_index, GGsize const& number_of_particles) = 0;
 
@@ -188,20 +171,9 @@ class GGEMS_EXPORT GGEMSSource
     */
     virtual void InitializeKernel(void) = 0;
 
-  private:
-    /*!
-      \fn void OrganizeParticlesInBatch
-      \brief Organize the particles in batch
-    */
-    void OrganizeParticlesInBatch(void);
-
   protected:
     std::string source_name_; /*!< Name of the source */
     GGsize number_of_particles_; /*!< Number of particles */
-    GGsize* number_of_particles_by_device_; /*!< Number of particles by device */
-
-    GGsize** number_of_particles_in_batch_; /*!< Number of particles in batch for each device */
-    GGsize* number_of_batchs_; /*!< Number of batchs for each device */
 
     GGchar particle_type_; /*!< Type of particle: photon, electron or positron */
     std::string tracking_kernel_option_; /*!< Preprocessor option for tracking */
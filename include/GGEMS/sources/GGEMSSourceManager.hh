@@ -38,6 +38,7 @@
 #include "GGEMS/sources/GGEMSSource.hh"
 
 #include "GGEMS/physics/GGEMSParticles.hh"
+#include "GGEMS/tools/GGEMSChrono.hh"
 
 class GGEMSPseudoRandomGenerator;
 
@@ -119,13 +120,13 @@ class GGEMS_EXPORT GGEMSSourceManager
     inline GGsize GetNumberOfSources(void) const {return number_of_sources_;}
 
     /*!
-      \fn void Initialize(GGuint const& seed, bool const& is_tracking = false, GGint const& particle_tracking_id = 0) const
+      \fn void Initialize(GGuint const& seed, bool const& is_tracking = false, GGint const& particle_tracking_id = 0)
       \param seed - seed of the random
       \param is_tracking - boolean value for tracking
       \param particle_tracking_id - id of particle to track
       \brief Initialize a GGEMS source
     */
-    void Initialize(GGuint const& seed, bool const& is_tracking = false, GGint const& particle_tracking_id = 0) const;
+    void Initialize(GGuint const& seed, bool const& is_tracking = false, GGint const& particle_tracking_id = 0);
 
     /*!
       \fn inline std::string GetNameOfSource(GGsize const& source_index) const
@@ -136,30 +137,31 @@ class GGEMS_EXPORT GGEMSSourceManager
     inline std::string GetNameOfSource(GGsize const& source_index) const {return sources_[source_index]->GetNameOfSource();}
 
     /*!
-      \fn inline GGsize GetNumberOfBatchs(GGsize const& source_index, GGsize const& thread_index) const
-      \param source_index - index of the source
-      \param thread_index - index of activated device (thread index)
-      \return the number of batch of particle
-      \brief method returning the number of particles by batch
+      \fn GGsize GetTotalNumberOfParticles(void) const
+      \return total number of particles for whole simulation
+      \brief compute the total number of particles of all sources
     */
-    inline GGsize GetNumberOfBatchs(GGsize const& source_index, GGsize const& thread_index) const {return sources_[source_index]->GetNumberOfBatchs(thread_index);}
+    GGsize GetTotalNumberOfParticles(void) const;
 
     /*!
-      \fn GGsize GetTotalNumberOfBatchs(void) const
-      \return total number of batch for whole simulation
-      \brief computhe the total number of batchs
+      \fn bool GetNextBatch(GGsize const& source_index, GGsize const& thread_index, GGsize& first_particle, GGsize& number_of_particles)
+      \param source_index - index of the source
+      \param thread_index - index of activated device (thread index)
+      \param first_particle - index of first particle of batch in source
+      \param number_of_particles - number of particles in batch
+      \return false if all particles of source are already simulated
+      \brief pull the next batch of a source from queue shared by all devices, size of batch depends on measured throughput of device
     */
-    GGsize GetTotalNumberOfBatchs(void) const;
+    bool GetNextBatch(GGsize const& source_index, GGsize const& thread_index, GGsize& first_particle, GGsize& number_of_particles);
 
     /*!
-      \fn inline GGsize GetNumberOfParticlesInBatch(GGsize const& source_index, GGsize const& thread_index, GGsize const& batch_index)
-      \param source_index - index of the source
+      \fn void UpdateDeviceThroughput(GGsize const& thread_index, GGsize const& number_of_particles, DurationNano const& elapsed_time)
       \param thread_index - index of activated device (thread index)
-      \param batch_index - index of the source
-      \return the number of particle for a specific batch
-      \brief method returning the number of particles in a specific batch
+      \param number_of_particles - number of particles simulated in batch
+      \param elapsed_time - time to simulate the batch
+      \brief update the throughput of a device used to compute size of next batchs
     */
-    inline GGsize GetNumberOfParticlesInBatch(GGsize const& source_index, GGsize const& thread_index, GGsize const& batch_index) {return sources_[source_index]->GetNumberOfParticlesInBatch(thread_index, batch_index);}
+    void UpdateDeviceThroughput(GGsize const& thread_index, GGsize const& number_of_particles, DurationNano const& elapsed_time);
 
     /*!
       \fn inline GGsize GetNumberOfParticles(GGsize const& source_index) const
@@ -187,17 +189,28 @@ class GGEMS_EXPORT GGEMSSourceManager
     inline GGEMSPseudoRandomGenerator* GetPseudoRandomGenerator(void) const {return pseudo_random_generator_;}
 
     /*!
-      \fn void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles) const
+      \fn void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& first_particle, GGsize const& number_of_particles)
       \param source_index - index of the source
       \param thread_index - index of activated device (thread index)
+      \param first_particle - index of first particle of batch in source
       \param number_of_particles - number of particles to simulate
-      \brief Generate primary particles for a specific source
+      \brief Generate primary particles for a specific source in buffers of next batch, without blocking, in same time as transport of current batch
     */
-    inline void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles) const
-    {
-      particles_->SetNumberOfParticles(thread_index, number_of_particles);
-      sources_[source_index]->GetPrimaries(thread_index, number_of_particles);
-    }
+    void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& first_particle, GGsize const& number_of_particles);
+
+    /*!
+      \fn void SwapParticleBuffers(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief wait for generation of next batch, then particles of next batch become the transported particles. Overlap between generation and transport is sent to profiler
+    */
+    void SwapParticleBuffers(GGsize const& thread_index);
+
+    /*!
+      \fn void EnqueueAliveCount(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \brief enqueue counting of alive particles without blocking host
+    */
+    void EnqueueAliveCount(GGsize const& thread_index) const;
 
     /*!
       \fn bool IsAlive(GGsize const& thread_index) const
@@ -213,11 +226,32 @@ class GGEMS_EXPORT GGEMSSourceManager
     */
     void Clean(void);
 
+  private:
+    /*!
+      \fn void InitializeBatchQueue(void)
+      \brief initialize the batch queue shared by all devices
+    */
+    void InitializeBatchQueue(void);
+
   private: // Source infos
     GGEMSSource** sources_; /*!< Pointer on GGEMS sources */
     GGsize number_of_sources_; /*!< Number of sources */
     GGEMSParticles* particles_; /*!< Pointer on particle management */
     GGEMSPseudoRandomGenerator* pseudo_random_generator_; /*!< Pointer on pseudo random generator */
+
+  private: // Batch queue
+    GGsize number_activated_devices_; /*!< Number of activated device */
+    GGsize* next_particle_; /*!< Index of next particle to simulate for each source */
+    GGdouble* initial_device_share_; /*!< Share of particles for each device before throughput measurement */
+    GGdouble* device_throughput_; /*!< Measured number of particles per second for each device */
+
+  private: // Double buffering of particles
+    GGsize* next_number_of_particles_; /*!< Number of particles of next batch for each device */
+    cl::Event* generation_start_event_; /*!< Event starting generation of next batch for each device */
+    cl::Event* generation_end_event_; /*!< Event ending generation of next batch for each device */
+    cl::Event* transport_start_event_; /*!< Event starting transport of current batch for each device */
+    cl::Event* transport_end_event_; /*!< Event ending transport of previous batch for each device, generation waits for it before writing in its buffers */
+    bool* is_transport_started_; /*!< Flag checking if a batch was already transported by device */
 };
 
 /*!
@@ -39,6 +39,8 @@
 #include "GGEMS/tools/GGEMSProfiler.hh"
 
 typedef std::unordered_map<std::string, GGEMSProfiler> ProfilerUMap; /*!< Unordered map with key : name of profile, profile object */
+typedef std::unordered_map<std::string, GGsize> SavedLaunchesUMap; /*!< Unordered map with key : name of profile, number of saved kernel launches */
+typedef std::unordered_map<std::string, std::pair<DurationNano, DurationNano>> OverlapUMap; /*!< Unordered map with key : name of profile, overlapped time and total time */
 
 /*!
   \class GGEMSProfilerManager
@@ -105,6 +107,23 @@ class GGEMS_EXPORT GGEMSProfilerManager
     */
     void HandleEvent(cl::Event event, std::string const& profile_name);
 
+    /*!
+      \fn void AddSavedKernelLaunches(std::string const& profile_name, GGsize const& number_of_launches)
+      \param profile_name - type of profile
+      \param number_of_launches - number of kernel launches avoided
+      \brief count kernel launches avoided by a batched kernel in profile_name type
+    */
+    void AddSavedKernelLaunches(std::string const& profile_name, GGsize const& number_of_launches);
+
+    /*!
+      \fn void AddOverlapTime(std::string const& profile_name, DurationNano const& overlapped_time, DurationNano const& total_time)
+      \param profile_name - type of profile
+      \param overlapped_time - time of operation running in same time as another command queue
+      \param total_time - total time of operation
+      \brief measure overlap between two command queues in profile_name type
+    */
+    void AddOverlapTime(std::string const& profile_name, DurationNano const& overlapped_time, DurationNano const& total_time);
+
     /*!
       \fn void PrintSummaryProfile(void) const
       \brief print summary profile
@@ -125,6 +144,8 @@ class GGEMS_EXPORT GGEMSProfilerManager
 
   private:
     ProfilerUMap profilers_; /*!< Map storing all types of profiles */
+    SavedLaunchesUMap saved_launches_; /*!< Map storing number of kernel launches avoided for each type of profile */
+    OverlapUMap overlaps_; /*!< Map storing overlapped time and total time for each type of profile */
 };
 
 /*!
@@ -94,13 +94,6 @@ class GGEMS_EXPORT GGEMSProgressBar
     */
     GGEMSProgressBar& operator++(void);
 
-  private:
-    /*!
-      \fn void DisplayTic(void)
-      \brief Display the tics
-    */
-    void DisplayTic(void);
-
     /*!
       \fn GGEMSProgressBar& operator+=(GGsize const& increment)
       \param increment - counter for the tic
@@ -109,6 +102,13 @@ class GGEMS_EXPORT GGEMSProgressBar
     */
     GGEMSProgressBar& operator+=(GGsize const& increment);
 
+  private:
+    /*!
+      \fn void DisplayTic(void)
+      \brief Display the tics
+    */
+    void DisplayTic(void);
+
   private:
     GGsize expected_count_; /*!< Expected number of the tics '*' */
     GGsize count_; /*!< Count of the tics '*' */
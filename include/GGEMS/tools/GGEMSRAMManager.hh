@@ -119,6 +119,18 @@ class GGEMS_EXPORT GGEMSRAMManager
       else return false;
     }
 
+    /*!
+      \fn inline GGsize GetAvailableRAMMemory(GGsize const& index) const
+      \param index - index of device
+      \return available RAM memory in bytes on device
+      \brief Get RAM memory not allocated by GGEMS on device
+    */
+    inline GGsize GetAvailableRAMMemory(GGsize const& index) const
+    {
+      if (allocated_ram_[index] < max_available_ram_[index]) return max_available_ram_[index] - allocated_ram_[index];
+      else return 0;
+    }
+
     /*!
       \fn inline bool IsBufferSizeCorrect(GGsize const& index, GGsize const& size) const
       \param index - index of device
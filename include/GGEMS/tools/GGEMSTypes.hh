@@ -139,6 +139,19 @@
 #define GGDosiType GGfloat /*!< define GGDositype as a float, useful for dosimetry computation */
 #endif
 
+#ifdef DOSE_FIXED_POINT
+#define GGEdepType GGulong /*!< define GGEdepType as a number of energy quanta, sums of integers do not depend on order of deposits */
+
+#if defined(cl_khr_int64_base_atomics)
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#else
+#error "Int64 atomic operation not available on your OpenCL device!!! Please deactivate fixed-point dose scoring."
+#endif
+
+#else
+#define GGEdepType GGDosiType /*!< define GGEdepType as GGDosiType, energy deposits are summed in floating point */
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
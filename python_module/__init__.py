@@ -73,9 +73,21 @@ class GGEMS(object):
         ggems_lib.set_tracking_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_int]
         ggems_lib.set_tracking_ggems.restype = ctypes.c_void_p
 
+        ggems_lib.set_alive_check_period_ggems.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.set_alive_check_period_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_async_output_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_async_output_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.wait_output_ggems.argtypes = [ctypes.c_void_p]
+        ggems_lib.wait_output_ggems.restype = ctypes.c_void_p
+
         ggems_lib.run_ggems.argtypes = [ctypes.c_void_p]
         ggems_lib.run_ggems.restype = ctypes.c_void_p
 
+        ggems_lib.benchmark_find_solid_ggems.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.benchmark_find_solid_ggems.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.create_ggems()
 
     def delete(self):
@@ -117,6 +129,18 @@ class GGEMS(object):
     def tracking_verbose(self, flag, particle_id):
         ggems_lib.set_tracking_ggems(self.obj, flag, particle_id)
 
+    def alive_check_period(self, period):
+        ggems_lib.set_alive_check_period_ggems(self.obj, period)
+
+    def async_output(self, flag):
+        ggems_lib.set_async_output_ggems(self.obj, flag)
+
+    def wait_output(self):
+        ggems_lib.wait_output_ggems(self.obj)
+
+    def benchmark_find_solid(self, number_of_rays):
+        ggems_lib.benchmark_find_solid_ggems(self.obj, number_of_rays)
+
 
 def clean_safely():
     GGEMSOpenCLManager().clean()
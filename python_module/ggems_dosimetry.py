@@ -48,6 +48,15 @@ class GGEMSDosimetryCalculator(object):
         ggems_lib.dose_tle_navigator.argtypes = [ctypes.c_void_p, ctypes.c_bool]
         ggems_lib.dose_tle_navigator.restype = ctypes.c_void_p
 
+        ggems_lib.scoring_backend_dosimetry_calculator.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t]
+        ggems_lib.scoring_backend_dosimetry_calculator.restype = ctypes.c_void_p
+
+        ggems_lib.fixed_point_scoring_dosimetry_calculator.argtypes = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_float, ctypes.c_char_p]
+        ggems_lib.fixed_point_scoring_dosimetry_calculator.restype = ctypes.c_void_p
+
+        ggems_lib.benchmark_scoring_dosimetry_calculator.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.benchmark_scoring_dosimetry_calculator.restype = ctypes.c_void_p
+
         ggems_lib.delete_dosimetry_calculator.argtypes = [ctypes.c_void_p]
         ggems_lib.delete_dosimetry_calculator.restype = ctypes.c_void_p
 
@@ -92,6 +101,15 @@ class GGEMSDosimetryCalculator(object):
     def set_tle(self, activate):
         ggems_lib.dose_tle_navigator(self.obj, activate)
 
+    def set_scoring_backend(self, backend, number_of_replicas=8):
+        ggems_lib.scoring_backend_dosimetry_calculator(self.obj, backend.encode('ASCII'), number_of_replicas)
+
+    def set_fixed_point_scoring(self, activate, quantum=1.0, unit='eV'):
+        ggems_lib.fixed_point_scoring_dosimetry_calculator(self.obj, activate, quantum, unit.encode('ASCII'))
+
+    def benchmark_scoring(self, number_of_deposits):
+        ggems_lib.benchmark_scoring_dosimetry_calculator(self.obj, number_of_deposits)
+
     def scale_factor(self, scale):
         ggems_lib.scale_factor_dosimetry_calculator(self.obj, scale)
 
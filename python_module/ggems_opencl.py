@@ -39,6 +39,24 @@ class GGEMSOpenCLManager(object):
         ggems_lib.set_device_balancing_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
         ggems_lib.set_device_balancing_opencl_manager.restype = ctypes.c_void_p
 
+        ggems_lib.set_particle_stack_size_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.set_particle_stack_size_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.set_blocking_stages_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_blocking_stages_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.set_kernel_binary_cache_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_kernel_binary_cache_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.set_kernel_binary_cache_path_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        ggems_lib.set_kernel_binary_cache_path_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.invalidate_kernel_binary_cache_opencl_manager.argtypes = [ctypes.c_void_p]
+        ggems_lib.invalidate_kernel_binary_cache_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.print_kernel_binary_cache_statistics_opencl_manager.argtypes = [ctypes.c_void_p]
+        ggems_lib.print_kernel_binary_cache_statistics_opencl_manager.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.get_instance_ggems_opencl_manager()
 
     def print_infos(self):
@@ -53,5 +71,23 @@ class GGEMSOpenCLManager(object):
     def set_device_balancing(self, device_balancing):
         ggems_lib.set_device_balancing_opencl_manager(self.obj, device_balancing.encode('ASCII'))
 
+    def set_particle_stack_size(self, particle_stack_size):
+        ggems_lib.set_particle_stack_size_opencl_manager(self.obj, particle_stack_size)
+
+    def set_blocking_stages(self, flag):
+        ggems_lib.set_blocking_stages_opencl_manager(self.obj, flag)
+
+    def set_kernel_binary_cache(self, flag):
+        ggems_lib.set_kernel_binary_cache_opencl_manager(self.obj, flag)
+
+    def set_kernel_binary_cache_path(self, path):
+        ggems_lib.set_kernel_binary_cache_path_opencl_manager(self.obj, path.encode('ASCII'))
+
+    def invalidate_kernel_binary_cache(self):
+        ggems_lib.invalidate_kernel_binary_cache_opencl_manager(self.obj)
+
+    def print_kernel_binary_cache_statistics(self):
+        ggems_lib.print_kernel_binary_cache_statistics_opencl_manager(self.obj)
+
     def clean(self):
         ggems_lib.clean_opencl_manager(self.obj)
@@ -45,6 +45,18 @@ class GGEMSVoxelizedPhantom(object):
         ggems_lib.set_rotation_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_float, ctypes.c_float, ctypes.c_char_p]
         ggems_lib.set_rotation_ggems_voxelized_phantom.restype = ctypes.c_void_p
 
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
+        ggems_lib.set_label_layout_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        ggems_lib.set_label_layout_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
+        ggems_lib.benchmark_label_layouts_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.benchmark_label_layouts_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
+        ggems_lib.benchmark_label_conversion_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.benchmark_label_conversion_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.create_ggems_voxelized_phantom(voxelized_phantom_name.encode('ASCII'))
 
     def set_phantom(self, phantom_filename, range_data_filename):
@@ -68,6 +80,18 @@ class GGEMSVoxelizedPhantom(object):
     def set_rotation(self, rx, ry, rz, unit):
         ggems_lib.set_rotation_ggems_voxelized_phantom(self.obj, rx, ry, rz, unit.encode('ASCII'))
 
+    def set_woodcock_tracking(self, flag):
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom(self.obj, flag)
+
+    def set_label_layout(self, label_layout):
+        ggems_lib.set_label_layout_ggems_voxelized_phantom(self.obj, label_layout.encode('ASCII'))
+
+    def benchmark_label_layouts(self, number_of_rays):
+        ggems_lib.benchmark_label_layouts_ggems_voxelized_phantom(self.obj, number_of_rays)
+
+    def benchmark_label_conversion(self, number_of_slices):
+        ggems_lib.benchmark_label_conversion_ggems_voxelized_phantom(self.obj, number_of_slices)
+
 
 class GGEMSWorld(object):
     """Class for world volume for GGEMS simulation
@@ -37,6 +37,9 @@ class GGEMSCrossSections(object):
         ggems_lib.clean_ggems_cross_sections.argtypes = [ctypes.c_void_p]
         ggems_lib.clean_ggems_cross_sections.restype = ctypes.c_void_p
 
+        ggems_lib.benchmark_energy_bin_lookup_ggems_cross_sections.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.benchmark_energy_bin_lookup_ggems_cross_sections.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.create_ggems_cross_sections(materials.obj)
 
     def add_process(self, process_name, particle_name, is_secondary=False):
@@ -51,6 +54,9 @@ class GGEMSCrossSections(object):
     def get_cs(self, process_name, material_name, energy, unit):
         return ggems_lib.get_cs_ggems_cross_sections(self.obj, process_name.encode('ASCII'), material_name.encode('ASCII'), energy, unit.encode('ASCII'))
 
+    def benchmark_energy_bin_lookup(self, number_of_lookups):
+        ggems_lib.benchmark_energy_bin_lookup_ggems_cross_sections(self.obj, number_of_lookups)
+
 
 class GGEMSRangeCutsManager(object):
     """Class managing the range cuts in GGEMS
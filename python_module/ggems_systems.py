@@ -72,6 +72,9 @@ class GGEMSCTSystem(object):
         ggems_lib.store_scatter_ggems_ct_system.argtypes = [ctypes.c_void_p, ctypes.c_bool]
         ggems_lib.store_scatter_ggems_ct_system.restype = ctypes.c_void_p
 
+        ggems_lib.set_multi_solid_navigation_ggems_ct_system.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_multi_solid_navigation_ggems_ct_system.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.create_ggems_ct_system(ct_system_name.encode('ASCII'))
 
     def set_number_of_modules(self, module_x, module_y):
@@ -121,3 +124,6 @@ class GGEMSCTSystem(object):
 
     def store_scatter(self, flag):
         ggems_lib.store_scatter_ggems_ct_system(self.obj, flag)
+
+    def set_multi_solid_navigation(self, flag):
+        ggems_lib.set_multi_solid_navigation_ggems_ct_system(self.obj, flag)
@@ -42,7 +42,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 GGEMSSolid::GGEMSSolid(void)
-: number_of_voxels_(0), 
+: number_of_voxels_(0),
+  label_data_size_(0),
   kernel_option_("")
 {
   GGcout("GGEMSSolid", "GGEMSSolid", 3) << "GGEMSSolid creating..." << GGendl;
@@ -63,6 +64,7 @@ GGEMSSolid::GGEMSSolid(void)
   kernel_track_through_solid_ = new cl::Kernel*[number_activated_devices_];
 
   is_scatter_ = false;
+  histogram_.is_local_ = false;
 
   #ifdef OPENGL_VISUALIZATION
   opengl_solid_ = nullptr;
@@ -103,7 +105,7 @@ GGEMSSolid::~GGEMSSolid(void)
 
   if (label_data_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(label_data_[i], number_of_voxels_*sizeof(GGuchar), i);
+      opencl_manager.Deallocate(label_data_[i], label_data_size_*sizeof(GGuchar), i);
     }
     delete[] label_data_;
     label_data_ = nullptr;
@@ -135,7 +137,7 @@ void GGEMSSolid::EnableTracking(void)
 
 void GGEMSSolid::AddKernelOption(std::string const& option)
 {
-  kernel_option_ += " -DTLE";
+  kernel_option_ += option;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -182,10 +182,16 @@ void GGEMSSolidBox::InitializeKernel(void)
   std::string project_to_filename = openCL_kernel_path + "/ProjectToGGEMSSolidBox.cl";
   std::string track_through_filename = openCL_kernel_path + "/TrackThroughGGEMSSolidBox.cl";
 
+  // Histogram counted in local memory if histogram (and scatter histogram) of the module fit in local memory
+  std::string track_through_option = kernel_option_;
+  GGsize local_histogram_size = histogram_.number_of_elements_*sizeof(GGint)*(is_scatter_ ? 2 : 1);
+  histogram_.is_local_ = data_reg_type_ == "HISTOGRAM" && opencl_manager.IsLocalMemoryFitting(local_histogram_size);
+  if (histogram_.is_local_) track_through_option += " -DLOCAL_HISTOGRAM";
+
   // Compiling the kernels
   opencl_manager.CompileKernel(particle_solid_distance_filename, "particle_solid_distance_ggems_solid_box", kernel_particle_solid_distance_, nullptr, const_cast<char*>(kernel_option_.c_str()));
   opencl_manager.CompileKernel(project_to_filename, "project_to_ggems_solid_box", kernel_project_to_solid_, nullptr, const_cast<char*>(kernel_option_.c_str()));
-  opencl_manager.CompileKernel(track_through_filename, "track_through_ggems_solid_box", kernel_track_through_solid_, nullptr, const_cast<char*>(kernel_option_.c_str()));
+  opencl_manager.CompileKernel(track_through_filename, "track_through_ggems_solid_box", kernel_track_through_solid_, nullptr, const_cast<char*>(track_through_option.c_str()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -254,6 +260,7 @@ void GGEMSSolidBox::PrintInfos(void) const
     GGcout("GGEMSSolidBox", "PrintInfos", 0) << "        " << solid_data_device->obb_geometry_.matrix_transformation_.m3_[0] << " " << solid_data_device->obb_geometry_.matrix_transformation_.m3_[1] << " " << solid_data_device->obb_geometry_.matrix_transformation_.m3_[2] << " " << solid_data_device->obb_geometry_.matrix_transformation_.m3_[3] << GGendl;
     GGcout("GGEMSSolidBox", "PrintInfos", 0) << "    ]" << GGendl;
     GGcout("GGEMSSolidBox", "PrintInfos", 0) << "* Solid index: " << solid_data_device->solid_id_ << GGendl;
+    if (data_reg_type_ == "HISTOGRAM") GGcout("GGEMSSolidBox", "PrintInfos", 0) << "* Histogram counted in: " << (histogram_.is_local_ ? "local memory by work-group" : "global memory") << GGendl;
     GGcout("GGEMSSolidBox", "PrintInfos", 0) << GGendl;
 
     // Releasing the pointer
@@ -285,3 +292,39 @@ void GGEMSSolidBox::UpdateTransformationMatrix(GGsize const& thread_index)
   opencl_manager.ReleaseDeviceBuffer(solid_data_[thread_index], solid_data_device, thread_index);
   opencl_manager.ReleaseDeviceBuffer(geometry_transformation_->GetTransformationMatrix(thread_index), transformation_matrix_device, thread_index);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGint GGEMSSolidBox::GetSolidID(GGsize const& thread_index) const
+{
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGEMSSolidBoxData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSSolidBoxData>(solid_data_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSSolidBoxData), thread_index);
+
+  GGint solid_id = solid_data_device->solid_id_;
+
+  opencl_manager.ReleaseDeviceBuffer(solid_data_[thread_index], solid_data_device, thread_index);
+
+  return solid_id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGEMSOBB GGEMSSolidBox::GetOBBGeometry(GGsize const& thread_index) const
+{
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGEMSSolidBoxData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSSolidBoxData>(solid_data_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSSolidBoxData), thread_index);
+
+  GGEMSOBB obb_geometry = solid_data_device->obb_geometry_;
+
+  opencl_manager.ReleaseDeviceBuffer(solid_data_[thread_index], solid_data_device, thread_index);
+
+  return obb_geometry;
+}
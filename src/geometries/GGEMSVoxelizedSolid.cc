@@ -33,6 +33,14 @@
 #include "GGEMS/maths/GGEMSGeometryTransformation.hh"
 #include "GGEMS/graphics/GGEMSOpenGLParaGrid.hh"
 
+/*!
+  \namespace
+  \brief empty namespace storing names of label layouts
+*/
+namespace {
+  std::string const kLabelLayoutNames[4] = {"linear", "brick4", "brick8", "morton"}; /*!< Names of label layouts, indexed by layout */
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -40,7 +48,8 @@
 GGEMSVoxelizedSolid::GGEMSVoxelizedSolid(std::string const& volume_header_filename, std::string const& range_filename, std::string const& data_reg_type)
 : GGEMSSolid(),
   volume_header_filename_(volume_header_filename),
-  range_filename_(range_filename)
+  range_filename_(range_filename),
+  label_layout_(LINEAR_LABEL_LAYOUT)
 {
   GGcout("GGEMSVoxelizedSolid", "GGEMSVoxelizedSolid", 3) << "GGEMSVoxelizedSolid creating..." << GGendl;
 
@@ -147,11 +156,26 @@ void GGEMSVoxelizedSolid::Initialize(GGEMSMaterials* materials)
       true // Draw midplanes
     );
 
+    GGint3 number_of_voxels_xyz = solid_data_device->number_of_voxels_xyz_;
+
     // Release the pointer
     opencl_manager.ReleaseDeviceBuffer(solid_data_[0], solid_data_device, 0);
 
+    // Labels in linear order for OpenGL
+    std::vector<GGuchar> linear_label_data(number_of_voxels_);
+    GGuchar* label_data_device = opencl_manager.GetDeviceBuffer<GGuchar>(label_data_[0], CL_TRUE, CL_MAP_READ, label_data_size_ * sizeof(GGuchar), 0);
+    GGsize voxel_id = 0;
+    for (GGint k = 0; k < number_of_voxels_xyz.s[2]; ++k) {
+      for (GGint j = 0; j < number_of_voxels_xyz.s[1]; ++j) {
+        for (GGint i = 0; i < number_of_voxels_xyz.s[0]; ++i) {
+          linear_label_data[voxel_id++] = label_data_device[LabelIndex(label_layout_, i, j, k, number_of_voxels_xyz.s[0], number_of_voxels_xyz.s[1])];
+        }
+      }
+    }
+    opencl_manager.ReleaseDeviceBuffer(label_data_[0], label_data_device, 0);
+
     // Loading labels and materials for OpenGL
-    opengl_solid_->SetMaterial(materials, label_data_[0], number_of_voxels_);
+    opengl_solid_->SetMaterial(materials, linear_label_data.data(), number_of_voxels_);
   }
   #endif
 }
@@ -185,6 +209,24 @@ void GGEMSVoxelizedSolid::UpdateTransformationMatrix(GGsize const& thread_index)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+GGint GGEMSVoxelizedSolid::GetSolidID(GGsize const& thread_index) const
+{
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGEMSVoxelizedSolidData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSVoxelizedSolidData>(solid_data_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSVoxelizedSolidData), thread_index);
+
+  GGint solid_id = solid_data_device->solid_id_;
+
+  opencl_manager.ReleaseDeviceBuffer(solid_data_[thread_index], solid_data_device, thread_index);
+
+  return solid_id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGfloat3 GGEMSVoxelizedSolid::GetVoxelSizes(GGsize const& thread_index) const
 {
   // Get the OpenCL manager
@@ -240,6 +282,7 @@ void GGEMSVoxelizedSolid::PrintInfos(void) const
     GGcout("GGEMSMaterials", "PrintInfos", 0) << "Material on device: " << opencl_manager.GetDeviceName(device_index) << GGendl;
     GGcout("GGEMSVoxelizedSolid", "PrintInfos", 0) << "* Dimension: " << solid_data_device->number_of_voxels_xyz_.s[0] << " " << solid_data_device->number_of_voxels_xyz_.s[1] << " " << solid_data_device->number_of_voxels_xyz_.s[2] << GGendl;
     GGcout("GGEMSVoxelizedSolid", "PrintInfos", 0) << "* Number of voxels: " << solid_data_device->number_of_voxels_ << GGendl;
+    GGcout("GGEMSVoxelizedSolid", "PrintInfos", 0) << "* Label layout: " << kLabelLayoutNames[solid_data_device->label_layout_] << " (" << BestDigitalUnit(label_data_size_*sizeof(GGuchar)) << ")" << GGendl;
     GGcout("GGEMSVoxelizedSolid", "PrintInfos", 0) << "* Size of voxels: (" << solid_data_device->voxel_sizes_xyz_.s[0] /mm << "x" << solid_data_device->voxel_sizes_xyz_.s[1]/mm << "x" << solid_data_device->voxel_sizes_xyz_.s[2]/mm << ") mm3" << GGendl;
     GGcout("GGEMSVoxelizedSolid", "PrintInfos", 0) << "* Oriented bounding box (OBB) in local position:" << GGendl;
     GGcout("GGEMSVoxelizedSolid", "PrintInfos", 0) << "    - X: " << solid_data_device->obb_geometry_.border_min_xyz_.s[0] << " <-> " << solid_data_device->obb_geometry_.border_max_xyz_.s[0] << GGendl;
@@ -264,6 +307,327 @@ void GGEMSVoxelizedSolid::PrintInfos(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSVoxelizedSolid::SetLabelLayout(std::string const& label_layout)
+{
+  for (GGint i = 0; i < 4; ++i) {
+    if (label_layout == kLabelLayoutNames[i]) {
+      label_layout_ = i;
+      return;
+    }
+  }
+
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "Unknown label layout '" << label_layout << "'!!! Available layouts are:" << std::endl;
+  oss << "    - linear" << std::endl;
+  oss << "    - brick4" << std::endl;
+  oss << "    - brick8" << std::endl;
+  oss << "    - morton";
+  GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "SetLabelLayout", oss.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedSolid::BenchmarkLabelLayouts(GGsize const& number_of_rays) const
+{
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Compiling kernel on each device
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string filename = openCL_kernel_path + "/BenchmarkLabelLayout.cl";
+  cl::Kernel** kernel_benchmark = new cl::Kernel*[number_activated_devices_];
+  opencl_manager.CompileKernel(filename, "benchmark_label_layout", kernel_benchmark, nullptr, nullptr);
+
+  GGint steps_per_ray = 256;
+  GGdouble total_reads = static_cast<GGdouble>(number_of_rays) * static_cast<GGdouble>(steps_per_ray);
+
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  cl::NDRange global_wi(opencl_manager.GetBestWorkItem(number_of_rays));
+  cl::NDRange local_wi(work_group_size);
+
+  std::string direction_names[3] = {"isotropic", "beam along X", "beam along Z"};
+
+  for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(j);
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(j);
+    cl::Buffer* checksum = opencl_manager.Allocate(nullptr, sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSVoxelizedSolid");
+
+    GGEMSVoxelizedSolidData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSVoxelizedSolidData>(solid_data_[j], CL_TRUE, CL_MAP_READ, sizeof(GGEMSVoxelizedSolidData), j);
+    GGint3 number_of_voxels_xyz = solid_data_device->number_of_voxels_xyz_;
+    opencl_manager.ReleaseDeviceBuffer(solid_data_[j], solid_data_device, j);
+
+    // Labels in linear order
+    std::vector<GGuchar> linear_label_data(number_of_voxels_);
+    GGuchar* label_data_device = opencl_manager.GetDeviceBuffer<GGuchar>(label_data_[j], CL_TRUE, CL_MAP_READ, label_data_size_ * sizeof(GGuchar), j);
+    GGsize voxel_id = 0;
+    for (GGint z = 0; z < number_of_voxels_xyz.s[2]; ++z) {
+      for (GGint y = 0; y < number_of_voxels_xyz.s[1]; ++y) {
+        for (GGint x = 0; x < number_of_voxels_xyz.s[0]; ++x) {
+          linear_label_data[voxel_id++] = label_data_device[LabelIndex(label_layout_, x, y, z, number_of_voxels_xyz.s[0], number_of_voxels_xyz.s[1])];
+        }
+      }
+    }
+    opencl_manager.ReleaseDeviceBuffer(label_data_[j], label_data_device, j);
+
+    GGint reference_checksums[3] = {0, 0, 0};
+    for (GGint layout = 0; layout < 4; ++layout) {
+      // Copy of labels in tested layout
+      GGsize label_data_size = GetLabelDataSize(layout, number_of_voxels_xyz);
+      cl::Buffer* label_data = opencl_manager.Allocate(nullptr, label_data_size * sizeof(GGuchar), j, CL_MEM_READ_WRITE, "GGEMSVoxelizedSolid");
+      GGuchar* layout_label_data_device = opencl_manager.GetDeviceBuffer<GGuchar>(label_data, CL_TRUE, CL_MAP_WRITE, label_data_size * sizeof(GGuchar), j);
+      std::fill(layout_label_data_device, layout_label_data_device + label_data_size, static_cast<GGuchar>(0));
+      voxel_id = 0;
+      for (GGint z = 0; z < number_of_voxels_xyz.s[2]; ++z) {
+        for (GGint y = 0; y < number_of_voxels_xyz.s[1]; ++y) {
+          for (GGint x = 0; x < number_of_voxels_xyz.s[0]; ++x) {
+            layout_label_data_device[LabelIndex(layout, x, y, z, number_of_voxels_xyz.s[0], number_of_voxels_xyz.s[1])] = linear_label_data[voxel_id++];
+          }
+        }
+      }
+      opencl_manager.ReleaseDeviceBuffer(label_data, layout_label_data_device, j);
+
+      for (GGchar direction_mode = 0; direction_mode < 3; ++direction_mode) {
+        opencl_manager.CleanBuffer(checksum, sizeof(GGint), j);
+
+        kernel_benchmark[j]->setArg(0, number_of_rays);
+        kernel_benchmark[j]->setArg(1, steps_per_ray);
+        kernel_benchmark[j]->setArg(2, number_of_voxels_xyz);
+        kernel_benchmark[j]->setArg(3, layout);
+        kernel_benchmark[j]->setArg(4, direction_mode);
+        kernel_benchmark[j]->setArg(5, *label_data);
+        kernel_benchmark[j]->setArg(6, *checksum);
+
+        // Launching kernel and timing it on device
+        cl::Event event;
+        GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_benchmark[j], 0, global_wi, local_wi, nullptr, &event);
+        opencl_manager.CheckOpenCLError(kernel_status, "GGEMSVoxelizedSolid", "BenchmarkLabelLayouts");
+        event.wait();
+
+        GGulong start = 0, end = 0;
+        opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(event(), CL_PROFILING_COMMAND_START, sizeof(GGulong), &start, nullptr), "GGEMSVoxelizedSolid", "BenchmarkLabelLayouts");
+        opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(event(), CL_PROFILING_COMMAND_END, sizeof(GGulong), &end, nullptr), "GGEMSVoxelizedSolid", "BenchmarkLabelLayouts");
+
+        GGint* checksum_device = opencl_manager.GetDeviceBuffer<GGint>(checksum, CL_TRUE, CL_MAP_READ, sizeof(GGint), j);
+        GGint label_checksum = checksum_device[0];
+        opencl_manager.ReleaseDeviceBuffer(checksum, checksum_device, j);
+
+        GGdouble elapsed_seconds = static_cast<GGdouble>(end - start) * 1.0e-9;
+        GGcout("GGEMSVoxelizedSolid", "BenchmarkLabelLayouts", 0) << kLabelLayoutNames[layout] << ", " << direction_names[direction_mode] << " on " << opencl_manager.GetDeviceName(device_index) << ": "
+          << total_reads / elapsed_seconds << " reads/s (" << total_reads << " reads in " << elapsed_seconds * 1.0e3 << " ms)" << GGendl;
+
+        // Every layout has to read the same labels as linear layout
+        if (layout == LINEAR_LABEL_LAYOUT) reference_checksums[direction_mode] = label_checksum;
+        else if (label_checksum != reference_checksums[direction_mode]) {
+          GGwarn("GGEMSVoxelizedSolid", "BenchmarkLabelLayouts", 0) << "Layout " << kLabelLayoutNames[layout] << " read different labels than linear layout!!!" << GGendl;
+        }
+      }
+
+      opencl_manager.Deallocate(label_data, label_data_size * sizeof(GGuchar), j, "GGEMSVoxelizedSolid");
+    }
+
+    opencl_manager.Deallocate(checksum, sizeof(GGint), j, "GGEMSVoxelizedSolid");
+  }
+
+  delete[] kernel_benchmark;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedSolid::BenchmarkLabelConversion(GGsize const& number_of_slices)
+{
+  if (number_of_slices == 0) {
+    GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "BenchmarkLabelConversion", "Number of slices has to be > 0!!!");
+  }
+
+  GGint3 number_of_voxels_xyz;
+  number_of_voxels_xyz.s[0] = 512;
+  number_of_voxels_xyz.s[1] = 512;
+  number_of_voxels_xyz.s[2] = static_cast<GGint>(number_of_slices);
+  GGsize number_of_voxels = static_cast<GGsize>(number_of_voxels_xyz.s[0]) * static_cast<GGsize>(number_of_voxels_xyz.s[1]) * number_of_slices;
+
+  // Synthetic CT image in Hounsfield units [-1024, 3071] (xorshift)
+  std::vector<GGshort> image(number_of_voxels);
+  GGuint hash = 2463534242u;
+  for (GGsize i = 0; i < number_of_voxels; ++i) {
+    hash ^= hash << 13;
+    hash ^= hash >> 17;
+    hash ^= hash << 5;
+    image[i] = static_cast<GGshort>(static_cast<GGint>(hash & 4095u) - 1024);
+  }
+
+  // 40 ranges [first, last[ covering all the values
+  GGint const kNumberOfRanges = 40;
+  std::vector<GGfloat> first_label_values;
+  std::vector<GGfloat> last_label_values;
+  for (GGint r = 0; r < kNumberOfRanges; ++r) {
+    first_label_values.push_back(static_cast<GGfloat>(-1024 + 4096 * r / kNumberOfRanges));
+    last_label_values.push_back(static_cast<GGfloat>(-1024 + 4096 * (r + 1) / kNumberOfRanges));
+  }
+
+  GGcout("GGEMSVoxelizedSolid", "BenchmarkLabelConversion", 0) << "Converting " << number_of_voxels_xyz.s[0] << "x" << number_of_voxels_xyz.s[1] << "x" << number_of_voxels_xyz.s[2] << " voxels with "
+    << kNumberOfRanges << " ranges..." << GGendl;
+
+  // Scanning all voxels for each range, then checking and copying labels, as done before for each device
+  ChronoTime start_time = GGEMSChrono::Now();
+
+  std::vector<GGuchar> label_scan(number_of_voxels, std::numeric_limits<GGuchar>::max());
+  for (GGint r = 0; r < kNumberOfRanges; ++r) {
+    GGfloat first_label_value = first_label_values[static_cast<GGsize>(r)];
+    GGfloat last_label_value = last_label_values[static_cast<GGsize>(r)];
+    for (GGsize i = 0; i < number_of_voxels; ++i) {
+      GGfloat value = static_cast<GGfloat>(image[i]);
+      if ((value == first_label_value && value == last_label_value) || (value >= first_label_value && value < last_label_value)) {
+        label_scan[i] = static_cast<GGuchar>(r);
+      }
+    }
+  }
+
+  GGsize scan_not_converted = 0;
+  for (GGsize i = 0; i < number_of_voxels; ++i) {
+    if (label_scan[i] == std::numeric_limits<GGuchar>::max()) ++scan_not_converted;
+  }
+
+  std::vector<GGuchar> label_data_scan(number_of_voxels);
+  std::copy(label_scan.begin(), label_scan.end(), label_data_scan.begin());
+
+  ChronoTime scan_time = GGEMSChrono::Now();
+
+  // Sorted intervals and look-up table, built at each conversion as when loading
+  GGEMSRangeLabels range_labels;
+  range_labels.Build(first_label_values, last_label_values);
+
+  std::string const kMethodNames[] = {"sorted ranges", "look-up table"};
+  DurationNano durations[2];
+  GGsize number_of_threads[2] = {0, 0};
+  GGsize not_converted[2] = {0, 0};
+  std::vector<GGuchar> label_data[2];
+  for (GGint method = 0; method < 2; ++method) {
+    label_data[method].assign(number_of_voxels, static_cast<GGuchar>(0));
+    ChronoTime method_start_time = GGEMSChrono::Now();
+    not_converted[method] = ConvertRawDataToLabel(image.data(), false, range_labels, method == 1, LINEAR_LABEL_LAYOUT, number_of_voxels_xyz, label_data[method], number_of_threads[method]);
+    durations[method] = std::chrono::duration_cast<DurationNano>(GGEMSChrono::Now() - method_start_time);
+  }
+
+  // Results
+  DurationNano scan_duration = std::chrono::duration_cast<DurationNano>(scan_time - start_time);
+  GGdouble scan_ms = static_cast<GGdouble>(scan_duration.count()) / 1000000.0;
+  GGcout("GGEMSVoxelizedSolid", "BenchmarkLabelConversion", 0) << "scan of each range (1 thread): " << static_cast<GGdouble>(number_of_voxels) / (scan_ms * 1000.0) << " Mvoxels/s ("
+    << scan_ms << " ms by device before), " << scan_not_converted << " voxels out of ranges" << GGendl;
+
+  for (GGint method = 0; method < 2; ++method) {
+    GGdouble method_ms = static_cast<GGdouble>(durations[method].count()) / 1000000.0;
+    GGcout("GGEMSVoxelizedSolid", "BenchmarkLabelConversion", 0) << kMethodNames[method] << " (" << number_of_threads[method] << " threads): " << static_cast<GGdouble>(number_of_voxels) / (method_ms * 1000.0)
+      << " Mvoxels/s (" << method_ms << " ms), speedup " << scan_ms / method_ms << ", " << not_converted[method] << " voxels out of ranges" << GGendl;
+
+    if (label_data[method] != label_data_scan) {
+      GGwarn("GGEMSVoxelizedSolid", "BenchmarkLabelConversion", 0) << "Conversion with " << kMethodNames[method] << " gives different labels than scan of each range!!!" << GGendl;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedSolid::ReadRangeLabels(std::string const& range_data_filename, GGEMSMaterials* materials)
+{
+  // Opening range data file
+  std::ifstream in_range_stream(range_data_filename, std::ios::in);
+  GGEMSFileStream::CheckInputStream(in_range_stream, range_data_filename);
+
+  // Values in the range file
+  std::vector<GGfloat> first_label_values;
+  std::vector<GGfloat> last_label_values;
+  GGfloat first_label_value = 0.0f;
+  GGfloat last_label_value = 0.0f;
+  std::string material_name("");
+
+  // Reading range file
+  std::string line("");
+  while (std::getline(in_range_stream, line)) {
+    // Check if blank line
+    if (GGEMSTextReader::IsBlankLine(line)) continue;
+
+    // Getting the value in string stream
+    std::istringstream iss = GGEMSRangeReader::ReadRangeMaterial(line);
+    iss >> first_label_value >> last_label_value >> material_name;
+
+    materials->AddMaterial(material_name);
+    first_label_values.push_back(first_label_value);
+    last_label_values.push_back(last_label_value);
+  }
+
+  // Closing file
+  in_range_stream.close();
+
+  // Max of GGuchar is kept for values out of ranges
+  if (first_label_values.size() >= static_cast<GGsize>(std::numeric_limits<GGuchar>::max())) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Too many ranges (" << first_label_values.size() << ") in " << range_data_filename << ", labels are stored on 8 bits!!!";
+    GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "ReadRangeLabels", oss.str());
+  }
+
+  range_labels_.Build(first_label_values, last_label_values);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSRangeLabels::Build(std::vector<GGfloat> const& first_label_values, std::vector<GGfloat> const& last_label_values)
+{
+  // Sorted bounds of all ranges
+  bounds_ = first_label_values;
+  bounds_.insert(bounds_.end(), last_label_values.begin(), last_label_values.end());
+  std::sort(bounds_.begin(), bounds_.end());
+  bounds_.erase(std::unique(bounds_.begin(), bounds_.end()), bounds_.end());
+
+  bound_labels_.assign(bounds_.size(), std::numeric_limits<GGuchar>::max());
+  interval_labels_.assign(bounds_.size(), std::numeric_limits<GGuchar>::max());
+
+  // Ranges are applied in file order, a range overwrites labels of previous ones
+  for (GGsize r = 0; r < first_label_values.size(); ++r) {
+    GGsize first_bound = static_cast<GGsize>(std::lower_bound(bounds_.begin(), bounds_.end(), first_label_values[r]) - bounds_.begin());
+    GGsize last_bound = static_cast<GGsize>(std::lower_bound(bounds_.begin(), bounds_.end(), last_label_values[r]) - bounds_.begin());
+
+    // Range with a single value
+    if (first_bound == last_bound) bound_labels_[first_bound] = static_cast<GGuchar>(r);
+
+    // Range [first, last[
+    for (GGsize i = first_bound; i < last_bound; ++i) {
+      bound_labels_[i] = static_cast<GGuchar>(r);
+      interval_labels_[i] = static_cast<GGuchar>(r);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGuchar GGEMSRangeLabels::GetLabel(GGfloat const& value) const
+{
+  // First bound greater than value
+  std::vector<GGfloat>::const_iterator iter = std::upper_bound(bounds_.begin(), bounds_.end(), value);
+  if (iter == bounds_.begin()) return std::numeric_limits<GGuchar>::max();
+
+  GGsize bound = static_cast<GGsize>(iter - bounds_.begin()) - 1;
+  if (bounds_[bound] == value) return bound_labels_[bound];
+
+  // Value between two bounds
+  if (bound + 1 < bounds_.size()) return interval_labels_[bound];
+
+  return std::numeric_limits<GGuchar>::max();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSVoxelizedSolid::LoadVolumeImage(GGEMSMaterials* materials)
 {
   GGcout("GGEMSVoxelizedSolid", "LoadVolumeImage", 3) << "Loading volume image from mhd file..." << GGendl;
@@ -275,33 +639,29 @@ void GGEMSVoxelizedSolid::LoadVolumeImage(GGEMSMaterials* materials)
     mhd_input_phantom.Read(volume_header_filename_, solid_data_[d], d);
   }
 
-  // Get the name of raw file from mhd reader
-  std::string output_dir = mhd_input_phantom.GetOutputDirectory();
-  std::string raw_filename = output_dir + mhd_input_phantom.GetRawMDHfilename();
-
   // Get the type
   std::string const kDataType = mhd_input_phantom.GetDataMHDType();
 
   // Convert raw data to material id data
   if (!kDataType.compare("MET_CHAR")) {
-    ConvertImageToLabel<GGchar>(raw_filename, range_filename_, materials);
+    ConvertImageToLabel<GGchar>(mhd_input_phantom, range_filename_, materials);
   }
   else if (!kDataType.compare("MET_UCHAR")) {
-    ConvertImageToLabel<GGuchar>(raw_filename, range_filename_, materials);
+    ConvertImageToLabel<GGuchar>(mhd_input_phantom, range_filename_, materials);
   }
   else if (!kDataType.compare("MET_SHORT")) {
-    ConvertImageToLabel<GGshort>(raw_filename, range_filename_, materials);
+    ConvertImageToLabel<GGshort>(mhd_input_phantom, range_filename_, materials);
   }
   else if (!kDataType.compare("MET_USHORT")) {
-    ConvertImageToLabel<GGushort>(raw_filename, range_filename_, materials);
+    ConvertImageToLabel<GGushort>(mhd_input_phantom, range_filename_, materials);
   }
   else if (!kDataType.compare("MET_INT")) {
-    ConvertImageToLabel<GGint>(raw_filename, range_filename_, materials);
+    ConvertImageToLabel<GGint>(mhd_input_phantom, range_filename_, materials);
   }
   else if (!kDataType.compare("MET_UINT")) {
-    ConvertImageToLabel<GGuint>(raw_filename, range_filename_, materials);
+    ConvertImageToLabel<GGuint>(mhd_input_phantom, range_filename_, materials);
   }
   else if (!kDataType.compare("MET_FLOAT")) {
-    ConvertImageToLabel<GGfloat>(raw_filename, range_filename_, materials);
+    ConvertImageToLabel<GGfloat>(mhd_input_phantom, range_filename_, materials);
   }
 }
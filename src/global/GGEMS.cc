@@ -49,12 +49,14 @@ namespace {
 #include "GGEMS/global/GGEMS.hh"
 #include "GGEMS/physics/GGEMSProcessesManager.hh"
 #include "GGEMS/physics/GGEMSRangeCutsManager.hh"
+#include "GGEMS/physics/GGEMSPhysicTablesRegistry.hh"
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 #include "GGEMS/navigators/GGEMSNavigatorManager.hh"
 #include "GGEMS/tools/GGEMSRAMManager.hh"
 #include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
 #include "GGEMS/tools/GGEMSProfilerManager.hh"
 #include "GGEMS/tools/GGEMSProgressBar.hh"
+#include "GGEMS/io/GGEMSMHDWriterManager.hh"
 
 #ifdef OPENGL_VISUALIZATION
 #include "GGEMS/graphics/GGEMSOpenGLManager.hh"
@@ -75,7 +77,9 @@ GGEMS::GGEMS(void)
   is_random_verbose_(false),
   is_tracking_verbose_(false),
   is_profiling_verbose_(false),
-  particle_tracking_id_(0)
+  particle_tracking_id_(0),
+  alive_check_period_(4),
+  is_async_output_(false)
 {
   GGcout("GGEMS", "GGEMS", 3) << "GGEMS creating..." << GGendl;
 
@@ -188,6 +192,52 @@ void GGEMS::SetTrackingVerbose(bool const& is_tracking_verbose, GGint const& par
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMS::SetAsyncOutput(bool const& is_async_output)
+{
+  is_async_output_ = is_async_output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::WaitOutput(void)
+{
+  ChronoTime start_time = GGEMSChrono::Now();
+
+  GGEMSMHDWriterManager::GetInstance().Wait();
+
+  GGcout("GGEMS", "WaitOutput", 1) << "Output files written, waited " << std::chrono::duration_cast<Ms>(GGEMSChrono::Now() - start_time).count() << " ms" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::BenchmarkFindSolid(GGsize const& number_of_rays) const
+{
+  GGEMSNavigatorManager::GetInstance().BenchmarkFindSolid(number_of_rays);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetAliveCheckPeriod(GGsize const& alive_check_period)
+{
+  if (alive_check_period == 0) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Period checking alive particles must be at least 1!!!";
+    GGEMSMisc::ThrowException("GGEMS", "SetAliveCheckPeriod", oss.str());
+  }
+
+  alive_check_period_ = alive_check_period;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMS::Initialize(GGuint const& seed)
 {
   GGcout("GGEMS", "Initialize", 1) << "Initialization of GGEMS Manager singleton..." << GGendl;
@@ -241,6 +291,7 @@ void GGEMS::Initialize(GGuint const& seed)
   if (is_process_verbose_) {
     processes_manager.PrintAvailableProcesses();
     processes_manager.PrintInfos();
+    GGEMSPhysicTablesRegistry::GetInstance().PrintInfos();
   }
 
   // Printing infos about range cuts
@@ -303,23 +354,32 @@ void GGEMS::RunOnDevice(GGsize const& thread_index)
 
   // Printing progress bar
   mutex.lock();
-  static GGEMSProgressBar progress_bar(source_manager.GetTotalNumberOfBatchs());
+  static GGEMSProgressBar progress_bar(source_manager.GetTotalNumberOfParticles());
   mutex.unlock();
 
   // Loop over sources
   for (GGsize i = 0; i < source_manager.GetNumberOfSources(); ++i) {
-    // Number of batch for a source
-    GGsize number_of_batchs = source_manager.GetNumberOfBatchs(i, thread_index);
+    // Pulling batchs from queue shared by devices until all particles of source are simulated
+    GGsize first_particle = 0, number_of_particles = 0;
+    bool is_next_batch = source_manager.GetNextBatch(i, thread_index, first_particle, number_of_particles);
+
+    // Generating particles of first batch
+    if (is_next_batch) source_manager.GetPrimaries(i, thread_index, first_particle, number_of_particles);
+
+    while (is_next_batch) {
+      ChronoTime batch_start_time = GGEMSChrono::Now();
 
-    // Loop over batch
-    for (GGsize j = 0; j < number_of_batchs; ++j) {
-      GGsize number_of_particles = source_manager.GetNumberOfParticlesInBatch(i, thread_index, j);
+      // Generated particles become the transported particles
+      source_manager.SwapParticleBuffers(thread_index);
+      GGsize number_of_transported_particles = number_of_particles;
 
-      // Generating particles
-      source_manager.GetPrimaries(i, thread_index, number_of_particles);
+      // Generating particles of next batch in second buffer, in same time as transport
+      is_next_batch = source_manager.GetNextBatch(i, thread_index, first_particle, number_of_particles);
+      if (is_next_batch) source_manager.GetPrimaries(i, thread_index, first_particle, number_of_particles);
 
-      // Loop until ALL particles are dead
-      GGint loop_counter = 0, max_loop = 100; // Prevent infinite loop
+      // Loop until ALL particles are dead, checked every alive_check_period_ iterations. Dead particles are ignored by navigation kernels
+      // Stages are enqueued without blocking, each stage waits for the event of previous one and host waits only for counting of alive particles
+      GGsize loop_counter = 0, max_loop = 100; // Prevent infinite loop
       do {
         // Step 2: Find closest navigator (phantom, detector) before projection and track operation
         navigator_manager.FindSolid(thread_index);
@@ -334,11 +394,17 @@ void GGEMS::RunOnDevice(GGsize const& thread_index)
         navigator_manager.TrackThroughSolid(thread_index);
 
         loop_counter++;
-      } while (source_manager.IsAlive(thread_index) && loop_counter < max_loop); // Step 5: Checking if all particles are dead, otherwize go back to step 2
+
+        // Step 5: Counting alive particles without blocking host
+        if (loop_counter%alive_check_period_ == 0) source_manager.EnqueueAliveCount(thread_index);
+      } while ((loop_counter%alive_check_period_ != 0 || source_manager.IsAlive(thread_index)) && loop_counter < max_loop); // Checking if all particles are dead, otherwize go back to step 2
+
+      // Measured throughput of device gives size of next batchs
+      source_manager.UpdateDeviceThroughput(thread_index, number_of_transported_particles, GGEMSChrono::Now() - batch_start_time);
 
       // Incrementing progress bar
       mutex.lock();
-      ++progress_bar;
+      progress_bar += number_of_transported_particles;
       mutex.unlock();
 
       // If OpenGL, send particle OpenGL infos from OpenCL buffer to OpenGL for the current source
@@ -349,9 +415,6 @@ void GGEMS::RunOnDevice(GGsize const& thread_index)
       #endif
     }
   }
-
-  // Computing dose
-  navigator_manager.ComputeDose(thread_index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -378,11 +441,17 @@ void GGEMS::Run()
   // Deleting threads
   delete[] thread_device;
 
+  // Computing dose once from energy deposits of all devices
+  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+  navigator_manager.ComputeDose();
+
   // End of simulation, storing output
   GGcout("GGEMS", "Run", 1) << "Saving results..." << GGendl;
-  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
   navigator_manager.SaveResults();
 
+  // Files are written in background, waiting for them except if asynchronous output is asked
+  if (!is_async_output_) WaitOutput();
+
   // Printing elapsed time in kernels
   if (is_profiling_verbose_) {
     GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
@@ -548,7 +617,43 @@ void set_tracking_ggems(GGEMS* ggems, bool const is_tracking_verbose, GGint cons
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void set_alive_check_period_ggems(GGEMS* ggems, GGsize const alive_check_period)
+{
+  ggems->SetAliveCheckPeriod(alive_check_period);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_async_output_ggems(GGEMS* ggems, bool const is_async_output)
+{
+  ggems->SetAsyncOutput(is_async_output);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void wait_output_ggems(GGEMS* ggems)
+{
+  ggems->WaitOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void run_ggems(GGEMS* ggems)
 {
   ggems->Run();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void benchmark_find_solid_ggems(GGEMS* ggems, GGsize const number_of_rays)
+{
+  ggems->BenchmarkFindSolid(number_of_rays);
+}
@@ -30,10 +30,13 @@
 
 #include <algorithm>
 #include <sstream>
+#include <filesystem>
 
 #include "GGEMS/tools/GGEMSTools.hh"
 #include "GGEMS/global/GGEMSOpenCLManager.hh"
 #include "GGEMS/tools/GGEMSRAMManager.hh"
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+#include "GGEMS/randoms/GGEMSRandom.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -76,6 +79,8 @@ void GGEMSOpenCLManager::Clean(void)
   // Freeing activated devices
   for (ComputingDevice& i : computing_devices_) i.Clean();
   computing_devices_.clear();
+  particle_stack_size_.clear();
+  transport_wait_lists_.clear();
 
   // Deleting kernel
   for (cl::Kernel* k : kernels_) {
@@ -101,6 +106,26 @@ void GGEMSOpenCLManager::InitOpenCL(void)
   GetOpenCLDevices();
   SetOpenCLCompilationOptions();
 
+  // Program binary cache
+  #ifdef OPENCL_KERNEL_BINARY_CACHE
+  is_kernel_binary_cache_ = true;
+  #else
+  is_kernel_binary_cache_ = false;
+  #endif
+  #ifdef OPENCL_KERNEL_BINARY_CACHE_PATH
+  kernel_binary_cache_path_ = OPENCL_KERNEL_BINARY_CACHE_PATH;
+  #else
+  kernel_binary_cache_path_ = "kernel_cache";
+  #endif
+  kernel_binary_cache_hits_ = 0;
+  kernel_binary_cache_misses_ = 0;
+
+  // Number of particles in particle buffers computed from device limits
+  user_particle_stack_size_ = 0;
+
+  // Transport stages chained by events, host waits once per batch
+  is_blocking_stages_ = false;
+
   // Filling alias vendor
   vendors_.insert(std::make_pair("nvidia", "NVIDIA Corporation"));
   vendors_.insert(std::make_pair("intel", "Intel(R) Corporation"));
@@ -571,6 +596,16 @@ void GGEMSOpenCLManager::SetOpenCLCompilationOptions(void)
   build_options_ += " -DDOSIMETRY_DOUBLE_PRECISION";
   #endif
 
+  // Navigation kernels reading list of live particles
+  #ifdef PARTICLE_COMPACTION
+  build_options_ += " -DPARTICLE_COMPACTION";
+  #endif
+
+  // Counter-based random engine
+  #ifdef PHILOX_RANDOM
+  build_options_ += " -DPHILOX_RANDOM";
+  #endif
+
   // Add auxiliary function path to OpenCL options
   #ifdef GGEMS_PATH
   build_options_ += " -I";
@@ -593,6 +628,7 @@ void GGEMSOpenCLManager::PrintBuildOptions(void) const
   GGcout("GGEMSOpenCLManager", "PrintBuildOptions", 0) << "OpenCL NVIDIA kernel cache compilation: ON" << GGendl;
   #endif
   GGcout("GGEMSOpenCLManager", "PrintBuildOptions", 0) << "OpenCL building options: " << build_options_ << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintBuildOptions", 0) << "OpenCL program binary cache: " << (is_kernel_binary_cache_ ? "ON" : "OFF") << ", path: " << kernel_binary_cache_path_ << GGendl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -617,6 +653,8 @@ void GGEMSOpenCLManager::PrintActivatedDevices(void) const
       GGcout("GGEMSOpenCLManager", "PrintActivatedDevices", 0) << "    -> Type: CL_DEVICE_TYPE_CPU " << GGendl;
     else if (GetDeviceType(computing_devices_[i].index_) == CL_DEVICE_TYPE_GPU)
       GGcout("GGEMSOpenCLManager", "PrintActivatedDevices", 0) << "    -> Type: CL_DEVICE_TYPE_GPU " << GGendl;
+    if (particle_stack_size_[i] != 0)
+      GGcout("GGEMSOpenCLManager", "PrintActivatedDevices", 0) << "    -> Particle stack size: " << particle_stack_size_[i] << GGendl;
   }
 
   GGcout("GGEMSOpenCLManager", "PrintActivatedDevice", 0) << GGendl;
@@ -740,9 +778,12 @@ void GGEMSOpenCLManager::DeviceToActivate(GGsize const& device_id)
   computing_device.index_ = device_id;
   computing_device.context_ = new cl::Context(*devices_.at(device_id));
   computing_device.queue_ = new cl::CommandQueue(*computing_device.context_, *devices_.at(device_id), CL_QUEUE_PROFILING_ENABLE);
+  computing_device.generation_queue_ = new cl::CommandQueue(*computing_device.context_, *devices_.at(device_id), CL_QUEUE_PROFILING_ENABLE);
 
   // Storing computing device
   computing_devices_.push_back(computing_device);
+  particle_stack_size_.push_back(0);
+  transport_wait_lists_.push_back(std::vector<cl::Event>());
 
   // Printing name of activated device
   GGcout("GGEMSOpenCLManager", "DeviceToActivate", 2) << "Activated device: " << GetDeviceName(device_id) << GGendl;
@@ -795,18 +836,139 @@ void GGEMSOpenCLManager::DeviceBalancing(std::string const& device_balancing)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-GGsize GGEMSOpenCLManager::CheckKernel(std::string const& kernel_name, std::string const& compilation_options) const
+void GGEMSOpenCLManager::SetParticleStackSize(GGsize const& particle_stack_size)
+{
+  user_particle_stack_size_ = particle_stack_size;
+
+  // Size computed again for each device at next request
+  std::fill(particle_stack_size_.begin(), particle_stack_size_.end(), 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::SetBlockingStages(bool const& is_blocking_stages)
+{
+  is_blocking_stages_ = is_blocking_stages;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<cl::Event> const* GGEMSOpenCLManager::GetTransportWaitList(GGsize const& thread_index) const
+{
+  return transport_wait_lists_[thread_index].empty() ? nullptr : &transport_wait_lists_[thread_index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::ChainTransportEvent(GGsize const& thread_index, cl::Event const& event)
+{
+  // The next stage waits only for this command, previous commands of the chain are already in its dependencies
+  transport_wait_lists_[thread_index].assign(1, event);
+
+  // Old behavior, host waits for the end of each stage
+  if (is_blocking_stages_) CheckOpenCLError(event.wait(), "GGEMSOpenCLManager", "ChainTransportEvent");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::AddTransportDependency(GGsize const& thread_index, cl::Event const& event)
+{
+  transport_wait_lists_[thread_index].push_back(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGsize GGEMSOpenCLManager::GetParticleStackSize(GGsize const& thread_index)
+{
+  if (particle_stack_size_[thread_index] == 0) ComputeParticleStackSize(thread_index);
+
+  return particle_stack_size_[thread_index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::ComputeParticleStackSize(GGsize const& thread_index)
+{
+  GGcout("GGEMSOpenCLManager", "ComputeParticleStackSize", 3) << "Computing number of particles in particle buffers..." << GGendl;
+
+  GGsize device_index = GetIndexOfActivatedDevice(thread_index);
+
+  // Size of one particle in particle and random buffers
+  GGsize fixed_size = GetPrimaryParticlesFixedSize();
+  GGsize particle_size = GetPrimaryParticlesSize(1) - GetPrimaryParticlesSize(0);
+  GGsize random_size = GetRandomSize(1);
+
+  // Maximum number of particles in a buffer allocation, particle buffer is the biggest one
+  GGsize max_buffer_size = GetMaxBufferAllocationSize(device_index);
+  GGsize max_stack_size = max_buffer_size > fixed_size ? (max_buffer_size - fixed_size) / particle_size : 0;
+  max_stack_size = (max_stack_size / work_group_size_) * work_group_size_;
+
+  GGsize stack_size = 0;
+  if (user_particle_stack_size_ == 0) {
+    // Half of available RAM for particle and random buffers, both doubled for generation during transport, the other half for navigators
+    GGEMSRAMManager& ram_manager = GGEMSRAMManager::GetInstance();
+    GGsize available_ram = ram_manager.GetAvailableRAMMemory(device_index) / 2;
+    GGsize ram_stack_size = available_ram > 2*fixed_size ? (available_ram - 2*fixed_size) / (2*(particle_size+random_size)) : 0;
+    stack_size = (std::min(max_stack_size, ram_stack_size) / work_group_size_) * work_group_size_;
+  }
+  else {
+    // Rounded to a multiple of work group size
+    stack_size = ((user_particle_stack_size_ + work_group_size_ - 1) / work_group_size_) * work_group_size_;
+
+    if (stack_size > max_stack_size) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Particle stack size: " << stack_size << ", is too big for device " << GetDeviceName(device_index) << "!!! The maximum size is " << max_stack_size << " particles";
+      GGEMSMisc::ThrowException("GGEMSOpenCLManager", "ComputeParticleStackSize", oss.str());
+    }
+  }
+
+  if (stack_size == 0) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Not enough RAM memory on device " << GetDeviceName(device_index) << " for particle buffers!!!";
+    GGEMSMisc::ThrowException("GGEMSOpenCLManager", "ComputeParticleStackSize", oss.str());
+  }
+
+  particle_stack_size_[thread_index] = stack_size;
+
+  GGcout("GGEMSOpenCLManager", "ComputeParticleStackSize", 1) << "Particle stack size on device " << GetDeviceName(device_index) << ": " << stack_size << " particles" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGsize GGEMSOpenCLManager::CheckKernel(std::string const& kernel_name, std::vector<std::string> const& compilation_options) const
 {
   GGcout("GGEMSOpenCLManager","CheckKernel", 3) << "Checking if kernel has already been compiled..." << GGendl;
 
   // Parameters for kernel infos
   std::string registered_kernel_name("");
 
-  // Loop over registered kernels
-  for (GGsize i = 0; i < kernels_.size(); ++i) {
+  // Loop over registered kernels, a kernel is stored for each activated device
+  GGsize number_of_devices = computing_devices_.size();
+  for (GGsize i = 0; i + number_of_devices <= kernels_.size(); i += number_of_devices) {
     CheckOpenCLError(kernels_.at(i)->getInfo(CL_KERNEL_FUNCTION_NAME, &registered_kernel_name), "GGEMSOpenCLManager", "CheckKernel");
     registered_kernel_name.erase(std::remove(registered_kernel_name.begin(), registered_kernel_name.end(), '\0'), registered_kernel_name.end());
-    if (kernel_name == registered_kernel_name && compilation_options == kernel_compilation_options_.at(i)) return i;
+    if (kernel_name != registered_kernel_name) continue;
+
+    // Options include particle stack size of each device
+    bool is_same_options = true;
+    for (GGsize j = 0; j < number_of_devices; ++j) {
+      if (compilation_options.at(j) != kernel_compilation_options_.at(i+j)) is_same_options = false;
+    }
+    if (is_same_options) return i;
   }
 
   return KERNEL_NOT_COMPILED;
@@ -855,8 +1017,14 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
     #endif
   }
 
+  // Number of particles in particle buffers of each device
+  std::vector<std::string> device_compilation_options;
+  for (GGsize i = 0; i < computing_devices_.size(); ++i) {
+    device_compilation_options.push_back(std::string(kernel_compilation_option) + " -DMAXIMUM_PARTICLES=" + std::to_string(GetParticleStackSize(i)));
+  }
+
   // Checking if kernel already compiled
-  GGsize kernel_index = CheckKernel(kernel_name, kernel_compilation_option);
+  GGsize kernel_index = CheckKernel(kernel_name, device_compilation_options);
 
   // if kernel already compiled return it
   if (kernel_index != KERNEL_NOT_COMPILED) {
@@ -872,38 +1040,69 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
     // Store kernel in a std::string buffer
     std::string source_code(std::istreambuf_iterator<char>(source_file_stream), (std::istreambuf_iterator<char>()));
 
+    // Kernel source with all its includes, key of the binary cache
+    std::string cache_source_code;
+    if (is_kernel_binary_cache_) {
+      std::vector<std::string> visited_files;
+      ReadKernelSourceWithIncludes(kernel_filename, cache_source_code, visited_files);
+    }
+
     // Creating an OpenCL program
     cl::Program::Sources program_source(1, std::make_pair(source_code.c_str(), source_code.length() + 1));
 
     // Loop over activated device
     for (GGsize i = 0; i < computing_devices_.size(); ++i) {
-      // Make program from source code in context
-      cl::Program program = cl::Program(*computing_devices_[i].context_, program_source);
-
       // Get device associated to context, in our case 1 context = 1 device
       std::vector<cl::Device> device;
       CheckOpenCLError(computing_devices_[i].context_->getInfo(CL_CONTEXT_DEVICES, &device), "GGEMSOpenCLManager", "CompileKernel");
 
-      GGcout("GGEMSOpenCLManager", "CompileKernel", 2) << "Compile a new kernel '" << kernel_name << "' from file: " << kernel_filename << " on device: " << GetDeviceName(computing_devices_[i].index_) << " with options: " << kernel_compilation_option << GGendl;
-
-      // Compile source code on device
-      GGint build_status = program.build(device, kernel_compilation_option);
-      if (build_status != CL_SUCCESS) {
-        std::ostringstream oss(std::ostringstream::out);
-        std::string log;
-        program.getBuildInfo(device[0], CL_PROGRAM_BUILD_LOG, &log);
-        oss << ErrorType(build_status) << std::endl;
-        oss << log;
-        GGEMSMisc::ThrowException("GGEMSOpenCLManager", "CompileKernel", oss.str());
+      std::string const& device_compilation_option = device_compilation_options[i];
+
+      // Try to load the program from the binary cache
+      cl::Program program;
+      std::string cache_filename;
+      bool is_loaded_from_cache = false;
+      if (is_kernel_binary_cache_) {
+        cache_filename = GetKernelBinaryCacheFilename(kernel_filename, cache_source_code, device_compilation_option, i);
+        is_loaded_from_cache = LoadKernelBinary(cache_filename, device_compilation_option, i, program);
+      }
+
+      if (is_loaded_from_cache) {
+        GGcout("GGEMSOpenCLManager", "CompileKernel", 2) << "Load kernel '" << kernel_name << "' from binary cache: " << cache_filename << " on device: " << GetDeviceName(computing_devices_[i].index_) << GGendl;
+        ++kernel_binary_cache_hits_;
+      }
+      else {
+        // Make program from source code in context
+        program = cl::Program(*computing_devices_[i].context_, program_source);
+
+        GGcout("GGEMSOpenCLManager", "CompileKernel", 2) << "Compile a new kernel '" << kernel_name << "' from file: " << kernel_filename << " on device: " << GetDeviceName(computing_devices_[i].index_) << " with options: " << device_compilation_option << GGendl;
+
+        // Compile source code on device
+        GGint build_status = program.build(device, device_compilation_option.c_str());
+        if (build_status != CL_SUCCESS) {
+          std::ostringstream oss(std::ostringstream::out);
+          std::string log;
+          program.getBuildInfo(device[0], CL_PROGRAM_BUILD_LOG, &log);
+          oss << ErrorType(build_status) << std::endl;
+          oss << log;
+          GGEMSMisc::ThrowException("GGEMSOpenCLManager", "CompileKernel", oss.str());
+        }
+
+        // Storing the program binary for the next run
+        if (is_kernel_binary_cache_) {
+          StoreKernelBinary(cache_filename, program);
+          ++kernel_binary_cache_misses_;
+        }
       }
 
       // Storing the kernel in the singleton
-      kernels_.push_back(new cl::Kernel(program, kernel_name.c_str(), &build_status));
+      GGint kernel_status = 0;
+      kernels_.push_back(new cl::Kernel(program, kernel_name.c_str(), &kernel_status));
       kernel_list[i] = kernels_.back();
-      CheckOpenCLError(build_status, "GGEMSOpenCLManager", "CompileKernel");
+      CheckOpenCLError(kernel_status, "GGEMSOpenCLManager", "CompileKernel");
 
       // Storing the compilation options
-      kernel_compilation_options_.push_back(kernel_compilation_option);
+      kernel_compilation_options_.push_back(device_compilation_option);
     }
   }
 }
@@ -912,6 +1111,185 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSOpenCLManager::ReadKernelSourceWithIncludes(std::string const& filename, std::string& source_code, std::vector<std::string>& visited_files) const
+{
+  // Checking if file already read
+  if (std::find(visited_files.begin(), visited_files.end(), filename) != visited_files.end()) return;
+  visited_files.push_back(filename);
+
+  std::ifstream file_stream(filename.c_str(), std::ios::in);
+  GGEMSFileStream::CheckInputStream(file_stream, filename);
+
+  std::string line;
+  while (std::getline(file_stream, line)) {
+    source_code += line;
+    source_code += '\n';
+
+    // Looking for '#include "..."' directive
+    GGsize include_position = line.find("#include");
+    if (include_position == std::string::npos) continue;
+
+    GGsize first_quote = line.find('"', include_position);
+    GGsize last_quote = first_quote == std::string::npos ? std::string::npos : line.find('"', first_quote + 1);
+    if (last_quote == std::string::npos) continue;
+
+    std::string include_name = line.substr(first_quote + 1, last_quote - first_quote - 1);
+
+    // Searching the header in GGEMS include directory then in directory of current file
+    std::filesystem::path include_path = std::filesystem::path(GGEMS_PATH) / "include" / include_name;
+    if (!std::filesystem::exists(include_path)) include_path = std::filesystem::path(filename).parent_path() / include_name;
+    if (!std::filesystem::exists(include_path)) continue;
+
+    ReadKernelSourceWithIncludes(include_path.string(), source_code, visited_files);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSOpenCLManager::GetKernelBinaryCacheFilename(std::string const& kernel_filename, std::string const& source_code, std::string const& compilation_options, GGsize const& thread_index) const
+{
+  GGsize device_index = computing_devices_[thread_index].index_;
+
+  // Key of cache: source + includes, options, device and driver
+  std::string key = source_code;
+  key += compilation_options;
+  key += device_name_[device_index];
+  key += device_version_[device_index];
+  key += device_driver_version_[device_index];
+
+  // FNV-1a 64 bits hash
+  GGulong hash = 14695981039346656037ULL;
+  for (char const& c : key) {
+    hash ^= static_cast<GGulong>(static_cast<unsigned char>(c));
+    hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream oss(std::ostringstream::out);
+  oss << std::filesystem::path(kernel_filename).stem().string() << "_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+
+  return (std::filesystem::path(kernel_binary_cache_path_) / oss.str()).string();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSOpenCLManager::LoadKernelBinary(std::string const& cache_filename, std::string const& compilation_options, GGsize const& thread_index, cl::Program& program) const
+{
+  std::ifstream binary_stream(cache_filename.c_str(), std::ios::in | std::ios::binary);
+  if (!binary_stream) return false;
+
+  std::vector<char> binary((std::istreambuf_iterator<char>(binary_stream)), std::istreambuf_iterator<char>());
+  if (binary.empty()) return false;
+
+  std::vector<cl::Device> device;
+  CheckOpenCLError(computing_devices_[thread_index].context_->getInfo(CL_CONTEXT_DEVICES, &device), "GGEMSOpenCLManager", "LoadKernelBinary");
+
+  // Create program from binary, a corrupted or outdated binary is compiled again from source
+  cl::Program::Binaries program_binary(1, std::make_pair(static_cast<void const*>(binary.data()), binary.size()));
+  std::vector<GGint> binary_status;
+  GGint error = 0;
+  program = cl::Program(*computing_devices_[thread_index].context_, device, program_binary, &binary_status, &error);
+  if (error != CL_SUCCESS || binary_status.empty() || binary_status[0] != CL_SUCCESS) {
+    GGwarn("GGEMSOpenCLManager", "LoadKernelBinary", 1) << "Invalid binary in cache: " << cache_filename << ", compiling from source..." << GGendl;
+    return false;
+  }
+
+  if (program.build(device, compilation_options.c_str()) != CL_SUCCESS) {
+    GGwarn("GGEMSOpenCLManager", "LoadKernelBinary", 1) << "Binary in cache can not be built: " << cache_filename << ", compiling from source..." << GGendl;
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::StoreKernelBinary(std::string const& cache_filename, cl::Program& program) const
+{
+  // Getting binary of program, 1 program = 1 device
+  GGsize binary_size = 0;
+  CheckOpenCLError(clGetProgramInfo(program(), CL_PROGRAM_BINARY_SIZES, sizeof(GGsize), &binary_size, nullptr), "GGEMSOpenCLManager", "StoreKernelBinary");
+  if (binary_size == 0) return;
+
+  std::vector<unsigned char> binary(binary_size);
+  unsigned char* binary_ptr = binary.data();
+  CheckOpenCLError(clGetProgramInfo(program(), CL_PROGRAM_BINARIES, sizeof(unsigned char*), &binary_ptr, nullptr), "GGEMSOpenCLManager", "StoreKernelBinary");
+
+  // Writing binary in a temporary file renamed at the end, several GGEMS processes can share the cache
+  std::error_code error_code;
+  std::filesystem::create_directories(kernel_binary_cache_path_, error_code);
+
+  std::string tmp_filename = cache_filename + ".tmp";
+  std::ofstream binary_stream(tmp_filename.c_str(), std::ios::out | std::ios::binary);
+  if (!binary_stream) {
+    GGwarn("GGEMSOpenCLManager", "StoreKernelBinary", 1) << "Impossible to write in binary cache: " << tmp_filename << GGendl;
+    return;
+  }
+  binary_stream.write(reinterpret_cast<char*>(binary.data()), static_cast<std::streamsize>(binary_size));
+  binary_stream.close();
+
+  std::filesystem::rename(tmp_filename, cache_filename, error_code);
+  if (error_code) std::filesystem::remove(tmp_filename, error_code);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::SetKernelBinaryCache(bool const& is_kernel_binary_cache)
+{
+  is_kernel_binary_cache_ = is_kernel_binary_cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::SetKernelBinaryCachePath(std::string const& kernel_binary_cache_path)
+{
+  kernel_binary_cache_path_ = kernel_binary_cache_path;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::InvalidateKernelBinaryCache(void)
+{
+  GGcout("GGEMSOpenCLManager", "InvalidateKernelBinaryCache", 1) << "Removing OpenCL program binaries in " << kernel_binary_cache_path_ << "..." << GGendl;
+
+  std::error_code error_code;
+  if (std::filesystem::is_directory(kernel_binary_cache_path_, error_code)) {
+    for (std::filesystem::directory_entry const& entry : std::filesystem::directory_iterator(kernel_binary_cache_path_, error_code)) {
+      if (entry.path().extension() == ".bin") std::filesystem::remove(entry.path(), error_code);
+    }
+  }
+
+  kernel_binary_cache_hits_ = 0;
+  kernel_binary_cache_misses_ = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::PrintKernelBinaryCacheStatistics(void) const
+{
+  GGcout("GGEMSOpenCLManager", "PrintKernelBinaryCacheStatistics", 0) << "OpenCL program binary cache: " << (is_kernel_binary_cache_ ? "ON" : "OFF") << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelBinaryCacheStatistics", 0) << "    -> Path: " << kernel_binary_cache_path_ << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelBinaryCacheStatistics", 0) << "    -> Hits: " << kernel_binary_cache_hits_ << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelBinaryCacheStatistics", 0) << "    -> Misses: " << kernel_binary_cache_misses_ << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 cl::Buffer* GGEMSOpenCLManager::Allocate(void* host_ptr, GGsize const& size, GGsize const& thread_index, cl_mem_flags flags, std::string const& class_name)
 {
   GGcout("GGEMSOpenCLManager","Allocate", 3) << "Allocating memory on OpenCL device memory..." << GGendl;
@@ -1022,6 +1400,21 @@ GGsize GGEMSOpenCLManager::GetBestWorkItem(GGsize const& number_of_elements) con
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+bool GGEMSOpenCLManager::IsLocalMemoryFitting(GGsize const& size) const
+{
+  for (GGsize i = 0; i < computing_devices_.size(); ++i) {
+    GGsize device_index = GetIndexOfActivatedDevice(i);
+    if (device_local_mem_type_[device_index] != CL_LOCAL) return false;
+    if (size > static_cast<GGsize>(device_local_mem_size_[device_index])) return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSOpenCLManager::HandleEvent(cl::Event& event, char* message)
 {
   clRetainEvent(event());
@@ -1552,3 +1945,57 @@ void set_device_balancing_opencl_manager(GGEMSOpenCLManager* opencl_manager, cha
 {
   opencl_manager->DeviceBalancing(device_balancing);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_particle_stack_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, GGsize const particle_stack_size)
+{
+  opencl_manager->SetParticleStackSize(particle_stack_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_blocking_stages_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_blocking_stages)
+{
+  opencl_manager->SetBlockingStages(is_blocking_stages);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_kernel_binary_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_kernel_binary_cache)
+{
+  opencl_manager->SetKernelBinaryCache(is_kernel_binary_cache);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_kernel_binary_cache_path_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* kernel_binary_cache_path)
+{
+  opencl_manager->SetKernelBinaryCachePath(kernel_binary_cache_path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void invalidate_kernel_binary_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager)
+{
+  opencl_manager->InvalidateKernelBinaryCache();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void print_kernel_binary_cache_statistics_opencl_manager(GGEMSOpenCLManager* opencl_manager)
+{
+  opencl_manager->PrintKernelBinaryCacheStatistics();
+}
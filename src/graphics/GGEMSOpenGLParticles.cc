@@ -175,20 +175,20 @@ void GGEMSOpenGLParticles::CopyParticlePosition(void)
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
 
-  // Getting primary particles from OpenCL
-  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(0);
-  GGEMSPrimaryParticles* primary_particles_device = opencl_manager.GetDeviceBuffer<GGEMSPrimaryParticles>(primary_particles, CL_TRUE, CL_MAP_READ, sizeof(GGEMSPrimaryParticles), 0);
+  // Getting trajectories of displayed particles from OpenCL
+  cl::Buffer* trajectories = source_manager.GetParticles()->GetTrajectories(0);
+  GGEMSParticleTrajectories* trajectories_device = opencl_manager.GetDeviceBuffer<GGEMSParticleTrajectories>(trajectories, CL_TRUE, CL_MAP_READ, sizeof(GGEMSParticleTrajectories), 0);
 
   // Loop over particles
   for (GGsize i = 0; i < number_of_particles_; ++i) {
     // Getting number of interactions for each primary particles
-    GGsize stored_interactions = static_cast<GGsize>(primary_particles_device->stored_particles_gl_[i]);
+    GGsize stored_interactions = static_cast<GGsize>(trajectories_device->stored_particles_gl_[i]);
 
     // Loop over interactions
     for (GGsize j = 0; j < stored_interactions; ++j) {
-      vertex_[j*3+0+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = primary_particles_device->px_gl_[j+i*MAXIMUM_INTERACTIONS];
-      vertex_[j*3+1+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = primary_particles_device->py_gl_[j+i*MAXIMUM_INTERACTIONS];
-      vertex_[j*3+2+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = primary_particles_device->pz_gl_[j+i*MAXIMUM_INTERACTIONS];
+      vertex_[j*3+0+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = trajectories_device->px_gl_[j+i*MAXIMUM_INTERACTIONS];
+      vertex_[j*3+1+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = trajectories_device->py_gl_[j+i*MAXIMUM_INTERACTIONS];
+      vertex_[j*3+2+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = trajectories_device->pz_gl_[j+i*MAXIMUM_INTERACTIONS];
 
       index_[index_increment_++] = static_cast<GLuint>(j+number_of_registered_particles_*MAXIMUM_INTERACTIONS);
     }
@@ -202,7 +202,7 @@ void GGEMSOpenGLParticles::CopyParticlePosition(void)
   }
 
   // Release the pointers
-  opencl_manager.ReleaseDeviceBuffer(primary_particles, primary_particles_device, 0);
+  opencl_manager.ReleaseDeviceBuffer(trajectories, trajectories_device, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -255,7 +255,7 @@ void GGEMSOpenGLVolume::SetMaterial(std::string const& material_name)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSOpenGLVolume::SetMaterial(GGEMSMaterials const* materials, cl::Buffer* label, GGsize const& number_of_voxels)
+void GGEMSOpenGLVolume::SetMaterial(GGEMSMaterials const* materials, GGuchar const* label, GGsize const& number_of_voxels)
 {
   // Cleaning previous color and material
   material_rgb_.clear();
@@ -269,18 +269,11 @@ void GGEMSOpenGLVolume::SetMaterial(GGEMSMaterials const* materials, cl::Buffer*
     material_names_.push_back(material_name);
   }
 
-  // Storing label from OpenCL
+  // Storing label
   label_ = new GGuchar[number_of_voxels];
 
-  // Get pointer on OpenCL device
-  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-  GGuchar* label_data_device = opencl_manager.GetDeviceBuffer<GGuchar>(label, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, number_of_voxels * sizeof(GGuchar), 0);
-
   // Copy data
-  for (GGsize i = 0; i < number_of_voxels; ++i) label_[i] = label_data_device[i];
-
-  // Release the pointer
-  opencl_manager.ReleaseDeviceBuffer(label, label_data_device, 0);
+  for (GGsize i = 0; i < number_of_voxels; ++i) label_[i] = label[i];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
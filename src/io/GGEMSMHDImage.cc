@@ -29,6 +29,16 @@
 */
 
 #include <vector>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
 #include "GGEMS/io/GGEMSMHDImage.hh"
@@ -43,7 +53,12 @@ GGEMSMHDImage::GGEMSMHDImage(void)
 : mhd_header_file_(""),
   mhd_raw_file_(""),
   output_dir_(""),
-  mhd_data_type_("MET_FLOAT")
+  mhd_data_type_("MET_FLOAT"),
+  is_msb_(false),
+  raw_data_(nullptr),
+  raw_data_size_(0),
+  raw_file_handle_(nullptr),
+  raw_mapping_handle_(nullptr)
 {
   GGcout("GGEMSMHDImage", "GGEMSMHDImage", 3) << "GGEMSMHDImage creating..." << GGendl;
 
@@ -67,6 +82,8 @@ GGEMSMHDImage::~GGEMSMHDImage(void)
 {
   GGcout("GGEMSMHDImage", "~GGEMSMHDImage", 3) << "GGEMSMHDImage erasing!!!" << GGendl;
 
+  UnmapRawData();
+
   GGcout("GGEMSMHDImage", "~GGEMSMHDImage", 3) << "GGEMSMHDImage erased!!!" << GGendl;
 }
 
@@ -176,6 +193,11 @@ void GGEMSMHDImage::Read(std::string const& image_mhd_header_filename, cl::Buffe
     else if (!kKey.compare("ElementDataFile")) {
       iss >> mhd_raw_file_;
     }
+    else if (!kKey.compare("BinaryDataByteOrderMSB") || !kKey.compare("ElementByteOrderMSB")) {
+      std::string byte_order("");
+      iss >> byte_order;
+      is_msb_ = !byte_order.compare("True") || !byte_order.compare("true");
+    }
   }
 
   // Closing the input header
@@ -206,6 +228,11 @@ void GGEMSMHDImage::Read(std::string const& image_mhd_header_filename, cl::Buffe
     GGEMSMisc::ThrowException("GGEMSMHDImage", "Read", oss.str());
   }
 
+  // Storing dimensions for raw data
+  dimensions_.x_ = static_cast<GGsize>(solid_data_device->number_of_voxels_xyz_.s[0]);
+  dimensions_.y_ = static_cast<GGsize>(solid_data_device->number_of_voxels_xyz_.s[1]);
+  dimensions_.z_ = static_cast<GGsize>(solid_data_device->number_of_voxels_xyz_.s[2]);
+
   // Computing bounding box borders automatically at isocenter
   for (GGsize i = 0; i < 3; ++i) {
     solid_data_device->obb_geometry_.border_min_xyz_.s[i] = -static_cast<GGfloat>(solid_data_device->number_of_voxels_xyz_.s[i]) * solid_data_device->voxel_sizes_xyz_.s[i] * 0.5f;
@@ -220,6 +247,99 @@ void GGEMSMHDImage::Read(std::string const& image_mhd_header_filename, cl::Buffe
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSMHDImage::MapRawData(GGsize const& size)
+{
+  GGcout("GGEMSMHDImage", "MapRawData", 3) << "Mapping raw data in memory..." << GGendl;
+
+  // Previous raw data
+  UnmapRawData();
+
+  std::string raw_filename = output_dir_ + mhd_raw_file_;
+  std::ostringstream oss(std::ostringstream::out);
+
+  #ifdef _WIN32
+  HANDLE file_handle = CreateFileA(raw_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file_handle == INVALID_HANDLE_VALUE) {
+    oss << "Problem reading filename '" << raw_filename << "'!!!";
+    GGEMSMisc::ThrowException("GGEMSMHDImage", "MapRawData", oss.str());
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle, &file_size) || static_cast<GGsize>(file_size.QuadPart) < size) {
+    CloseHandle(file_handle);
+    oss << "Raw file '" << raw_filename << "' is smaller than " << size << " bytes given by mhd header!!!";
+    GGEMSMisc::ThrowException("GGEMSMHDImage", "MapRawData", oss.str());
+  }
+
+  // Read-only pages, shared with page cache
+  HANDLE mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void* data = mapping_handle ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, size) : nullptr;
+  if (!data) {
+    if (mapping_handle) CloseHandle(mapping_handle);
+    CloseHandle(file_handle);
+    oss << "Problem mapping raw file '" << raw_filename << "'!!!";
+    GGEMSMisc::ThrowException("GGEMSMHDImage", "MapRawData", oss.str());
+  }
+
+  raw_file_handle_ = file_handle;
+  raw_mapping_handle_ = mapping_handle;
+  #else
+  GGint file_descriptor = ::open(raw_filename.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    oss << "Problem reading filename '" << raw_filename << "': " << strerror(errno);
+    GGEMSMisc::ThrowException("GGEMSMHDImage", "MapRawData", oss.str());
+  }
+
+  struct stat file_stat;
+  if (::fstat(file_descriptor, &file_stat) != 0 || static_cast<GGsize>(file_stat.st_size) < size) {
+    ::close(file_descriptor);
+    oss << "Raw file '" << raw_filename << "' is smaller than " << size << " bytes given by mhd header!!!";
+    GGEMSMisc::ThrowException("GGEMSMHDImage", "MapRawData", oss.str());
+  }
+
+  // Read-only pages, shared with page cache, mapping is kept after closing file
+  void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  ::close(file_descriptor);
+  if (data == MAP_FAILED) {
+    oss << "Problem mapping raw file '" << raw_filename << "': " << strerror(errno);
+    GGEMSMisc::ThrowException("GGEMSMHDImage", "MapRawData", oss.str());
+  }
+
+  // Raw data are read once from start to end
+  ::madvise(data, size, MADV_SEQUENTIAL);
+  ::madvise(data, size, MADV_WILLNEED);
+  #endif
+
+  raw_data_ = data;
+  raw_data_size_ = size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSMHDImage::UnmapRawData(void)
+{
+  if (!raw_data_) return;
+
+  #ifdef _WIN32
+  UnmapViewOfFile(raw_data_);
+  CloseHandle(static_cast<HANDLE>(raw_mapping_handle_));
+  CloseHandle(static_cast<HANDLE>(raw_file_handle_));
+  raw_mapping_handle_ = nullptr;
+  raw_file_handle_ = nullptr;
+  #else
+  ::munmap(raw_data_, raw_data_size_);
+  #endif
+
+  raw_data_ = nullptr;
+  raw_data_size_ = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSMHDImage::Write(cl::Buffer* image, GGsize const& thread_index) const
 {
   GGcout("GGEMSMHDImage", "Write", 1) << "Writing MHD Image: " <<  mhd_header_file_ << "..." << GGendl;
@@ -229,13 +349,7 @@ void GGEMSMHDImage::Write(cl::Buffer* image, GGsize const& thread_index) const
 
   // header data
   std::ofstream out_header_stream(mhd_header_file_, std::ios::out);
-  out_header_stream << "ObjectType = Image" << std::endl;
-  out_header_stream << "BinaryDataByteOrderMSB = False" << std::endl;
-  out_header_stream << "NDims = 3" << std::endl;
-  out_header_stream << "ElementSpacing = " << element_sizes_.s[0] << " " << element_sizes_.s[1] << " " << element_sizes_.s[2] << std::endl;
-  out_header_stream << "DimSize = " << dimensions_.x_ << " " << dimensions_.y_ << " " << dimensions_.z_ << std::endl;
-  out_header_stream << "ElementType = " << mhd_data_type_ << std::endl;
-  out_header_stream << "ElementDataFile = " << mhd_raw_file_ << std::endl;
+  out_header_stream << GetHeader();
   out_header_stream.close();
 
   // Writing raw data to file
@@ -253,6 +367,23 @@ void GGEMSMHDImage::Write(cl::Buffer* image, GGsize const& thread_index) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+std::string GGEMSMHDImage::GetHeader(void) const
+{
+  std::ostringstream header(std::ostringstream::out);
+  header << "ObjectType = Image" << std::endl;
+  header << "BinaryDataByteOrderMSB = " << (IsHostMSB() ? "True" : "False") << std::endl;
+  header << "NDims = 3" << std::endl;
+  header << "ElementSpacing = " << element_sizes_.s[0] << " " << element_sizes_.s[1] << " " << element_sizes_.s[2] << std::endl;
+  header << "DimSize = " << dimensions_.x_ << " " << dimensions_.y_ << " " << dimensions_.z_ << std::endl;
+  header << "ElementType = " << mhd_data_type_ << std::endl;
+  header << "ElementDataFile = " << mhd_raw_file_ << std::endl;
+  return header.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSMHDImage::CheckParameters(void) const
 {
   if (mhd_header_file_.empty()) {
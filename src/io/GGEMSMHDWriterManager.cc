@@ -0,0 +1,153 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSMHDWriterManager.cc
+
+  \brief GGEMS singleton writing MHD files in a background thread, host data of an image are written while the next image is read back from OpenCL devices
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include <fstream>
+#include <algorithm>
+
+#include "GGEMS/io/GGEMSMHDWriterManager.hh"
+#include "GGEMS/tools/GGEMSPrint.hh"
+#include "GGEMS/tools/GGEMSTools.hh"
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGEMSMHDWriterManager::GGEMSMHDWriterManager(void)
+: is_writing_(false),
+  is_stopped_(false),
+  error_("")
+{
+  GGcout("GGEMSMHDWriterManager", "GGEMSMHDWriterManager", 3) << "GGEMSMHDWriterManager creating..." << GGendl;
+
+  GGcout("GGEMSMHDWriterManager", "GGEMSMHDWriterManager", 3) << "GGEMSMHDWriterManager created!!!" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGEMSMHDWriterManager::~GGEMSMHDWriterManager(void)
+{
+  GGcout("GGEMSMHDWriterManager", "~GGEMSMHDWriterManager", 3) << "GGEMSMHDWriterManager erasing..." << GGendl;
+
+  // Files already pushed are written before stopping
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  job_condition_.notify_one();
+  if (writer_thread_.joinable()) writer_thread_.join();
+
+  GGcout("GGEMSMHDWriterManager", "~GGEMSMHDWriterManager", 3) << "GGEMSMHDWriterManager erased!!!" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSMHDWriterManager::Push(GGEMSMHDWriteJob const& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(job);
+    if (!writer_thread_.joinable()) writer_thread_ = std::thread(&GGEMSMHDWriterManager::WriteFiles, this);
+  }
+  job_condition_.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSMHDWriterManager::Wait(void)
+{
+  std::string error("");
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_condition_.wait(lock, [this] {return jobs_.empty() && !is_writing_;});
+    error.swap(error_);
+  }
+
+  if (!error.empty()) GGEMSMisc::ThrowException("GGEMSMHDWriterManager", "Wait", error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSMHDWriterManager::WriteFiles(void)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    job_condition_.wait(lock, [this] {return !jobs_.empty() || is_stopped_;});
+    if (jobs_.empty()) break; // Stopped and nothing left to write
+
+    GGEMSMHDWriteJob job = jobs_.front();
+    jobs_.pop_front();
+    is_writing_ = true;
+
+    // Writing without lock, next images are pushed meanwhile
+    lock.unlock();
+    std::string error = WriteFile(job);
+    job.data_.reset();
+    lock.lock();
+
+    if (!error.empty()) error_ += error;
+    is_writing_ = false;
+    done_condition_.notify_all();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSMHDWriterManager::WriteFile(GGEMSMHDWriteJob const& job) const
+{
+  GGcout("GGEMSMHDWriterManager", "WriteFile", 1) << "Writing MHD Image " << job.header_filename_ << "..." << GGendl;
+
+  // header data
+  std::ofstream out_header_stream(job.header_filename_, std::ios::out);
+  out_header_stream << job.header_;
+  out_header_stream.close();
+  if (!out_header_stream) return "Problem writing filename '" + job.header_filename_ + "'!!! ";
+
+  // raw data, written by blocks of 64 MB bypassing stream buffer
+  GGsize const kBlockSize = 64 * 1024 * 1024;
+  std::ofstream out_raw_stream(job.raw_filename_, std::ios::out | std::ios::binary);
+  char const* data = static_cast<char const*>(job.data_.get());
+  for (GGsize offset = 0; offset < job.size_ && out_raw_stream; offset += kBlockSize) {
+    out_raw_stream.write(data + offset, static_cast<std::streamsize>(std::min(kBlockSize, job.size_ - offset)));
+  }
+  out_raw_stream.close();
+  if (!out_raw_stream) return "Problem writing filename '" + job.raw_filename_ + "'!!! ";
+
+  return "";
+}
@@ -0,0 +1,78 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file BenchmarkDoseScoring.cl
+
+  \brief OpenCL kernel measuring dose scoring when all work-items deposit in a few dosels
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/navigators/GGEMSDoseRecording.hh"
+#include "GGEMS/tools/GGEMSSystemOfUnits.hh"
+
+/*!
+  \fn kernel void benchmark_dose_scoring(GGsize const number_of_work_items, GGint const deposits_per_work_item, global GGEMSDoseParams* dose_params, global GGEdepType* edep_tracking, global GGEdepType* edep_squared_tracking, global GGint* hit_tracking)
+  \param number_of_work_items - number of work-items doing deposits
+  \param deposits_per_work_item - number of deposits by work-item
+  \param dose_params - params of the hot-spot dosemap
+  \param edep_tracking - buffer storing energy deposit
+  \param edep_squared_tracking - buffer storing energy deposit squared
+  \param hit_tracking - buffer storing hits
+  \brief scoring deposits between 1 keV and 100 keV at the center of pseudo random dosels of a small dosemap
+*/
+kernel void benchmark_dose_scoring(
+  GGsize const number_of_work_items,
+  GGint const deposits_per_work_item,
+  global GGEMSDoseParams* dose_params,
+  global GGEdepType* edep_tracking,
+  global GGEdepType* edep_squared_tracking,
+  global GGint* hit_tracking
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+  if (global_id >= number_of_work_items) return;
+
+  GGint3 number_of_dosels = dose_params->number_of_dosels_;
+
+  GGuint hash = (GGuint)global_id * 2654435761u + 1u;
+  for (GGint i = 0; i < deposits_per_work_item; ++i) {
+    // Dosel drawn with xorshift
+    hash ^= hash << 13;
+    hash ^= hash >> 17;
+    hash ^= hash << 5;
+    GGint dosel_id = (GGint)(hash % (GGuint)dose_params->total_number_of_dosels_);
+    GGint3 dosel_xyz = (GGint3)(
+      dosel_id % number_of_dosels.x,
+      (dosel_id / number_of_dosels.x) % number_of_dosels.y,
+      dosel_id / dose_params->slice_number_of_dosels_
+    );
+
+    // Energy from high bits, dosel from low bits
+    GGfloat edep = (1.0f + (GGfloat)(hash >> 8) * (99.0f / 16777216.0f)) * keV;
+
+    GGfloat3 position = dose_params->border_min_xyz_ + (convert_float3(dosel_xyz) + 0.5f) * dose_params->size_of_dosels_;
+    dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, edep, &position);
+  }
+}
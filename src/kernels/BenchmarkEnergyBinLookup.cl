@@ -0,0 +1,73 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file BenchmarkEnergyBinLookup.cl
+
+  \brief OpenCL kernel measuring lookups of energy bin in cross section table
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/physics/GGEMSParticleCrossSections.hh"
+#include "GGEMS/maths/GGEMSMathAlgorithms.hh"
+
+/*!
+  \fn kernel void benchmark_energy_bin_lookup(GGsize const number_of_work_items, GGint const lookups_per_work_item, global GGEMSParticleCrossSections const* particle_cross_sections, GGchar const is_log_uniform, global GGint* checksum)
+  \param number_of_work_items - number of work-items doing lookups
+  \param lookups_per_work_item - number of lookups by work-item
+  \param particle_cross_sections - pointer to cross sections
+  \param is_log_uniform - 1 for LogUniformBinIndex, 0 for BinarySearchLeft
+  \param checksum - sum of found indices, identical for both lookups
+  \brief looking for energy bin of pseudo random energies in cross section table
+*/
+kernel void benchmark_energy_bin_lookup(
+  GGsize const number_of_work_items,
+  GGint const lookups_per_work_item,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  GGchar const is_log_uniform,
+  global GGint* checksum
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+  if (global_id >= number_of_work_items) return;
+
+  GGint number_of_bins = particle_cross_sections->number_of_bins_;
+  GGfloat log_min_energy = particle_cross_sections->log_min_energy_;
+  GGfloat inverse_log_energy_step = particle_cross_sections->inverse_log_energy_step_;
+
+  GGuint hash = (GGuint)global_id * 2654435761u + 1u;
+  GGint index_sum = 0;
+  for (GGint i = 0; i < lookups_per_work_item; ++i) {
+    // Energy spread over the whole table (xorshift)
+    hash ^= hash << 13;
+    hash ^= hash >> 17;
+    hash ^= hash << 5;
+    GGfloat energy = exp(log_min_energy + (GGfloat)(hash >> 8) * (1.0f / 16777216.0f) * (GGfloat)(number_of_bins - 1) / inverse_log_energy_step);
+
+    if (is_log_uniform) index_sum += LogUniformBinIndex(energy, particle_cross_sections->energy_bins_, number_of_bins, log_min_energy, inverse_log_energy_step);
+    else index_sum += BinarySearchLeft(energy, particle_cross_sections->energy_bins_, number_of_bins, 0, 0);
+  }
+
+  atomic_add(checksum, index_sum);
+}
@@ -0,0 +1,144 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file BenchmarkFindSolid.cl
+
+  \brief OpenCL kernels finding the closest solid of a ring of CT modules, testing solids one by one or traversing a BVH
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/global/GGEMSConstants.hh"
+#include "GGEMS/geometries/GGEMSRayTracing.hh"
+
+/*!
+  \fn inline void BenchmarkRay(GGsize const ray_id, GGfloat3* position, GGfloat3* direction)
+  \param ray_id - index of ray
+  \param position - start position of ray, near the center of the ring
+  \param direction - direction of ray, close to the plane of the ring
+  \brief generate the same ray from its index in all the kernels (xorshift)
+*/
+inline void BenchmarkRay(GGsize const ray_id, GGfloat3* position, GGfloat3* direction)
+{
+  GGuint hash = (GGuint)ray_id * 2654435761u + 1u;
+  GGfloat random[5];
+  for (GGint i = 0; i < 5; ++i) {
+    hash ^= hash << 13;
+    hash ^= hash >> 17;
+    hash ^= hash << 5;
+    random[i] = (GGfloat)(hash >> 8) * (1.0f / 16777216.0f);
+  }
+
+  *position = ((GGfloat3)(random[0], random[1], random[2]) - 0.5f) * 100.0f*mm;
+
+  GGfloat cos_theta = 0.04f * random[3] - 0.02f;
+  GGfloat sin_theta = sqrt(1.0f - cos_theta * cos_theta);
+  GGfloat phi = TWO_PI * random[4];
+  *direction = (GGfloat3)(sin_theta * cos(phi), sin_theta * sin(phi), cos_theta);
+}
+
+/*!
+  \fn kernel void benchmark_find_solid_linear(GGsize const number_of_rays, GGint const first_solid, GGint const number_of_solids, global GGEMSBVHSolid const* solids, global GGfloat* closest_distance, global GGint* closest_solid_id)
+  \param number_of_rays - number of rays, 1 ray by work-item
+  \param first_solid - first tested solid, closest solid of previous launches is read if not 0
+  \param number_of_solids - number of solids tested in this launch
+  \param solids - solids of the ring
+  \param closest_distance - distance to closest solid of each ray
+  \param closest_solid_id - index of closest solid of each ray
+  \brief testing solids one by one, as a navigator does with one distance kernel launch per solid
+*/
+kernel void benchmark_find_solid_linear(
+  GGsize const number_of_rays,
+  GGint const first_solid,
+  GGint const number_of_solids,
+  global GGEMSBVHSolid const* solids,
+  global GGfloat* closest_distance,
+  global GGint* closest_solid_id
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+  if (global_id >= number_of_rays) return;
+
+  GGfloat distance_min = OUT_OF_WORLD;
+  GGint solid_id = -1;
+  if (first_solid > 0) {
+    distance_min = closest_distance[global_id];
+    solid_id = closest_solid_id[global_id];
+  }
+
+  // Ray already inside a solid
+  if (distance_min == 0.0f) return;
+
+  GGfloat3 position, direction;
+  BenchmarkRay(global_id, &position, &direction);
+
+  for (GGint i = first_solid; i < first_solid + number_of_solids; ++i) {
+    if (IsParticleInOBB(&position, &solids[i].obb_geometry_)) {
+      distance_min = 0.0f;
+      solid_id = solids[i].solid_id_;
+      break;
+    }
+
+    GGfloat distance = ComputeDistanceToOBB(&position, &direction, &solids[i].obb_geometry_);
+    if (distance < distance_min) {
+      distance_min = distance;
+      solid_id = solids[i].solid_id_;
+    }
+  }
+
+  closest_distance[global_id] = distance_min;
+  closest_solid_id[global_id] = solid_id;
+}
+
+/*!
+  \fn kernel void benchmark_find_solid_bvh(GGsize const number_of_rays, global GGEMSBVHNode const* bvh_nodes, global GGEMSBVHSolid const* bvh_solids, global GGfloat* closest_distance, global GGint* closest_solid_id)
+  \param number_of_rays - number of rays, 1 ray by work-item
+  \param bvh_nodes - nodes of BVH built over the ring
+  \param bvh_solids - solids of the ring
+  \param closest_distance - distance to closest solid of each ray
+  \param closest_solid_id - index of closest solid of each ray
+  \brief finding the closest solid by traversing the BVH, as GGEMSNavigatorManager::FindSolid does
+*/
+kernel void benchmark_find_solid_bvh(
+  GGsize const number_of_rays,
+  global GGEMSBVHNode const* bvh_nodes,
+  global GGEMSBVHSolid const* bvh_solids,
+  global GGfloat* closest_distance,
+  global GGint* closest_solid_id
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+  if (global_id >= number_of_rays) return;
+
+  GGfloat3 position, direction;
+  BenchmarkRay(global_id, &position, &direction);
+
+  GGfloat distance_min = OUT_OF_WORLD;
+  GGint solid_id = -1;
+  FindClosestSolidInBVH(&position, &direction, bvh_nodes, bvh_solids, &distance_min, &solid_id);
+
+  closest_distance[global_id] = distance_min;
+  closest_solid_id[global_id] = solid_id;
+}
@@ -0,0 +1,94 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file BenchmarkLabelLayout.cl
+
+  \brief OpenCL kernel measuring reads of label data along rays in a voxelized solid
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/global/GGEMSConstants.hh"
+#include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
+
+/*!
+  \fn kernel void benchmark_label_layout(GGsize const number_of_rays, GGint const steps_per_ray, GGint3 const number_of_voxels, GGint const label_layout, GGchar const direction_mode, global GGuchar const* label_data, global GGint* checksum)
+  \param number_of_rays - number of rays, 1 ray by work-item
+  \param steps_per_ray - number of voxels read by ray
+  \param number_of_voxels - number of voxels in X, Y and Z
+  \param label_layout - layout of label data
+  \param direction_mode - 0 for isotropic directions, 1 for beam along X, 2 for beam along Z
+  \param label_data - label data stored in label_layout
+  \param checksum - sum of read labels, identical for all layouts
+  \brief walking through label data along rays, a ray leaving the volume enters it again on the opposite side
+*/
+kernel void benchmark_label_layout(
+  GGsize const number_of_rays,
+  GGint const steps_per_ray,
+  GGint3 const number_of_voxels,
+  GGint const label_layout,
+  GGchar const direction_mode,
+  global GGuchar const* label_data,
+  global GGint* checksum
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+  if (global_id >= number_of_rays) return;
+
+  GGfloat3 volume_size = convert_float3(number_of_voxels);
+
+  // Start position and direction of ray (xorshift)
+  GGuint hash = (GGuint)global_id * 2654435761u + 1u;
+  GGfloat random[5];
+  for (GGint i = 0; i < 5; ++i) {
+    hash ^= hash << 13;
+    hash ^= hash >> 17;
+    hash ^= hash << 5;
+    random[i] = (GGfloat)(hash >> 8) * (1.0f / 16777216.0f);
+  }
+
+  GGfloat3 position = (GGfloat3)(random[0], random[1], random[2]) * volume_size;
+  GGfloat3 direction = (GGfloat3)(1.0f, 0.0f, 0.0f);
+  if (direction_mode == 0) {
+    GGfloat cos_theta = 2.0f * random[3] - 1.0f;
+    GGfloat sin_theta = sqrt(1.0f - cos_theta * cos_theta);
+    GGfloat phi = TWO_PI * random[4];
+    direction = (GGfloat3)(sin_theta * cos(phi), sin_theta * sin(phi), cos_theta);
+  }
+  else if (direction_mode == 2) {
+    direction = (GGfloat3)(0.0f, 0.0f, 1.0f);
+  }
+
+  GGint label_sum = 0;
+  for (GGint i = 0; i < steps_per_ray; ++i) {
+    GGint3 voxel_id = clamp(convert_int3(position), (GGint3)(0), number_of_voxels - (GGint3)(1));
+    label_sum += label_data[LabelIndex(label_layout, voxel_id.x, voxel_id.y, voxel_id.z, number_of_voxels.x, number_of_voxels.y)];
+
+    // Moving 1 voxel along direction, periodic volume
+    position += direction;
+    position -= floor(position / volume_size) * volume_size;
+  }
+
+  atomic_add(checksum, label_sum);
+}
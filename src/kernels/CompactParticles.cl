@@ -0,0 +1,188 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file CompactParticles.cl
+
+  \brief OpenCL kernels building a dense list of live particles using a prefix sum
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+#include "GGEMS/physics/GGEMSParticleConstants.hh"
+
+/*!
+  \fn inline void LocalInclusiveScan(local GGint* local_scan)
+  \param local_scan - local buffer to scan, one element per work-item
+  \brief inclusive prefix sum in work-group (Hillis-Steele), all work-items of work-group must call it
+*/
+inline void LocalInclusiveScan(local GGint* local_scan)
+{
+  GGsize local_id = get_local_id(0);
+  GGsize local_size = get_local_size(0);
+
+  for (GGsize offset = 1; offset < local_size; offset <<= 1) {
+    GGint value = local_id >= offset ? local_scan[local_id - offset] : 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    local_scan[local_id] += value;
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn kernel void count_live_particles(GGsize const particle_id_limit, global GGEMSPrimaryParticles const* primary_particle, global GGint* block_count, local GGint* local_count)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer on primary particles
+  \param block_count - number of live particles in each work-group
+  \param local_count - local buffer storing number of live particles in work-group
+  \brief first pass of compaction, counting live particles in each work-group
+*/
+kernel void count_live_particles(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles const* primary_particle,
+  global GGint* block_count,
+  local GGint* local_count
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+  GGsize local_id = get_local_id(0);
+
+  // No return before barrier, work-items out of particle limit count 0
+  local_count[local_id] = (global_id < particle_id_limit && primary_particle->status_[global_id] != DEAD) ? 1 : 0;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // Reduction in work-group, work-group size is a power of 2
+  for (GGsize stride = get_local_size(0)/2; stride > 0; stride >>= 1) {
+    if (local_id < stride) local_count[local_id] += local_count[local_id + stride];
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (local_id == 0) block_count[get_group_id(0)] = local_count[0];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn kernel void scan_live_blocks(GGsize const number_of_blocks, global GGint* block_count, GGsize const count_offset, GGsize const sum_offset, global GGint* live_counter, local GGint* local_scan)
+  \param number_of_blocks - number of counts at this level of prefix sum
+  \param block_count - counts of all levels, counts of this level are replaced by exclusive prefix sum in work-group
+  \param count_offset - index of first count of this level in block_count
+  \param sum_offset - index of first count of next level in block_count, receiving the sum of each work-group
+  \param live_counter - total number of live particles, written if a single work-group is launched (last level)
+  \param local_scan - local buffer for prefix sum
+  \brief second pass of compaction, a level of hierarchical prefix sum of work-group counts
+*/
+kernel void scan_live_blocks(
+  GGsize const number_of_blocks,
+  global GGint* block_count,
+  GGsize const count_offset,
+  GGsize const sum_offset,
+  global GGint* live_counter,
+  local GGint* local_scan
+)
+{
+  GGsize global_id = get_global_id(0);
+  GGsize local_id = get_local_id(0);
+  GGsize local_size = get_local_size(0);
+
+  // No return before barrier, work-items out of counts add 0
+  GGint count = global_id < number_of_blocks ? block_count[count_offset + global_id] : 0;
+  local_scan[local_id] = count;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  LocalInclusiveScan(local_scan);
+
+  // Storing exclusive prefix sum in work-group
+  if (global_id < number_of_blocks) block_count[count_offset + global_id] = local_scan[local_id] - count;
+
+  // Sum of work-group for next level, or total at last level
+  if (local_id == local_size - 1) {
+    if (get_num_groups(0) == 1) live_counter[0] = local_scan[local_id];
+    else block_count[sum_offset + get_group_id(0)] = local_scan[local_id];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn kernel void add_live_block_offsets(GGsize const number_of_blocks, global GGint* block_count, GGsize const count_offset, GGsize const sum_offset)
+  \param number_of_blocks - number of counts at this level of prefix sum
+  \param block_count - counts of all levels
+  \param count_offset - index of first count of this level in block_count
+  \param sum_offset - index of first count of next level in block_count, already scanned
+  \brief third pass of compaction, adding offset of work-group from next level, prefix sum of this level becomes global
+*/
+kernel void add_live_block_offsets(
+  GGsize const number_of_blocks,
+  global GGint* block_count,
+  GGsize const count_offset,
+  GGsize const sum_offset
+)
+{
+  GGsize global_id = get_global_id(0);
+  if (global_id >= number_of_blocks) return;
+
+  block_count[count_offset + global_id] += block_count[sum_offset + get_group_id(0)];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn kernel void compact_live_particles(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGint const* block_offset, local GGint* local_scan)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer on primary particles
+  \param block_offset - index of first live particle of each work-group in dense list
+  \param local_scan - local buffer for prefix sum
+  \brief last pass of compaction, writing index of live particles in dense list, order of particles is preserved
+*/
+kernel void compact_live_particles(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGint const* block_offset,
+  local GGint* local_scan
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+  GGsize local_id = get_local_id(0);
+
+  // No return before barrier, work-items out of particle limit are not live
+  GGint is_live = (global_id < particle_id_limit && primary_particle->status_[global_id] != DEAD) ? 1 : 0;
+  local_scan[local_id] = is_live;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  LocalInclusiveScan(local_scan);
+
+  if (is_live) primary_particle->live_index_[block_offset[get_group_id(0)] + local_scan[local_id] - 1] = (GGint)global_id;
+}
@@ -34,7 +34,7 @@
 #include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
 
 /*!
-  \fn kernel void compute_dose_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGDosiType const* edep, global GGint const* hit, global GGDosiType const* edep_squared, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSMaterialTables const* materials, global GGfloat* dose, global GGfloat* uncertainty, GGfloat const scale_factor, GGchar const is_water_reference, GGfloat const minimum_density)
+  \fn kernel void compute_dose_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGEdepType const* edep, global GGint const* hit, global GGEdepType const* edep_squared, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSMaterialTables const* materials, global GGfloat* dose, global GGfloat* uncertainty, GGfloat const scale_factor, GGchar const is_water_reference, GGfloat const minimum_density)
   \param dosel_id_limit - number total of dosels
   \param dose_params - params about dosemap
   \param edep - buffer storing energy deposit
@@ -53,9 +53,9 @@
 kernel void compute_dose_ggems_voxelized_solid(
   GGsize const dosel_id_limit,
   global GGEMSDoseParams const* dose_params,
-  global GGDosiType const* edep,
+  global GGEdepType const* edep,
   global GGint const* hit,
-  global GGDosiType const* edep_squared,
+  global GGEdepType const* edep_squared,
   global GGEMSVoxelizedSolidData const* voxelized_solid_data,
   global GGuchar const* label_data,
   global GGEMSMaterialTables const* materials,
@@ -84,11 +84,12 @@ kernel void compute_dose_ggems_voxelized_solid(
   GGint3 voxel_id = convert_int3((dosel_pos - voxelized_solid_data->obb_geometry_.border_min_xyz_) / voxelized_solid_data->voxel_sizes_xyz_);
 
   // Get the material that compose this volume
-  GGuchar material_id = label_data[
-    voxel_id.x +
-    voxel_id.y * voxelized_solid_data->number_of_voxels_xyz_.x +
-    voxel_id.z * voxelized_solid_data->number_of_voxels_xyz_.x * voxelized_solid_data->number_of_voxels_xyz_.y
-  ];
+  GGuchar material_id = label_data[LabelIndex(
+    voxelized_solid_data->label_layout_,
+    voxel_id.x, voxel_id.y, voxel_id.z,
+    voxelized_solid_data->number_of_voxels_xyz_.x,
+    voxelized_solid_data->number_of_voxels_xyz_.y
+  )];
 
   // Compute volume of dosel
   GGfloat dosel_vol = dose_params->size_of_dosels_.x * dose_params->size_of_dosels_.y * dose_params->size_of_dosels_.z;
@@ -96,8 +97,15 @@ kernel void compute_dose_ggems_voxelized_solid(
   // Get density
   GGfloat density = is_water_reference ? 1.0f * (g/cm3) : materials->density_of_material_[material_id];
 
+  // Energy deposit in dosel, converted from number of quanta with fixed-point scoring
+  #ifdef DOSE_FIXED_POINT
+  GGDosiType edep_dosel = (GGDosiType)edep[global_id] * (GGDosiType)dose_params->edep_quantum_;
+  #else
+  GGDosiType edep_dosel = edep[global_id];
+  #endif
+
   // Apply threshold on density and computing dose
-  dose[global_id] = density < minimum_density ? 0.0f : scale_factor * edep[global_id] / density / dosel_vol / Gy;
+  dose[global_id] = density < minimum_density ? 0.0f : scale_factor * edep_dosel / density / dosel_vol / Gy;
 
   // Relative statistical uncertainty (from Ma et al. PMB 47 2002 p1671)
   //              /                                    \ ^1/2
@@ -110,9 +118,14 @@ kernel void compute_dose_ggems_voxelized_solid(
 
   // Computing uncertainty
   if (uncertainty) {
-    if (hit[global_id] > 1 && edep[global_id] != 0.0) {
-      GGDosiType sum_edep_2 = edep[global_id] * edep[global_id];
-      uncertainty[global_id] = sqrt((hit[global_id]*edep_squared[global_id] - sum_edep_2) / ((hit[global_id]-1) * sum_edep_2));
+    if (hit[global_id] > 1 && edep_dosel != 0.0) {
+      #ifdef DOSE_FIXED_POINT
+      GGDosiType edep_squared_dosel = (GGDosiType)edep_squared[global_id] * (GGDosiType)dose_params->edep_quantum_ * (GGDosiType)dose_params->edep_quantum_;
+      #else
+      GGDosiType edep_squared_dosel = edep_squared[global_id];
+      #endif
+      GGDosiType sum_edep_2 = edep_dosel * edep_dosel;
+      uncertainty[global_id] = sqrt((hit[global_id]*edep_squared_dosel - sum_edep_2) / ((hit[global_id]-1) * sum_edep_2));
     }
     else {
       uncertainty[global_id] = 1.0f;
@@ -36,7 +36,7 @@
 #include "GGEMS/physics/GGEMSProcessConstants.hh"
 
 /*!
-  \fn kernel void get_primaries_ggems_xray_source(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGchar const particle_name, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const aperture, GGfloat3 const focal_spot_size, global GGfloat44 const* matrix_transformation)
+  \fn kernel void get_primaries_ggems_xray_source(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGchar const particle_name, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const aperture, GGfloat3 const focal_spot_size, global GGfloat44 const* matrix_transformation, global GGEMSParticleTrajectories* trajectories)
   \param particle_id_limit - particle id limit
   \param primary_particle - buffer of primary particles
   \param random - buffer for random number
@@ -47,6 +47,7 @@
   \param aperture - source aperture
   \param focal_spot_size - focal spot size of xray-source
   \param matrix_transformation - matrix storing information about axis
+  \param trajectories - pointer to interactions of displayed particles, only with OpenGL
   \brief Generate primaries for xray source
 */
 kernel void get_primaries_ggems_xray_source(
@@ -60,6 +61,9 @@ kernel void get_primaries_ggems_xray_source(
   GGfloat const aperture,
   GGfloat3 const focal_spot_size,
   global GGfloat44 const* matrix_transformation
+  #ifdef OPENGL
+  ,global GGEMSParticleTrajectories* trajectories
+  #endif
 )
 {
   // Get the index of thread
@@ -68,9 +72,19 @@ kernel void get_primaries_ggems_xray_source(
   // Return if index > to particle limit
   if (global_id >= particle_id_limit) return;
 
+  // Random numbers of the particle: angles, position in focal spot and energy
+  GGfloat rndm[6];
+  #ifdef PHILOX_RANDOM
+  GGEMSPhiloxState random_state = LoadPhiloxState(random, global_id);
+  for (GGint i = 0; i < 6; ++i) rndm[i] = PhiloxUniform(&random_state);
+  StorePhiloxState(random, &random_state, global_id);
+  #else
+  for (GGint i = 0; i < 6; ++i) rndm[i] = KissUniform(random, global_id);
+  #endif
+
   // Get random angles
-  GGdouble phi = KissUniform(random, global_id);
-  GGdouble theta = KissUniform(random, global_id);
+  GGdouble phi = rndm[0];
+  GGdouble theta = rndm[1];
 
   phi *= (GGdouble)TWO_PI;
   GGdouble new_aperture = 1.0 - cos((GGdouble)aperture);
@@ -95,15 +109,15 @@ kernel void get_primaries_ggems_xray_source(
   direction = normalize(direction);
 
   // Position with focal (local)
-  global_position.x = focal_spot_size.x * (KissUniform(random, global_id) - 0.5f);
-  global_position.y = focal_spot_size.y * (KissUniform(random, global_id) - 0.5f);
-  global_position.z = focal_spot_size.z * (KissUniform(random, global_id) - 0.5f);
+  global_position.x = focal_spot_size.x * (rndm[2] - 0.5f);
+  global_position.y = focal_spot_size.y * (rndm[3] - 0.5f);
+  global_position.z = focal_spot_size.z * (rndm[4] - 0.5f);
 
   // Apply transformation (local to global frame)
   global_position = LocalToGlobalPosition(matrix_transformation, &global_position);
 
   // Getting a random energy
-  GGfloat rndm_for_energy = KissUniform(random, global_id);
+  GGfloat rndm_for_energy = rndm[5];
 
   // Get index in cdf
   GGint index_for_energy = BinarySearchLeft(rndm_for_energy, cdf, number_of_energy_bins, 0, 0);
@@ -136,32 +150,32 @@ kernel void get_primaries_ggems_xray_source(
   #ifdef OPENGL
   // Storing vertex position for OpenGL
   if (global_id < MAXIMUM_DISPLAYED_PARTICLES) {
-    primary_particle->stored_particles_gl_[global_id] = 0;
+    trajectories->stored_particles_gl_[global_id] = 0;
 
     for (GGint i = 0; i < MAXIMUM_INTERACTIONS; ++i) {
-      primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS+i] = 0.0f;
-      primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS+i] = 0.0f;
-      primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS+i] = 0.0f;
+      trajectories->px_gl_[global_id*MAXIMUM_INTERACTIONS+i] = 0.0f;
+      trajectories->py_gl_[global_id*MAXIMUM_INTERACTIONS+i] = 0.0f;
+      trajectories->pz_gl_[global_id*MAXIMUM_INTERACTIONS+i] = 0.0f;
     }
 
     // Storing OpenGL index on OpenCL private memory
-    //GGint stored_particles_gl = primary_particle->stored_particles_gl_[global_id];
+    //GGint stored_particles_gl = trajectories->stored_particles_gl_[global_id];
 
     // Checking if buffer is full
    // if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
 
-      primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->px_[global_id];
-      primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->py_[global_id];
-      primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->pz_[global_id];
+      trajectories->px_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->px_[global_id];
+      trajectories->py_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->py_[global_id];
+      trajectories->pz_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->pz_[global_id];
       //stored_particles_gl += 1;
 
-      // primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] += primary_particle->dx_[global_id]*2.0f*m;
-      // primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] += primary_particle->dy_[global_id]*2.0f*m;
-      // primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] += primary_particle->dz_[global_id]*2.0f*m;
+      // trajectories->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] += primary_particle->dx_[global_id]*2.0f*m;
+      // trajectories->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] += primary_particle->dy_[global_id]*2.0f*m;
+      // trajectories->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] += primary_particle->dz_[global_id]*2.0f*m;
       // stored_particles_gl += 1;
 
       // Storing final index
-      primary_particle->stored_particles_gl_[global_id] = 1;
+      trajectories->stored_particles_gl_[global_id] = 1;
     //}
   }
   #endif
@@ -0,0 +1,100 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file InitializeBatchRandom.cl
+
+  \brief OpenCL kernel initializing a deterministic random substream for each particle of a batch
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/randoms/GGEMSRandom.hh"
+
+/*!
+  \fn inline GGuint HashRandomState(GGuint x)
+  \param x - value to hash
+  \return hashed value
+  \brief 32 bits integer hash (finalizer of MurmurHash3)
+*/
+inline GGuint HashRandomState(GGuint x)
+{
+  x ^= x >> 16;
+  x *= 0x85ebca6bu;
+  x ^= x >> 13;
+  x *= 0xc2b2ae35u;
+  x ^= x >> 16;
+  return x;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn kernel void initialize_batch_random(GGsize const particle_id_limit, global GGEMSRandom* random, GGuint const seed, GGuint const source_index, GGsize const first_particle)
+  \param particle_id_limit - particle id limit
+  \param random - pointer on random numbers
+  \param seed - initial seed of GGEMS
+  \param source_index - index of the source
+  \param first_particle - index of first particle of batch in source
+  \brief state of JKISS engine (or key of Philox engine) depends only on seed, source and index of particle in source, so results do not depend on device and batch size
+*/
+kernel void initialize_batch_random(
+  GGsize const particle_id_limit,
+  global GGEMSRandom* random,
+  GGuint const seed,
+  GGuint const source_index,
+  GGsize const first_particle
+)
+{
+  // Getting index of thread
+  GGsize global_id = get_global_id(0);
+
+  // Return if index > to particle limit
+  if (global_id >= particle_id_limit) return;
+
+  #ifdef PHILOX_RANDOM
+  // Counter-based engine, key of the batch and no draw for each particle
+  if (global_id == 0) {
+    random->first_particle_ = first_particle;
+    random->key_[0] = seed;
+    random->key_[1] = source_index;
+  }
+  random->counter_[global_id] = 0;
+  #else
+  // Key of the substream
+  GGsize particle_index = first_particle + global_id;
+  GGuint key = HashRandomState(seed ^ HashRandomState(source_index + 0x9e3779b9u));
+  key = HashRandomState(key ^ (GGuint)(particle_index & 0xffffffffu));
+  key = HashRandomState(key ^ (GGuint)(particle_index >> 32));
+
+  random->prng_state_1_[global_id] = HashRandomState(key + 0x9e3779b9u);
+  random->prng_state_2_[global_id] = HashRandomState(key + 0x3c6ef372u);
+  random->prng_state_3_[global_id] = HashRandomState(key + 0xdaa66d2bu);
+  random->prng_state_4_[global_id] = HashRandomState(key + 0x78dde6e4u);
+  random->prng_state_5_[global_id] = 0;
+
+  // Xorshift state must not be 0
+  if (random->prng_state_2_[global_id] == 0) random->prng_state_2_[global_id] = 0x9e3779b9u;
+  #endif
+}
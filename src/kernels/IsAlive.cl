@@ -32,23 +32,33 @@
 #include "GGEMS/physics/GGEMSParticleConstants.hh"
 
 /*!
-  \fn kernel void is_alive(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGint* status)
+  \fn kernel void is_alive(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGint* alive_counter, local GGint* local_alive)
   \param particle_id_limit - particle id limit
   \param primary_particle - pointer on primary particles
-  \param status - status of particle
-  \brief checking if particle is alive
+  \param alive_counter - number of alive particles
+  \param local_alive - local buffer storing number of alive particles in work-group
+  \brief counting alive particles, reduction in work-group and one atomic operation per work-group
 */
 kernel void is_alive(
   GGsize const particle_id_limit,
   global GGEMSPrimaryParticles* primary_particle,
-  global GGint* status
+  global GGint* alive_counter,
+  local GGint* local_alive
 )
 {
   // Get the index of thread
   GGsize global_id = get_global_id(0);
+  GGsize local_id = get_local_id(0);
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // No return before barrier, work-items out of particle limit count 0
+  local_alive[local_id] = (global_id < particle_id_limit && primary_particle->status_[global_id] != DEAD) ? 1 : 0;
+  barrier(CLK_LOCAL_MEM_FENCE);
 
-  atomic_add(&status[0], primary_particle->status_[global_id]);
+  // Reduction in work-group, work-group size is a power of 2
+  for (GGsize stride = get_local_size(0)/2; stride > 0; stride >>= 1) {
+    if (local_id < stride) local_alive[local_id] += local_alive[local_id + stride];
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (local_id == 0 && local_alive[0] > 0) atomic_add(&alive_counter[0], local_alive[0]);
 }
@@ -0,0 +1,100 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file ParticleSolidDistanceGGEMSBVH.cl
+
+  \brief OpenCL kernel computing distance between particles and all the solids of navigators using a BVH
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+
+#include "GGEMS/geometries/GGEMSRayTracing.hh"
+
+/*!
+  \fn kernel void particle_solid_distance_ggems_bvh(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSBVHNode const* bvh_nodes, global GGEMSBVHSolid const* bvh_solids)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param bvh_nodes - pointer to nodes of BVH, root is the first node
+  \param bvh_solids - pointer to solids referenced by BVH leaves, stored in navigator order
+  \brief OpenCL kernel finding the closest solid, selected solid is the same than testing solids one by one in navigator order
+*/
+kernel void particle_solid_distance_ggems_bvh(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSBVHNode const* bvh_nodes,
+  global GGEMSBVHSolid const* bvh_solids
+)
+{
+  // Getting index of thread
+  GGsize global_id = get_global_id(0);
+
+  // Return if index > to particle limit
+  if (global_id >= particle_id_limit) return;
+
+  #ifdef PARTICLE_COMPACTION
+  // Thread index to index of live particle, list built by compaction stage
+  global_id = primary_particle->live_index_[global_id];
+  #endif
+
+  // Checking particle status. If DEAD, the particle is not track
+  if (primary_particle->status_[global_id] == DEAD) return;
+
+  // Closest solid found before this kernel
+  GGfloat closest_distance = primary_particle->particle_solid_distance_[global_id];
+  GGint closest_solid_id = primary_particle->solid_id_[global_id];
+
+  // Checking if the particle - solid is 0. If yes the particle is already in a solid
+  if (closest_distance == 0.0f) return;
+
+  // Position of particle
+  GGfloat3 position = {
+    primary_particle->px_[global_id],
+    primary_particle->py_[global_id],
+    primary_particle->pz_[global_id]
+  };
+
+  // Direction of particle
+  GGfloat3 direction = {
+    primary_particle->dx_[global_id],
+    primary_particle->dy_[global_id],
+    primary_particle->dz_[global_id]
+  };
+
+  // Traversing BVH
+  FindClosestSolidInBVH(&position, &direction, bvh_nodes, bvh_solids, &closest_distance, &closest_solid_id);
+
+  #ifdef GGEMS_TRACKING
+  if (global_id == primary_particle->particle_tracking_id) {
+    printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_bvh] --------------------------------------------------------------------------------\n");
+    printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_bvh] Find a closest solid\n");
+    printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_bvh] Particle id: %d\n", global_id);
+    printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_bvh] Closest solid, id: %d\n", closest_solid_id);
+    printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_bvh] Particle solid distance: %e mm\n", closest_distance/mm);
+  }
+  #endif
+
+  primary_particle->particle_solid_distance_[global_id] = closest_distance;
+  primary_particle->solid_id_[global_id] = closest_solid_id;
+}
@@ -52,6 +52,11 @@ kernel void particle_solid_distance_ggems_solid_box(
   // Return if index > to particle limit
   if (global_id >= particle_id_limit) return;
 
+  #ifdef PARTICLE_COMPACTION
+  // Thread index to index of live particle, list built by compaction stage
+  global_id = primary_particle->live_index_[global_id];
+  #endif
+
   // Checking particle status. If DEAD, the particle is not track
   if (primary_particle->status_[global_id] == DEAD) return;
 
@@ -35,16 +35,20 @@
 #include "GGEMS/maths/GGEMSMatrixOperations.hh"
 
 /*!
-  \fn kernel void project_to_ggems_voxelized_solid(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSVoxelizedSolidData const* voxelized_solid_data)
+  \fn kernel void project_to_ggems_voxelized_solid(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGEMSParticleTrajectories* trajectories)
   \param particle_id_limit - particle id limit
   \param primary_particle - pointer to primary particles on OpenCL memory
   \param voxelized_solid_data - pointer to voxelized solid data
+  \param trajectories - pointer to interactions of displayed particles, only with OpenGL
   \brief OpenCL kernel moving particles to voxelized solid
 */
 kernel void project_to_ggems_voxelized_solid(
   GGsize const particle_id_limit,
   global GGEMSPrimaryParticles* primary_particle,
   global GGEMSVoxelizedSolidData const* voxelized_solid_data
+  #ifdef OPENGL
+  ,global GGEMSParticleTrajectories* trajectories
+  #endif
 )
 {
   // Getting index of thread
@@ -53,6 +57,11 @@ kernel void project_to_ggems_voxelized_solid(
   // Return if index > to particle limit
   if (global_id >= particle_id_limit) return;
 
+  #ifdef PARTICLE_COMPACTION
+  // Thread index to index of live particle, list built by compaction stage
+  global_id = primary_particle->live_index_[global_id];
+  #endif
+
   // No solid detected, consider particle as dead
   if(primary_particle->solid_id_[global_id] == -1) primary_particle->status_[global_id] = DEAD;
 
@@ -65,16 +74,16 @@ kernel void project_to_ggems_voxelized_solid(
     #ifdef OPENGL
     if (global_id < MAXIMUM_DISPLAYED_PARTICLES) {
       // Storing OpenGL index on OpenCL private memory
-      GGint stored_particles_gl = primary_particle->stored_particles_gl_[global_id];
+      GGint stored_particles_gl = trajectories->stored_particles_gl_[global_id];
 
       // Checking if buffer is full
       if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
-        primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->px_[global_id] + primary_particle->dx_[global_id]*100.0*m;
-        primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->py_[global_id] + primary_particle->dy_[global_id]*100.0*m;
-        primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->pz_[global_id] + primary_particle->dz_[global_id]*100.0*m;
+        trajectories->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->px_[global_id] + primary_particle->dx_[global_id]*100.0*m;
+        trajectories->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->py_[global_id] + primary_particle->dy_[global_id]*100.0*m;
+        trajectories->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->pz_[global_id] + primary_particle->dz_[global_id]*100.0*m;
 
         // Storing final index
-        primary_particle->stored_particles_gl_[global_id] += 1;
+        trajectories->stored_particles_gl_[global_id] += 1;
       }
     }
     #endif
@@ -0,0 +1,78 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file ReduceDoseReplicas.cl
+
+  \brief OpenCL kernel merging replicated dose maps in the first copy
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/tools/GGEMSTypes.hh"
+
+/*!
+  \fn kernel void reduce_dose_replicas(GGsize const number_of_dosels, GGint const number_of_replicas, global GGEdepType* edep, global GGEdepType* edep_squared, global GGint* hit)
+  \param number_of_dosels - number of dosels in a copy of dose map
+  \param number_of_replicas - number of copies of dose maps
+  \param edep - buffer storing energy deposit
+  \param edep_squared - buffer storing energy deposit squared, may be null
+  \param hit - buffer storing hits, may be null
+  \brief summing copies of dose maps in the first copy, other copies are reset to 0
+*/
+kernel void reduce_dose_replicas(
+  GGsize const number_of_dosels,
+  GGint const number_of_replicas,
+  global GGEdepType* edep,
+  global GGEdepType* edep_squared,
+  global GGint* hit
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+  if (global_id >= number_of_dosels) return;
+
+  GGEdepType edep_sum = edep[global_id];
+  GGEdepType edep_squared_sum = edep_squared ? edep_squared[global_id] : 0;
+  GGint hit_sum = hit ? hit[global_id] : 0;
+
+  for (GGint i = 1; i < number_of_replicas; ++i) {
+    GGsize replica_id = global_id + (GGsize)i * number_of_dosels;
+
+    edep_sum += edep[replica_id];
+    edep[replica_id] = 0;
+
+    if (edep_squared) {
+      edep_squared_sum += edep_squared[replica_id];
+      edep_squared[replica_id] = 0;
+    }
+
+    if (hit) {
+      hit_sum += hit[replica_id];
+      hit[replica_id] = 0;
+    }
+  }
+
+  edep[global_id] = edep_sum;
+  if (edep_squared) edep_squared[global_id] = edep_squared_sum;
+  if (hit) hit[global_id] = hit_sum;
+}
@@ -0,0 +1,348 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file TrackThroughGGEMSMultiSolidBox.cl
+
+  \brief OpenCL kernel tracking particles within all the solid boxes of a navigator in a single launch
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+#include "GGEMS/geometries/GGEMSSolidBoxData.hh"
+#include "GGEMS/geometries/GGEMSRayTracing.hh"
+#include "GGEMS/materials/GGEMSMaterialTables.hh"
+#include "GGEMS/physics/GGEMSParticleCrossSections.hh"
+#include "GGEMS/randoms/GGEMSRandom.hh"
+#include "GGEMS/maths/GGEMSMatrixOperations.hh"
+#include "GGEMS/navigators/GGEMSPhotonNavigator.hh"
+#include "GGEMS/physics/GGEMSMuData.hh"
+#include "GGEMS/io/GGEMSHistogramMode.hh"
+
+/*!
+  \fn inline void TrackParticleThroughMultiSolidBox(GGsize global_id, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, GGint const number_of_solids, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold, HISTOGRAM_MEMORY GGint* histogram, HISTOGRAM_MEMORY GGint* scatter_histogram, GGchar const is_scatter, GGsize const histogram_stride, global GGEMSParticleTrajectories* trajectories)
+  \param global_id - index of thread
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random numbers
+  \param solid_box_data - pointer to packed data of all solid boxes
+  \param number_of_solids - number of solid boxes in packed data
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param materials - pointer on material in navigator
+  \param threshold - energy threshold
+  \param histogram - pointer to packed histograms, local copy of the work-group with LOCAL_HISTOGRAM
+  \param scatter_histogram - pointer to packed scatter histograms, local copy of the work-group with LOCAL_HISTOGRAM
+  \param is_scatter - 1 if scatter histograms are stored
+  \param histogram_stride - number of elements in histogram of one solid box
+  \param trajectories - pointer to interactions of displayed particles, only with OpenGL
+  \brief Tracking a particle within the solid box selected by project_to_ggems_multi_solid_box
+*/
+inline void TrackParticleThroughMultiSolidBox(
+  GGsize global_id,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  global GGEMSSolidBoxData const* solid_box_data,
+  GGint const number_of_solids,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  GGfloat const threshold
+  #ifdef HISTOGRAM
+  ,HISTOGRAM_MEMORY GGint* histogram,
+  HISTOGRAM_MEMORY GGint* scatter_histogram,
+  GGchar const is_scatter,
+  GGsize const histogram_stride
+  #endif
+  #ifdef OPENGL
+  ,global GGEMSParticleTrajectories* trajectories
+  #endif
+)
+{
+  #ifdef PARTICLE_COMPACTION
+  // Thread index to index of live particle, list built by compaction stage
+  global_id = primary_particle->live_index_[global_id];
+  #endif
+
+  // Checking if the selected solid belongs to this navigator
+  GGint solid_index = primary_particle->solid_id_[global_id] - solid_box_data[0].solid_id_;
+  if (solid_index < 0 || solid_index >= number_of_solids) return;
+
+  // Data of the selected solid
+  global GGEMSSolidBoxData const* solid_data = &solid_box_data[solid_index];
+
+  // Checking status of particle
+  if (primary_particle->status_[global_id] == DEAD) {
+    #ifdef GGEMS_TRACKING
+    if (global_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] ################################################################################\n");
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] The particle id %d is dead!!!\n", global_id);
+    }
+    #endif
+    return;
+  }
+
+  // Loading particle in private memory, it is stored in global memory only at the end of tracking
+  GGEMSParticle particle = LoadParticle(primary_particle, random, global_id);
+
+  // Get the position and direction in local OBB coordinate
+  GGfloat3 local_position = GlobalToLocalPosition(&solid_data->obb_geometry_.matrix_transformation_, &particle.position_);
+  GGfloat3 local_direction = GlobalToLocalDirection(&solid_data->obb_geometry_.matrix_transformation_, &particle.direction_);
+
+  // Physics processes use local direction
+  particle.direction_ = local_direction;
+
+  // Get borders of OBB
+  GGfloat3 border_min = solid_data->obb_geometry_.border_min_xyz_;
+  GGfloat3 border_max = solid_data->obb_geometry_.border_max_xyz_;
+
+  // Get box size of solid box
+  GGfloat3 box_size = {
+    solid_data->box_size_xyz_[0],
+    solid_data->box_size_xyz_[1],
+    solid_data->box_size_xyz_[2]
+  };
+
+  // Get virtual element size
+  GGint3 virtual_element_number = {
+    solid_data->virtual_element_number_xyz_[0],
+    solid_data->virtual_element_number_xyz_[1],
+    solid_data->virtual_element_number_xyz_[2]
+  };
+
+  // Track particle until out of solid
+  do {
+    // Find next discrete photon interaction
+    GetPhotonNextInteraction(&particle, random, particle_cross_sections, 0, global_id);
+    GGfloat next_interaction_distance = particle.next_interaction_distance_;
+    GGchar next_discrete_process = particle.next_discrete_process_;
+
+    // Get safety position of particle to be sure particle is inside voxel
+    TransportGetSafetyInsideAABB(
+      &local_position,
+      border_min.x, border_max.x,
+      border_min.y, border_max.y,
+      border_min.z, border_max.z,
+      GEOMETRY_TOLERANCE
+    );
+
+    // Get the distance to next boundary
+    GGfloat distance_to_next_boundary = ComputeDistanceToAABB(
+      &local_position, &local_direction,
+      border_min.x, border_max.x,
+      border_min.y, border_max.y,
+      border_min.z, border_max.z,
+      GEOMETRY_TOLERANCE
+    );
+
+    // If distance to next boundary is inferior to distance to next interaction we move particle to boundary
+    if (distance_to_next_boundary <= next_interaction_distance) {
+      next_interaction_distance = distance_to_next_boundary + GEOMETRY_TOLERANCE;
+      next_discrete_process = TRANSPORTATION;
+    }
+
+    #ifdef GGEMS_TRACKING
+    if (particle.is_tracked_) {
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] ################################################################################\n");
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Particle id: %d\n", global_id);
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Particle type: ");
+      if (primary_particle->pname_[global_id] == PHOTON) printf("gamma\n");
+      else if (primary_particle->pname_[global_id] == ELECTRON) printf("e-\n");
+      else if (primary_particle->pname_[global_id] == POSITRON) printf("e+\n");
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Local direction (x, y, z): %e %e %e\n", local_direction.x, local_direction.y, local_direction.z);
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Energy: %e keV\n", particle.E_/keV);
+      printf("\n");
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Solid id: %u\n", solid_data->solid_id_);
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Solid X Borders: %e %e mm\n", border_min.x/mm, border_max.x/mm);
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Solid Y Borders: %e %e mm\n", border_min.y/mm, border_max.y/mm);
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Solid Z Borders: %e %e mm\n", border_min.z/mm, border_max.z/mm);
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Material in voxel: %s\n", particle_cross_sections->material_names_[0]);
+      printf("\n");
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Next process: ");
+      if (next_discrete_process == COMPTON_SCATTERING) printf("COMPTON_SCATTERING\n");
+      if (next_discrete_process == PHOTOELECTRIC_EFFECT) printf("PHOTOELECTRIC_EFFECT\n");
+      if (next_discrete_process == RAYLEIGH_SCATTERING) printf("RAYLEIGH_SCATTERING\n");
+      if (next_discrete_process == TRANSPORTATION) printf("TRANSPORTATION\n");
+      printf("[GGEMS OpenCL kernel track_through_ggems_multi_solid_box] Next interaction distance: %e mm\n", next_interaction_distance/mm);
+    }
+    #endif
+
+    // Moving particle to next postion
+    local_position = local_position + local_direction*next_interaction_distance;
+
+    // Get safety position of particle to be sure particle is outside voxel
+    TransportGetSafetyOutsideAABB(
+      &local_position,
+      border_min.x, border_max.x,
+      border_min.y, border_max.y,
+      border_min.z, border_max.z,
+      GEOMETRY_TOLERANCE
+    );
+
+    //  Checking if particle outside solid, still in local
+    if (!IsParticleInAABB(&local_position, border_min.x, border_max.x, border_min.y, border_max.y, border_min.z, border_max.z, GEOMETRY_TOLERANCE)) {
+      primary_particle->particle_solid_distance_[global_id] = OUT_OF_WORLD; // Reset to initiale value
+      primary_particle->solid_id_[global_id] = -1; // Out of world
+      break;
+    }
+
+    // Check thresold
+    if (particle.E_ < threshold) particle.status_ = DEAD;
+
+    // Resolve process if different of TRANSPORTATION
+    if (next_discrete_process != TRANSPORTATION) {
+      PhotonDiscreteProcess(&particle, random, materials, particle_cross_sections, 0, global_id);
+      local_direction = particle.direction_;
+
+      #ifdef HISTOGRAM
+      if (next_discrete_process == PHOTOELECTRIC_EFFECT || next_discrete_process == COMPTON_SCATTERING) {
+        GGfloat3 element_size = box_size / convert_float3(virtual_element_number);
+        GGint3 voxel_id = convert_int3((local_position - border_min) / element_size);
+
+        GGsize histogram_index = solid_index*histogram_stride + voxel_id.x + voxel_id.y * virtual_element_number.x;
+
+        atomic_add(&histogram[histogram_index], 1);
+
+        // Storing scatter
+        if (is_scatter) {
+          if (particle.scatter_ == TRUE) atomic_add(&scatter_histogram[histogram_index], 1);
+        }
+      }
+      #endif
+
+      #ifdef OPENGL
+      if (global_id < MAXIMUM_DISPLAYED_PARTICLES) {
+        // Storing OpenGL index on OpenCL private memory
+        GGint stored_particles_gl = trajectories->stored_particles_gl_[global_id];
+
+        // Checking if buffer is full
+        if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
+          // Getting global position
+          GGfloat3 global_position = LocalToGlobalPosition(&solid_data->obb_geometry_.matrix_transformation_, &local_position);
+
+          trajectories->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.x;
+          trajectories->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.y;
+          trajectories->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.z;
+
+          // Storing final index
+          trajectories->stored_particles_gl_[global_id] += 1;
+        }
+      }
+      #endif
+    }
+  } while (particle.status_ == ALIVE);
+
+  // Convert to global position and direction, and storing particle in global memory
+  particle.position_ = LocalToGlobalPosition(&solid_data->obb_geometry_.matrix_transformation_, &local_position);
+  particle.direction_ = LocalToGlobalDirection(&solid_data->obb_geometry_.matrix_transformation_, &local_direction);
+  StoreParticle(primary_particle, random, &particle, global_id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn kernel void track_through_ggems_multi_solid_box(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, GGint const number_of_solids, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold, global GGint* histogram, global GGint* scatter_histogram, GGsize const histogram_stride, local GGint* local_histogram, local GGint* local_scatter_histogram, global GGEMSParticleTrajectories* trajectories)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random numbers
+  \param solid_box_data - pointer to packed data of all solid boxes
+  \param number_of_solids - number of solid boxes in packed data
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param materials - pointer on material in navigator
+  \param threshold - energy threshold
+  \param histogram - pointer to packed histograms of all solid boxes
+  \param scatter_histogram - pointer to packed scatter histograms of all solid boxes
+  \param histogram_stride - number of elements in histogram of one solid box
+  \param local_histogram - copy of packed histograms for the work-group, only with LOCAL_HISTOGRAM
+  \param local_scatter_histogram - copy of packed scatter histograms for the work-group, only with LOCAL_HISTOGRAM
+  \param trajectories - pointer to interactions of displayed particles, only with OpenGL
+  \brief OpenCL kernel tracking particles within solid boxes, each particle is tracked in the solid selected by project_to_ggems_multi_solid_box. With LOCAL_HISTOGRAM hits are counted in local memory and added to global histograms once by work-group
+*/
+kernel void track_through_ggems_multi_solid_box(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  global GGEMSSolidBoxData const* solid_box_data,
+  GGint const number_of_solids,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  GGfloat const threshold
+  #ifdef HISTOGRAM
+  ,global GGint* histogram,
+  global GGint* scatter_histogram,
+  GGsize const histogram_stride
+  #ifdef LOCAL_HISTOGRAM
+  ,local GGint* local_histogram,
+  local GGint* local_scatter_histogram
+  #endif
+  #endif
+  #ifdef OPENGL
+  ,global GGEMSParticleTrajectories* trajectories
+  #endif
+)
+{
+  // Getting index of thread
+  GGsize global_id = get_global_id(0);
+
+  #ifdef LOCAL_HISTOGRAM
+  // All work-items of the work-group clear and flush the local copies, even out of particle limit
+  GGsize number_of_elements = (GGsize)number_of_solids * histogram_stride;
+  ClearLocalHistogram(local_histogram, number_of_elements);
+  if (scatter_histogram) ClearLocalHistogram(local_scatter_histogram, number_of_elements);
+  barrier(CLK_LOCAL_MEM_FENCE);
+  #endif
+
+  // Tracking only if index < to particle limit
+  if (global_id < particle_id_limit) {
+    TrackParticleThroughMultiSolidBox(
+      global_id,
+      primary_particle,
+      random,
+      solid_box_data,
+      number_of_solids,
+      particle_cross_sections,
+      materials,
+      threshold
+      #ifdef LOCAL_HISTOGRAM
+      ,local_histogram,
+      local_scatter_histogram,
+      scatter_histogram ? 1 : 0,
+      histogram_stride
+      #elif defined(HISTOGRAM)
+      ,histogram,
+      scatter_histogram,
+      scatter_histogram ? 1 : 0,
+      histogram_stride
+      #endif
+      #ifdef OPENGL
+      ,trajectories
+      #endif
+    );
+  }
+
+  #ifdef LOCAL_HISTOGRAM
+  barrier(CLK_LOCAL_MEM_FENCE);
+  FlushLocalHistogram(local_histogram, histogram, number_of_elements);
+  if (scatter_histogram) FlushLocalHistogram(local_scatter_histogram, scatter_histogram, number_of_elements);
+  #endif
+}
@@ -37,43 +37,45 @@
 #include "GGEMS/maths/GGEMSMatrixOperations.hh"
 #include "GGEMS/navigators/GGEMSPhotonNavigator.hh"
 #include "GGEMS/physics/GGEMSMuData.hh"
+#include "GGEMS/io/GGEMSHistogramMode.hh"
 
 /*!
-  \fn kernel void track_through_ggems_solid_box(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, global GGEMSMuMuEnData const* attenuations, GGfloat const threshold, global GGint* histogram, global GGint* scatter_histogram)
-  \param particle_id_limit - particle id limit
+  \fn inline void TrackParticleThroughSolidBox(GGsize global_id, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold, HISTOGRAM_MEMORY GGint* histogram, HISTOGRAM_MEMORY GGint* scatter_histogram, GGchar const is_scatter, global GGEMSParticleTrajectories* trajectories)
+  \param global_id - index of thread
   \param primary_particle - pointer to primary particles on OpenCL memory
   \param random - pointer on random numbers
   \param solid_box_data - pointer to solid box data
-  \param label_data - pointer storing label of material (empty buffer here, 1 material only)
   \param particle_cross_sections - pointer to cross sections activated in navigator
   \param materials - pointer on material in navigator
-  \param attenuations - pointer on attenuation values
   \param threshold - energy threshold
-  \param histogram - pointer to buffer storing histogram
-  \param scatter_histogram - pointer to buffer storing scatter histogram
-  \brief OpenCL kernel tracking particles within voxelized solid
+  \param histogram - pointer to histogram, local copy of the work-group with LOCAL_HISTOGRAM
+  \param scatter_histogram - pointer to scatter histogram, local copy of the work-group with LOCAL_HISTOGRAM
+  \param is_scatter - 1 if scatter histogram is stored
+  \param trajectories - pointer to interactions of displayed particles, only with OpenGL
+  \brief Tracking a particle within solid box
 */
-kernel void track_through_ggems_solid_box(
-  GGsize const particle_id_limit,
+inline void TrackParticleThroughSolidBox(
+  GGsize global_id,
   global GGEMSPrimaryParticles* primary_particle,
   global GGEMSRandom* random,
   global GGEMSSolidBoxData const* solid_box_data,
-  global GGuchar const* label_data,
   global GGEMSParticleCrossSections const* particle_cross_sections,
   global GGEMSMaterialTables const* materials,
-  global GGEMSMuMuEnData const* attenuations,
   GGfloat const threshold
   #ifdef HISTOGRAM
-  ,global GGint* histogram,
-  global GGint* scatter_histogram
+  ,HISTOGRAM_MEMORY GGint* histogram,
+  HISTOGRAM_MEMORY GGint* scatter_histogram,
+  GGchar const is_scatter
+  #endif
+  #ifdef OPENGL
+  ,global GGEMSParticleTrajectories* trajectories
   #endif
 )
 {
-  // Getting index of thread
-  GGsize global_id = get_global_id(0);
-
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  #ifdef PARTICLE_COMPACTION
+  // Thread index to index of live particle, list built by compaction stage
+  global_id = primary_particle->live_index_[global_id];
+  #endif
 
   // Checking if the current navigator is the selected navigator
   if (primary_particle->solid_id_[global_id] != solid_box_data->solid_id_) return;
@@ -89,16 +91,15 @@ kernel void track_through_ggems_solid_box(
     return;
   }
 
+  // Loading particle in private memory, it is stored in global memory only at the end of tracking
+  GGEMSParticle particle = LoadParticle(primary_particle, random, global_id);
+
   // Get the position and direction in local OBB coordinate
-  GGfloat3 global_position = {primary_particle->px_[global_id], primary_particle->py_[global_id], primary_particle->pz_[global_id]};
-  GGfloat3 global_direction = {primary_particle->dx_[global_id], primary_particle->dy_[global_id], primary_particle->dz_[global_id]};
-  GGfloat3 local_position = GlobalToLocalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &global_position);
-  GGfloat3 local_direction = GlobalToLocalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &global_direction);
+  GGfloat3 local_position = GlobalToLocalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &particle.position_);
+  GGfloat3 local_direction = GlobalToLocalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &particle.direction_);
 
-  // Storing local direction in particles 
-  primary_particle->dx_[global_id] = local_direction.x;
-  primary_particle->dy_[global_id] = local_direction.y;
-  primary_particle->dz_[global_id] = local_direction.z;
+  // Physics processes use local direction
+  particle.direction_ = local_direction;
 
   // Get borders of OBB
   GGfloat3 border_min = solid_box_data->obb_geometry_.border_min_xyz_;
@@ -121,9 +122,9 @@ kernel void track_through_ggems_solid_box(
   // Track particle until out of solid
   do {
     // Find next discrete photon interaction
-    GetPhotonNextInteraction(primary_particle, random, particle_cross_sections, 0, global_id);
-    GGfloat next_interaction_distance = primary_particle->next_interaction_distance_[global_id];
-    GGchar next_discrete_process = primary_particle->next_discrete_process_[global_id];
+    GetPhotonNextInteraction(&particle, random, particle_cross_sections, 0, global_id);
+    GGfloat next_interaction_distance = particle.next_interaction_distance_;
+    GGchar next_discrete_process = particle.next_discrete_process_;
 
     // Get safety position of particle to be sure particle is inside voxel
     TransportGetSafetyInsideAABB(
@@ -150,7 +151,7 @@ kernel void track_through_ggems_solid_box(
     }
 
     #ifdef GGEMS_TRACKING
-    if (global_id == primary_particle->particle_tracking_id) {
+    if (particle.is_tracked_) {
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] ################################################################################\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Particle id: %d\n", global_id);
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Particle type: ");
@@ -159,7 +160,7 @@ kernel void track_through_ggems_solid_box(
       else if (primary_particle->pname_[global_id] == POSITRON) printf("e+\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Local direction (x, y, z): %e %e %e\n", local_direction.x, local_direction.y, local_direction.z);
-      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Energy: %e keV\n", primary_particle->E_[global_id]/keV);
+      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Energy: %e keV\n", particle.E_/keV);
       printf("\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Solid id: %u\n", solid_box_data->solid_id_);
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Solid X Borders: %e %e mm\n", border_min.x/mm, border_max.x/mm);
@@ -195,21 +196,13 @@ kernel void track_through_ggems_solid_box(
       break;
     }
 
-    // Storing new position in local
-    primary_particle->px_[global_id] = local_position.x;
-    primary_particle->py_[global_id] = local_position.y;
-    primary_particle->pz_[global_id] = local_position.z;
-
     // Check thresold
-    if (primary_particle->E_[global_id] < threshold) primary_particle->status_[global_id] = DEAD;
+    if (particle.E_ < threshold) particle.status_ = DEAD;
 
     // Resolve process if different of TRANSPORTATION
     if (next_discrete_process != TRANSPORTATION) {
-      PhotonDiscreteProcess(primary_particle, random, materials, particle_cross_sections, 0, global_id);
-
-      local_direction.x = primary_particle->dx_[global_id];
-      local_direction.y = primary_particle->dy_[global_id];
-      local_direction.z = primary_particle->dz_[global_id];
+      PhotonDiscreteProcess(&particle, random, materials, particle_cross_sections, 0, global_id);
+      local_direction = particle.direction_;
 
       #ifdef HISTOGRAM
       if (next_discrete_process == PHOTOELECTRIC_EFFECT || next_discrete_process == COMPTON_SCATTERING) {
@@ -219,8 +212,8 @@ kernel void track_through_ggems_solid_box(
         atomic_add(&histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], 1);
 
         // Storing scatter
-        if (scatter_histogram) {
-          if (primary_particle->scatter_[global_id] == TRUE) atomic_add(&scatter_histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], 1);
+        if (is_scatter) {
+          if (particle.scatter_ == TRUE) atomic_add(&scatter_histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], 1);
         }
       }
       #endif
@@ -228,34 +221,115 @@ kernel void track_through_ggems_solid_box(
       #ifdef OPENGL
       if (global_id < MAXIMUM_DISPLAYED_PARTICLES) {
         // Storing OpenGL index on OpenCL private memory
-        GGint stored_particles_gl = primary_particle->stored_particles_gl_[global_id];
+        GGint stored_particles_gl = trajectories->stored_particles_gl_[global_id];
 
         // Checking if buffer is full
         if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
           // Getting global position
-          global_position = LocalToGlobalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &local_position);
+          GGfloat3 global_position = LocalToGlobalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &local_position);
 
-          primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.x;
-          primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.y;
-          primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.z;
+          trajectories->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.x;
+          trajectories->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.y;
+          trajectories->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.z;
 
           // Storing final index
-          primary_particle->stored_particles_gl_[global_id] += 1;
+          trajectories->stored_particles_gl_[global_id] += 1;
         }
       }
       #endif
     }
-  } while (primary_particle->status_[global_id] == ALIVE);
-
-  // Convert to global position
-  global_position = LocalToGlobalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &local_position);
-  primary_particle->px_[global_id] = global_position.x;
-  primary_particle->py_[global_id] = global_position.y;
-  primary_particle->pz_[global_id] = global_position.z;
-
-  // Convert to global direction
-  global_direction = LocalToGlobalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &local_direction);
-  primary_particle->dx_[global_id] = global_direction.x;
-  primary_particle->dy_[global_id] = global_direction.y;
-  primary_particle->dz_[global_id] = global_direction.z;
+  } while (particle.status_ == ALIVE);
+
+  // Convert to global position and direction, and storing particle in global memory
+  particle.position_ = LocalToGlobalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &local_position);
+  particle.direction_ = LocalToGlobalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &local_direction);
+  StoreParticle(primary_particle, random, &particle, global_id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn kernel void track_through_ggems_solid_box(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, global GGEMSMuMuEnData const* attenuations, GGfloat const threshold, global GGint* histogram, global GGint* scatter_histogram, local GGint* local_histogram, local GGint* local_scatter_histogram, global GGEMSParticleTrajectories* trajectories)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random numbers
+  \param solid_box_data - pointer to solid box data
+  \param label_data - pointer storing label of material (empty buffer here, 1 material only)
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param materials - pointer on material in navigator
+  \param attenuations - pointer on attenuation values
+  \param threshold - energy threshold
+  \param histogram - pointer to buffer storing histogram
+  \param scatter_histogram - pointer to buffer storing scatter histogram
+  \param local_histogram - copy of histogram for the work-group, only with LOCAL_HISTOGRAM
+  \param local_scatter_histogram - copy of scatter histogram for the work-group, only with LOCAL_HISTOGRAM
+  \param trajectories - pointer to interactions of displayed particles, only with OpenGL
+  \brief OpenCL kernel tracking particles within solid box, with LOCAL_HISTOGRAM hits are counted in local memory and added to global histogram once by work-group
+*/
+kernel void track_through_ggems_solid_box(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  global GGEMSSolidBoxData const* solid_box_data,
+  global GGuchar const* label_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  global GGEMSMuMuEnData const* attenuations,
+  GGfloat const threshold
+  #ifdef HISTOGRAM
+  ,global GGint* histogram,
+  global GGint* scatter_histogram
+  #ifdef LOCAL_HISTOGRAM
+  ,local GGint* local_histogram,
+  local GGint* local_scatter_histogram
+  #endif
+  #endif
+  #ifdef OPENGL
+  ,global GGEMSParticleTrajectories* trajectories
+  #endif
+)
+{
+  // Getting index of thread
+  GGsize global_id = get_global_id(0);
+
+  #ifdef LOCAL_HISTOGRAM
+  // All work-items of the work-group clear and flush the local copies, even out of particle limit
+  GGsize number_of_elements = (GGsize)(solid_box_data->virtual_element_number_xyz_[0]*solid_box_data->virtual_element_number_xyz_[1]*solid_box_data->virtual_element_number_xyz_[2]);
+  ClearLocalHistogram(local_histogram, number_of_elements);
+  if (scatter_histogram) ClearLocalHistogram(local_scatter_histogram, number_of_elements);
+  barrier(CLK_LOCAL_MEM_FENCE);
+  #endif
+
+  // Tracking only if index < to particle limit
+  if (global_id < particle_id_limit) {
+    TrackParticleThroughSolidBox(
+      global_id,
+      primary_particle,
+      random,
+      solid_box_data,
+      particle_cross_sections,
+      materials,
+      threshold
+      #ifdef LOCAL_HISTOGRAM
+      ,local_histogram,
+      local_scatter_histogram,
+      scatter_histogram ? 1 : 0
+      #elif defined(HISTOGRAM)
+      ,histogram,
+      scatter_histogram,
+      scatter_histogram ? 1 : 0
+      #endif
+      #ifdef OPENGL
+      ,trajectories
+      #endif
+    );
+  }
+
+  #ifdef LOCAL_HISTOGRAM
+  barrier(CLK_LOCAL_MEM_FENCE);
+  FlushLocalHistogram(local_histogram, histogram, number_of_elements);
+  if (scatter_histogram) FlushLocalHistogram(local_scatter_histogram, scatter_histogram, number_of_elements);
+  #endif
 }
@@ -43,7 +43,7 @@
 #endif
 
 /*!
-  \fn kernel void track_through_ggems_voxelized_solid(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, global GGEMSMuMuEnData const* attenuations, GGfloat const threshold)
+  \fn kernel void track_through_ggems_voxelized_solid(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, global GGEMSMuMuEnData const* attenuations, GGfloat const threshold, global GGEMSParticleTrajectories* trajectories)
   \param particle_id_limit - particle id limit
   \param primary_particle - pointer to primary particles on OpenCL memory
   \param random - pointer on random numbers
@@ -53,6 +53,7 @@
   \param materials - pointer on material in navigator
   \param attenuations - pointer on attenuation values
   \param threshold - energy threshold
+  \param trajectories - pointer to interactions of displayed particles, only with OpenGL
   \brief OpenCL kernel tracking particles within voxelized solid
 */
 kernel void track_through_ggems_voxelized_solid(
@@ -67,11 +68,14 @@ kernel void track_through_ggems_voxelized_solid(
   GGfloat const threshold
   #ifdef DOSIMETRY
   ,global GGEMSDoseParams* dose_params,
-  global GGDosiType* edep_tracking,
-  global GGDosiType* edep_squared_tracking,
+  global GGEdepType* edep_tracking,
+  global GGEdepType* edep_squared_tracking,
   global GGint* hit_tracking,
   global GGint* photon_tracking
   #endif
+  #ifdef OPENGL
+  ,global GGEMSParticleTrajectories* trajectories
+  #endif
 )
 {
   // Getting index of thread
@@ -80,6 +84,11 @@ kernel void track_through_ggems_voxelized_solid(
   // Return if index > to particle limit
   if (global_id >= particle_id_limit) return;
 
+  #ifdef PARTICLE_COMPACTION
+  // Thread index to index of live particle, list built by compaction stage
+  global_id = primary_particle->live_index_[global_id];
+  #endif
+
   // Checking if the current navigator is the selected navigator
   if (primary_particle->solid_id_[global_id] != voxelized_solid_data->solid_id_) return;
 
@@ -94,16 +103,12 @@ kernel void track_through_ggems_voxelized_solid(
     return;
   }
 
-  // Get the position and direction in local OBB coordinate
-  GGfloat3 global_position = {primary_particle->px_[global_id], primary_particle->py_[global_id], primary_particle->pz_[global_id]};
-  GGfloat3 global_direction = {primary_particle->dx_[global_id], primary_particle->dy_[global_id], primary_particle->dz_[global_id]};
-  GGfloat3 local_position = GlobalToLocalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &global_position);
-  GGfloat3 local_direction = GlobalToLocalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &global_direction);
+  // Loading particle in private memory, it is stored in global memory only at the end of tracking
+  GGEMSParticle particle = LoadParticle(primary_particle, random, global_id);
 
-  // Storing local direction in particles 
-  primary_particle->dx_[global_id] = local_direction.x;
-  primary_particle->dy_[global_id] = local_direction.y;
-  primary_particle->dz_[global_id] = local_direction.z;
+  // Get the position and direction in local OBB coordinate
+  GGfloat3 local_position = GlobalToLocalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &particle.position_);
+  GGfloat3 local_direction = GlobalToLocalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &particle.direction_);
 
   // Get borders of OBB
   GGfloat3 border_min = voxelized_solid_data->obb_geometry_.border_min_xyz_;
@@ -111,59 +116,160 @@ kernel void track_through_ggems_voxelized_solid(
 
   GGfloat3 voxel_size = voxelized_solid_data->voxel_sizes_xyz_;
   GGint3 number_of_voxels = voxelized_solid_data->number_of_voxels_xyz_;
+  GGint label_layout = voxelized_solid_data->label_layout_;
+
+  // Checking particle is in solid before walking through voxels
+  if (!IsParticleInAABB(&local_position, border_min.x, border_max.x, border_min.y, border_max.y, border_min.z, border_max.z, GEOMETRY_TOLERANCE)) {
+    primary_particle->particle_solid_distance_[global_id] = OUT_OF_WORLD; // Reset to initiale value
+    primary_particle->solid_id_[global_id] = -1; // Out of world
+    return;
+  }
 
-  // Track particle until out of solid
+  // Physics processes use local direction
+  particle.direction_ = local_direction;
+
+  // Get index of voxelized phantom, x, y, z. Particle projected on solid is in tolerance of borders, so index is clamped in grid
+  GGint3 voxel_id = clamp(convert_int3((local_position - border_min) / voxel_size), (GGint3)(0), number_of_voxels - (GGint3)(1));
+
+  // Track particle until out of solid, one iteration per free flight between two interactions
   do {
-    // Get index of voxelized phantom, x, y, z
-    GGint3 voxel_id = convert_int3((local_position - border_min) / voxel_size);
+    // Energy is constant along the free flight, index in cross section table is computed once
+    GGint energy_id = LogUniformBinIndex(particle.E_, particle_cross_sections->energy_bins_, particle_cross_sections->number_of_bins_, particle_cross_sections->log_min_energy_, particle_cross_sections->inverse_log_energy_step_);
+    particle.E_index_ = energy_id;
 
-    if (voxel_id.x >= number_of_voxels.x || voxel_id.y >= number_of_voxels.y || voxel_id.z >= number_of_voxels.z) {
-      primary_particle->particle_solid_distance_[global_id] = OUT_OF_WORLD; // Reset to initiale value
-      primary_particle->solid_id_[global_id] = -1; // Out of world
-      break;
-    }
+    #if defined(DOSIMETRY)
+    GGfloat initial_energy = particle.E_;
+    #endif
+
+    #if defined(DOSIMETRY) && defined(TLE)
+    GGint E_index = BinarySearchLeft(initial_energy, attenuations->energy_bins_, attenuations->number_of_bins_, 0, 0);
+    #endif
+
+    GGfloat travelled_distance = 0.0f;
+    GGuchar material_id = 0;
+    GGchar next_discrete_process = TRANSPORTATION;
+
+    #if defined(WOODCOCK)
+    // Distance to exit of solid along direction
+    GGfloat3 absolute_direction = fabs(local_direction);
+    GGfloat3 exit_distance = {
+      absolute_direction.x < EPSILON6 ? OUT_OF_WORLD : (local_direction.x > 0.0f ? border_max.x - local_position.x : local_position.x - border_min.x) / absolute_direction.x,
+      absolute_direction.y < EPSILON6 ? OUT_OF_WORLD : (local_direction.y > 0.0f ? border_max.y - local_position.y : local_position.y - border_min.y) / absolute_direction.y,
+      absolute_direction.z < EPSILON6 ? OUT_OF_WORLD : (local_direction.z > 0.0f ? border_max.z - local_position.z : local_position.z - border_min.z) / absolute_direction.z
+    };
+    GGfloat solid_exit_distance = fmax(fmin(exit_distance.x, fmin(exit_distance.y, exit_distance.z)), 0.0f);
+
+    // Majorant cross section over materials of the solid, real interaction is accepted with probability total/majorant
+    GGfloat majorant_cross_section = particle_cross_sections->photon_majorant_cross_sections_[energy_id];
+
+    // Jumping between virtual interactions until a real one or exit of solid, no voxel boundary
+    do {
+      travelled_distance += majorant_cross_section > 0.0f ? -log(ParticleUniform(&particle, random, global_id)) / majorant_cross_section : OUT_OF_WORLD;
+      if (travelled_distance >= solid_exit_distance) {
+        travelled_distance = solid_exit_distance;
+        break;
+      }
+
+      // Get the material at virtual interaction position
+      GGfloat3 interaction_position = local_position + local_direction*travelled_distance;
+      voxel_id = clamp(convert_int3((interaction_position - border_min) / voxel_size), (GGint3)(0), number_of_voxels - (GGint3)(1));
+      material_id = label_data[LabelIndex(label_layout, voxel_id.x, voxel_id.y, voxel_id.z, number_of_voxels.x, number_of_voxels.y)];
+      GGfloat total_cross_section = GetPhotonTotalCrossSection(particle_cross_sections, material_id, energy_id);
+
+      if (ParticleUniform(&particle, random, global_id) * majorant_cross_section < total_cross_section) {
+        next_discrete_process = SelectPhotonProcess(&particle, random, particle_cross_sections, material_id, energy_id, total_cross_section, global_id);
+      }
+    } while (next_discrete_process == TRANSPORTATION);
+    #else
+    // Sampling number of mean free paths before next interaction, this number is consumed voxel by voxel
+    GGfloat remaining_mean_free_paths = -log(ParticleUniform(&particle, random, global_id));
+
+    // Initialization of voxel walker (Amanatides-Woo), step between voxels, distance to cross a voxel and distance to next voxel borders
+    GGint3 voxel_step = {
+      local_direction.x < 0.0f ? -1 : 1,
+      local_direction.y < 0.0f ? -1 : 1,
+      local_direction.z < 0.0f ? -1 : 1
+    };
+
+    GGfloat3 absolute_direction = fabs(local_direction);
+    GGfloat3 voxel_border_min = border_min + convert_float3(voxel_id)*voxel_size;
+
+    GGfloat3 voxel_crossing_distance = {
+      absolute_direction.x < EPSILON6 ? OUT_OF_WORLD : voxel_size.x / absolute_direction.x,
+      absolute_direction.y < EPSILON6 ? OUT_OF_WORLD : voxel_size.y / absolute_direction.y,
+      absolute_direction.z < EPSILON6 ? OUT_OF_WORLD : voxel_size.z / absolute_direction.z
+    };
+
+    GGfloat3 next_border_distance = {
+      absolute_direction.x < EPSILON6 ? OUT_OF_WORLD : (voxel_step.x > 0 ? voxel_border_min.x + voxel_size.x - local_position.x : local_position.x - voxel_border_min.x) / absolute_direction.x,
+      absolute_direction.y < EPSILON6 ? OUT_OF_WORLD : (voxel_step.y > 0 ? voxel_border_min.y + voxel_size.y - local_position.y : local_position.y - voxel_border_min.y) / absolute_direction.y,
+      absolute_direction.z < EPSILON6 ? OUT_OF_WORLD : (voxel_step.z > 0 ? voxel_border_min.z + voxel_size.z - local_position.z : local_position.z - voxel_border_min.z) / absolute_direction.z
+    };
+    next_border_distance = fmax(next_border_distance, 0.0f);
+
+    // Walking through voxels until interaction or exit of solid
+    do {
+      // Get the material that compose this voxel
+      material_id = label_data[LabelIndex(label_layout, voxel_id.x, voxel_id.y, voxel_id.z, number_of_voxels.x, number_of_voxels.y)];
+      GGfloat total_cross_section = GetPhotonTotalCrossSection(particle_cross_sections, material_id, energy_id);
+
+      // Length of path in current voxel and checking interaction in this voxel
+      GGfloat voxel_exit_distance = fmin(next_border_distance.x, fmin(next_border_distance.y, next_border_distance.z));
+      GGfloat segment_length = voxel_exit_distance - travelled_distance;
+      GGfloat segment_mean_free_paths = segment_length * total_cross_section;
+
+      if (remaining_mean_free_paths < segment_mean_free_paths) {
+        segment_length = remaining_mean_free_paths / total_cross_section;
+        next_discrete_process = SelectPhotonProcess(&particle, random, particle_cross_sections, material_id, energy_id, total_cross_section, global_id);
+      }
 
-    // Get the material that compose this volume
-    GGuchar material_id = label_data[voxel_id.x + voxel_id.y * number_of_voxels.x + voxel_id.z * number_of_voxels.x * number_of_voxels.y];
-
-    // Find next discrete photon interaction
-    GetPhotonNextInteraction(primary_particle, random, particle_cross_sections, material_id, global_id);
-    GGfloat next_interaction_distance = primary_particle->next_interaction_distance_[global_id];
-    GGchar next_discrete_process = primary_particle->next_discrete_process_[global_id];
-
-    // Get the borders of the current voxel
-    GGfloat3 voxel_border_min = border_min +  convert_float3(voxel_id)*voxel_size;
-    GGfloat3 voxel_border_max = voxel_border_min + voxel_size;
-
-    // Get safety position of particle to be sure particle is inside voxel
-    TransportGetSafetyInsideAABB(
-      &local_position,
-      voxel_border_min.x, voxel_border_max.x,
-      voxel_border_min.y, voxel_border_max.y,
-      voxel_border_min.z, voxel_border_max.z,
-      GEOMETRY_TOLERANCE
-    );
-
-    // Get the distance to next boundary
-    GGfloat distance_to_next_boundary = ComputeDistanceToAABB(
-      &local_position, &local_direction,
-      voxel_border_min.x, voxel_border_max.x,
-      voxel_border_min.y, voxel_border_max.y,
-      voxel_border_min.z, voxel_border_max.z,
-      GEOMETRY_TOLERANCE
-    );
-
-    // If distance to next boundary is inferior to distance to next interaction we move particle to boundary
-    if (distance_to_next_boundary <= next_interaction_distance) {
-      next_interaction_distance = distance_to_next_boundary + GEOMETRY_TOLERANCE;
-      next_discrete_process = TRANSPORTATION;
       #if defined(DOSIMETRY)
-      if (photon_tracking) dose_photon_tracking(dose_params, photon_tracking, &local_position);
+      GGfloat3 segment_center = local_position + local_direction*(travelled_distance + 0.5f*segment_length);
+      #if defined(TLE)
+      GGfloat mu_en = 0.0f;
+      if (E_index == 0) {
+        mu_en = attenuations->mu_en_[material_id*attenuations->number_of_bins_];
+      }
+      else {
+        mu_en = LinearInterpolation(
+          attenuations->energy_bins_[E_index-1], attenuations->mu_en_[material_id*attenuations->number_of_bins_ + E_index-1],
+          attenuations->energy_bins_[E_index], attenuations->mu_en_[material_id*attenuations->number_of_bins_ + E_index],
+          initial_energy
+        );
+      }
+      GGfloat edep = initial_energy * mu_en * segment_length * 0.1f;
+      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, edep, &segment_center);
+      #endif
       #endif
-    }
+
+      travelled_distance += segment_length;
+
+      // Interaction in current voxel, stopping walk
+      if (next_discrete_process != TRANSPORTATION) break;
+
+      #if defined(DOSIMETRY)
+      if (photon_tracking) dose_photon_tracking(dose_params, photon_tracking, &segment_center);
+      #endif
+
+      // Consuming mean free paths of the voxel and stepping to next voxel
+      remaining_mean_free_paths -= segment_mean_free_paths;
+      if (next_border_distance.x <= next_border_distance.y && next_border_distance.x <= next_border_distance.z) {
+        voxel_id.x += voxel_step.x;
+        next_border_distance.x += voxel_crossing_distance.x;
+      }
+      else if (next_border_distance.y <= next_border_distance.z) {
+        voxel_id.y += voxel_step.y;
+        next_border_distance.y += voxel_crossing_distance.y;
+      }
+      else {
+        voxel_id.z += voxel_step.z;
+        next_border_distance.z += voxel_crossing_distance.z;
+      }
+    } while (voxel_id.x >= 0 && voxel_id.x < number_of_voxels.x && voxel_id.y >= 0 && voxel_id.y < number_of_voxels.y && voxel_id.z >= 0 && voxel_id.z < number_of_voxels.z);
+    #endif
 
     #if defined(GGEMS_TRACKING)
-    if (global_id == primary_particle->particle_tracking_id) {
+    if (particle.is_tracked_) {
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] ################################################################################\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Particle id: %d\n", global_id);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Particle type: ");
@@ -172,7 +278,7 @@ kernel void track_through_ggems_voxelized_solid(
       else if (primary_particle->pname_[global_id] == POSITRON) printf("e+\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Local direction (x, y, z): %e %e %e\n", local_direction.x, local_direction.y, local_direction.z);
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Energy: %e keV\n", primary_particle->E_[global_id]/keV);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Energy: %e keV\n", particle.E_/keV);
       printf("\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Solid id: %u\n", voxelized_solid_data->solid_id_);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Nb voxels: %u %u %u\n", number_of_voxels.x, number_of_voxels.y, number_of_voxels.z);
@@ -180,10 +286,7 @@ kernel void track_through_ggems_voxelized_solid(
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Solid X Borders: %e %e mm\n", border_min.x/mm, border_max.x/mm);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Solid Y Borders: %e %e mm\n", border_min.y/mm, border_max.y/mm);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Solid Z Borders: %e %e mm\n", border_min.z/mm, border_max.z/mm);
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Voxel X Borders: %e %e mm\n", voxel_border_min.x/mm, voxel_border_max.x/mm);
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Voxel Y Borders: %e %e mm\n", voxel_border_min.y/mm, voxel_border_max.y/mm);
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Voxel Z Borders: %e %e mm\n", voxel_border_min.z/mm, voxel_border_max.z/mm);
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Index of current voxel (x, y, z): %d %d %d\n", voxel_id.x, voxel_id.y, voxel_id.z);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Index of voxel at end of free flight (x, y, z): %d %d %d\n", voxel_id.x, voxel_id.y, voxel_id.z);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Material in voxel: %s\n", particle_cross_sections->material_names_[material_id]);
       printf("\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Next process: ");
@@ -191,114 +294,70 @@ kernel void track_through_ggems_voxelized_solid(
       if (next_discrete_process == PHOTOELECTRIC_EFFECT) printf("PHOTOELECTRIC_EFFECT\n");
       if (next_discrete_process == RAYLEIGH_SCATTERING) printf("RAYLEIGH_SCATTERING\n");
       if (next_discrete_process == TRANSPORTATION) printf("TRANSPORTATION\n");
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Next interaction distance: %e mm\n", next_interaction_distance/mm);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Next interaction distance: %e mm\n", travelled_distance/mm);
     }
     #endif
 
-    // Moving particle to next position
-    local_position = local_position + local_direction*next_interaction_distance;
-
-    // Get safety position of particle to be sure particle is outside voxel
-    TransportGetSafetyOutsideAABB(
-      &local_position,
-      voxel_border_min.x, voxel_border_max.x,
-      voxel_border_min.y, voxel_border_max.y,
-      voxel_border_min.z, voxel_border_max.z,
-      GEOMETRY_TOLERANCE
-    );
-
-    //  Checking if particle outside solid, still in local
-    if (!IsParticleInAABB(&local_position, border_min.x, border_max.x, border_min.y, border_max.y, border_min.z, border_max.z, GEOMETRY_TOLERANCE)) {
+    // Particle left the voxel grid, moving it outside solid
+    if (next_discrete_process == TRANSPORTATION) {
+      local_position = local_position + local_direction*(travelled_distance + GEOMETRY_TOLERANCE);
       primary_particle->particle_solid_distance_[global_id] = OUT_OF_WORLD; // Reset to initiale value
       primary_particle->solid_id_[global_id] = -1; // Out of world
       break;
     }
 
-    // Storing new position in local
-    primary_particle->px_[global_id] = local_position.x;
-    primary_particle->py_[global_id] = local_position.y;
-    primary_particle->pz_[global_id] = local_position.z;
-
-    #if defined(DOSIMETRY)
-    GGfloat initial_energy = primary_particle->E_[global_id];
-    #endif
-
-    // Resolve process if different of TRANSPORTATION
-    if (next_discrete_process != TRANSPORTATION) {
+    // Moving particle to interaction position
+    local_position = local_position + local_direction*travelled_distance;
+    particle.next_interaction_distance_ = travelled_distance;
+    particle.next_discrete_process_ = next_discrete_process;
 
-      PhotonDiscreteProcess(primary_particle, random, materials, particle_cross_sections, material_id, global_id);
+    // Resolve process
+    PhotonDiscreteProcess(&particle, random, materials, particle_cross_sections, material_id, global_id);
 
-      // If process is COMPTON_SCATTERING or RAYLEIGH_SCATTERING scatter order is incremented
-      if (next_discrete_process == COMPTON_SCATTERING || next_discrete_process == RAYLEIGH_SCATTERING)
-      {
-        primary_particle->scatter_[global_id] = TRUE;
-      }
+    // If process is COMPTON_SCATTERING or RAYLEIGH_SCATTERING scatter order is incremented
+    if (next_discrete_process == COMPTON_SCATTERING || next_discrete_process == RAYLEIGH_SCATTERING)
+    {
+      particle.scatter_ = TRUE;
+    }
 
-      #if defined(DOSIMETRY) && !defined(TLE)
-      GGfloat edep = initial_energy - primary_particle->E_[global_id];
-      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, edep, &local_position);
-      #endif
+    #if defined(DOSIMETRY) && !defined(TLE)
+    GGfloat edep = initial_energy - particle.E_;
+    dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, edep, &local_position);
+    #endif
 
-      local_direction.x = primary_particle->dx_[global_id];
-      local_direction.y = primary_particle->dy_[global_id];
-      local_direction.z = primary_particle->dz_[global_id];
+    local_direction = particle.direction_;
 
-      #if defined(OPENGL)
-      if (global_id < MAXIMUM_DISPLAYED_PARTICLES) {
-        // Storing OpenGL index on OpenCL private memory
-        GGint stored_particles_gl = primary_particle->stored_particles_gl_[global_id];
+    #if defined(OPENGL)
+    if (global_id < MAXIMUM_DISPLAYED_PARTICLES) {
+      // Storing OpenGL index on OpenCL private memory
+      GGint stored_particles_gl = trajectories->stored_particles_gl_[global_id];
 
-        // Checking if buffer is full
-        if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
-          // Getting global position
-          global_position = LocalToGlobalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_position);
+      // Checking if buffer is full
+      if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
+        // Getting global position
+        GGfloat3 global_position = LocalToGlobalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_position);
 
-          primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.x;
-          primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.y;
-          primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.z;
+        trajectories->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.x;
+        trajectories->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.y;
+        trajectories->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.z;
 
-          // Storing final index
-          primary_particle->stored_particles_gl_[global_id] += 1;
-        }
+        // Storing final index
+        trajectories->stored_particles_gl_[global_id] += 1;
       }
-      #endif
     }
-
-    #if defined(DOSIMETRY) && defined(TLE)
-    GGint E_index = BinarySearchLeft(initial_energy, attenuations->energy_bins_, attenuations->number_of_bins_, 0, 0);
-    GGfloat mu_en = 0.0f;
-    if (E_index == 0) {
-      mu_en = attenuations->mu_en_[material_id*attenuations->number_of_bins_];
-    }
-    else {
-      mu_en = LinearInterpolation(
-        attenuations->energy_bins_[E_index-1], attenuations->mu_en_[material_id*attenuations->number_of_bins_ + E_index-1],
-        attenuations->energy_bins_[E_index], attenuations->mu_en_[material_id*attenuations->number_of_bins_ + E_index],
-        initial_energy
-      );
-    }
-    GGfloat edep = initial_energy * mu_en * next_interaction_distance * 0.1f;
-    dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, edep, &local_position);
     #endif
 
     // Apply threshold
-    if (primary_particle->E_[global_id] <= materials->photon_energy_cut_[material_id]) {
+    if (particle.E_ <= materials->photon_energy_cut_[material_id]) {
       #if defined(DOSIMETRY)
-      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, primary_particle->E_[global_id], &local_position);
+      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, particle.E_, &local_position);
       #endif
-      primary_particle->status_[global_id] = DEAD;
+      particle.status_ = DEAD;
     }
-  } while (primary_particle->status_[global_id] == ALIVE);
-
-  // Convert to global position
-  global_position = LocalToGlobalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_position);
-  primary_particle->px_[global_id] = global_position.x;
-  primary_particle->py_[global_id] = global_position.y;
-  primary_particle->pz_[global_id] = global_position.z;
-
-  // Convert to global direction
-  global_direction = LocalToGlobalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_direction);
-  primary_particle->dx_[global_id] = global_direction.x;
-  primary_particle->dy_[global_id] = global_direction.y;
-  primary_particle->dz_[global_id] = global_direction.z;
+  } while (particle.status_ == ALIVE);
+
+  // Convert to global position and direction, and storing particle in global memory
+  particle.position_ = LocalToGlobalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_position);
+  particle.direction_ = LocalToGlobalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_direction);
+  StoreParticle(primary_particle, random, &particle, global_id);
 }
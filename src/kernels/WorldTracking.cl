@@ -74,6 +74,11 @@ kernel void world_tracking(
   // Return if index > to particle limit
   if (global_id >= particle_id_limit) return;
 
+  #ifdef PARTICLE_COMPACTION
+  // Thread index to index of live particle, list built by compaction stage
+  global_id = primary_particle->live_index_[global_id];
+  #endif
+
   if (primary_particle->status_[global_id] == DEAD) return;
 
   // In world, the particles is tracked using a DDA algorithm
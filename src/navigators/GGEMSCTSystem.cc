@@ -412,6 +412,15 @@ void store_scatter_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_scatt
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void set_multi_solid_navigation_ggems_ct_system(GGEMSCTSystem* ct_system, bool const flag)
+{
+  ct_system->SetMultiSolidNavigation(flag);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void set_visible_ggems_ct_system(GGEMSCTSystem* ct_system, bool const flag)
 {
   ct_system->SetVisible(flag);
@@ -27,11 +27,18 @@
   \date Wednesday January 13, 2021
 */
 
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
 #include "GGEMS/navigators/GGEMSDosimetryCalculator.hh"
 #include "GGEMS/navigators/GGEMSDoseParams.hh"
 #include "GGEMS/geometries/GGEMSVoxelizedSolid.hh"
 #include "GGEMS/io/GGEMSMHDImage.hh"
 #include "GGEMS/tools/GGEMSProfilerManager.hh"
+#include "GGEMS/tools/GGEMSChrono.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -48,7 +55,11 @@ GGEMSDosimetryCalculator::GGEMSDosimetryCalculator(void)
   scale_factor_(1.0f),
   is_water_reference_(FALSE),
   minimum_density_(0.0f),
-  kernel_compute_dose_(nullptr)
+  number_of_replicas_(1),
+  is_fixed_point_(false),
+  edep_quantum_(1.0f*eV),
+  kernel_compute_dose_(nullptr),
+  kernel_reduce_dose_replicas_(nullptr)
 {
   GGcout("GGEMSDosimetryCalculator", "GGEMSDosimetryCalculator", 3) << "GGEMSDosimetryCalculator creating..." << GGendl;
 
@@ -106,7 +117,7 @@ GGEMSDosimetryCalculator::~GGEMSDosimetryCalculator(void)
 
   if (dose_recording_.edep_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(dose_recording_.edep_[i], total_number_of_dosels_*sizeof(GGDosiType), i);
+      opencl_manager.Deallocate(dose_recording_.edep_[i], number_of_replicas_*total_number_of_dosels_*GetEdepTypeSize(), i);
     }
     delete[] dose_recording_.edep_;
     dose_recording_.edep_ = nullptr;
@@ -133,7 +144,7 @@ GGEMSDosimetryCalculator::~GGEMSDosimetryCalculator(void)
   if (dose_recording_.edep_squared_) {
     if (is_edep_squared_||is_uncertainty_) {
       for (GGsize i = 0; i < number_activated_devices_; ++i) {
-        opencl_manager.Deallocate(dose_recording_.edep_squared_[i], total_number_of_dosels_*sizeof(GGDosiType), i);
+        opencl_manager.Deallocate(dose_recording_.edep_squared_[i], number_of_replicas_*total_number_of_dosels_*GetEdepTypeSize(), i);
       }
     }
     delete[] dose_recording_.edep_squared_;
@@ -143,7 +154,7 @@ GGEMSDosimetryCalculator::~GGEMSDosimetryCalculator(void)
   if (dose_recording_.hit_) {
     if (is_hit_tracking_||is_uncertainty_) {
       for (GGsize i = 0; i < number_activated_devices_; ++i) {
-        opencl_manager.Deallocate(dose_recording_.hit_[i], total_number_of_dosels_*sizeof(GGint), i);
+        opencl_manager.Deallocate(dose_recording_.hit_[i], number_of_replicas_*total_number_of_dosels_*sizeof(GGint), i);
       }
     }
     delete[] dose_recording_.hit_;
@@ -165,6 +176,11 @@ GGEMSDosimetryCalculator::~GGEMSDosimetryCalculator(void)
     kernel_compute_dose_ = nullptr;
   }
 
+  if (kernel_reduce_dose_replicas_) {
+    delete[] kernel_reduce_dose_replicas_;
+    kernel_reduce_dose_replicas_ = nullptr;
+  }
+
   GGcout("GGEMSDosimetryCalculator", "~GGEMSDosimetryCalculator", 3) << "GGEMSSourceManager erased!!!" << GGendl;
 }
 
@@ -267,6 +283,48 @@ void GGEMSDosimetryCalculator::SetTLE(bool const& is_activated)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
+void GGEMSDosimetryCalculator::SetScoringBackend(std::string const& scoring_backend, GGsize const& number_of_replicas)
+{
+  if (scoring_backend == "atomic") {
+    number_of_replicas_ = 1;
+  }
+  else if (scoring_backend == "replicated") {
+    if (number_of_replicas < 2) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Replicated scoring backend needs at least 2 copies of dose maps!!!";
+      GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "SetScoringBackend", oss.str());
+    }
+    number_of_replicas_ = number_of_replicas;
+  }
+  else {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Unknown scoring backend '" << scoring_backend << "'!!! Available backends are:" << std::endl;
+    oss << "    - atomic" << std::endl;
+    oss << "    - replicated";
+    GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "SetScoringBackend", oss.str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSDosimetryCalculator::SetFixedPointScoring(bool const& is_activated, GGfloat const& quantum, std::string const& unit)
+{
+  is_fixed_point_ = is_activated;
+  edep_quantum_ = EnergyUnit(quantum, unit);
+
+  if (edep_quantum_ <= 0.0f) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Energy of a quantum for fixed-point scoring has to be positive!!!";
+    GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "SetFixedPointScoring", oss.str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSDosimetryCalculator::SetWaterReference(bool const& is_activated)
 {
   if (is_activated) is_water_reference_ = TRUE;
@@ -309,67 +367,178 @@ void GGEMSDosimetryCalculator::InitializeKernel(void)
   // Getting the path to kernel
   std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
   std::string compute_dose_filename = openCL_kernel_path + "/ComputeDoseGGEMSVoxelizedSolid.cl";
+  std::string reduce_dose_replicas_filename = openCL_kernel_path + "/ReduceDoseReplicas.cl";
+
+  // Edep buffers store numbers of quanta with fixed-point scoring
+  std::string kernel_option = is_fixed_point_ ? " -DDOSE_FIXED_POINT" : "";
 
   // Storing a kernel for each device
   kernel_compute_dose_ = new cl::Kernel*[number_activated_devices_];
 
   // Compiling the kernels
-  opencl_manager.CompileKernel(compute_dose_filename, "compute_dose_ggems_voxelized_solid", kernel_compute_dose_, nullptr, nullptr);
+  opencl_manager.CompileKernel(compute_dose_filename, "compute_dose_ggems_voxelized_solid", kernel_compute_dose_, nullptr, const_cast<char*>(kernel_option.c_str()));
+
+  // Merging copies of dose maps only with replicated backend
+  if (number_of_replicas_ > 1) {
+    kernel_reduce_dose_replicas_ = new cl::Kernel*[number_activated_devices_];
+    opencl_manager.CompileKernel(reduce_dose_replicas_filename, "reduce_dose_replicas", kernel_reduce_dose_replicas_, nullptr, const_cast<char*>(kernel_option.c_str()));
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSDosimetryCalculator::ComputeDose(GGsize const& thread_index)
+template <typename T>
+bool GGEMSDosimetryCalculator::SumOverDevices(cl::Buffer** buffers) const
 {
-  // Getting the OpenCL manager and infos for work-item launching
+  // Buffer not allocated for this output
+  if (!buffers[0]) return false;
+
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  GGsize size = total_number_of_dosels_*sizeof(T);
+
+  // Dosels are split in contiguous chunks summed by host threads
+  GGsize const kMinimumDoselsByThread = 65536;
+  GGsize number_of_threads = std::max(static_cast<GGsize>(std::thread::hardware_concurrency()), static_cast<GGsize>(1));
+  number_of_threads = std::min(number_of_threads, (total_number_of_dosels_ + kMinimumDoselsByThread - 1) / kMinimumDoselsByThread);
+  GGsize dosels_by_thread = (total_number_of_dosels_ + number_of_threads - 1) / number_of_threads;
+
+  T* sum = opencl_manager.GetDeviceBuffer<T>(buffers[0], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, size, 0);
+
+  // Overflow flag of each thread, only unsigned sums (fixed-point quanta) are checked
+  std::vector<GGchar> is_thread_overflow(number_of_threads, 0);
+
+  for (GGsize j = 1; j < number_activated_devices_; ++j) {
+    T* partial = opencl_manager.GetDeviceBuffer<T>(buffers[j], CL_TRUE, CL_MAP_READ, size, j);
+
+    std::vector<std::thread> threads;
+    for (GGsize t = 0; t < number_of_threads; ++t) {
+      GGsize first = t*dosels_by_thread;
+      GGsize last = std::min(first + dosels_by_thread, total_number_of_dosels_);
+      if (first >= last) break;
+      GGchar* is_overflow = &is_thread_overflow[t];
+      threads.emplace_back([sum, partial, first, last, is_overflow]() {
+        for (GGsize i = first; i < last; ++i) {
+          if constexpr (std::is_unsigned<T>::value) {
+            if (sum[i] > std::numeric_limits<T>::max() - partial[i]) *is_overflow = 1;
+          }
+          sum[i] += partial[i];
+        }
+      });
+    }
+    for (auto&& thread : threads) thread.join();
 
-  // Get Device name and storing methode name + device
-  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
-  std::string device_name = opencl_manager.GetDeviceName(device_index);
-  std::ostringstream oss(std::ostringstream::out);
-  oss << "GGEMSDosimetryCalculator::ComputeDose in " << device_name << ", index " << device_index;
+    opencl_manager.ReleaseDeviceBuffer(buffers[j], partial, j);
+  }
 
-  // Get pointer on OpenCL device for dose parameters
-  GGEMSDoseParams* dose_params_device = opencl_manager.GetDeviceBuffer<GGEMSDoseParams>(dose_params_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSDoseParams), thread_index);
+  opencl_manager.ReleaseDeviceBuffer(buffers[0], sum, 0);
 
-  GGsize number_of_dosels = static_cast<GGsize>(dose_params_device->total_number_of_dosels_);
+  return std::find(is_thread_overflow.begin(), is_thread_overflow.end(), 1) != is_thread_overflow.end();
+}
 
-  // Release the pointer
-  opencl_manager.ReleaseDeviceBuffer(dose_params_[thread_index], dose_params_device, thread_index);
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSDosimetryCalculator::ComputeDose(void)
+{
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
-  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_dosels);
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(total_number_of_dosels_);
 
   // Parameters for work-item in kernel
   cl::NDRange global_wi(number_of_work_items);
   cl::NDRange local_wi(work_group_size);
 
+  for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    // Get Device name
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(j);
+    std::string device_name = opencl_manager.GetDeviceName(device_index);
+
+    // Sums of quanta are wrong after an overflow
+    GGEMSDoseParams* dose_params_device = opencl_manager.GetDeviceBuffer<GGEMSDoseParams>(dose_params_[j], CL_TRUE, CL_MAP_READ, sizeof(GGEMSDoseParams), j);
+    if (dose_params_device->fixed_point_overflow_) {
+      GGwarn("GGEMSDosimetryCalculator", "ComputeDose", 0) << "Overflow of fixed-point energy sums on " << device_name << "!!! Increase energy of a quantum (SetFixedPointScoring)" << GGendl;
+    }
+    opencl_manager.ReleaseDeviceBuffer(dose_params_[j], dose_params_device, j);
+
+    // Merging copies of dose maps in the first one, devices work in parallel
+    if (number_of_replicas_ > 1) {
+      kernel_reduce_dose_replicas_[j]->setArg(0, total_number_of_dosels_);
+      kernel_reduce_dose_replicas_[j]->setArg(1, static_cast<GGint>(number_of_replicas_));
+      kernel_reduce_dose_replicas_[j]->setArg(2, *dose_recording_.edep_[j]);
+      if (!dose_recording_.edep_squared_[j]) kernel_reduce_dose_replicas_[j]->setArg(3, sizeof(cl_mem), nullptr);
+      else kernel_reduce_dose_replicas_[j]->setArg(3, *dose_recording_.edep_squared_[j]);
+      if (!dose_recording_.hit_[j]) kernel_reduce_dose_replicas_[j]->setArg(4, sizeof(cl_mem), nullptr);
+      else kernel_reduce_dose_replicas_[j]->setArg(4, *dose_recording_.hit_[j]);
+
+      cl::Event reduce_event;
+      GGint reduce_status = opencl_manager.GetCommandQueue(j)->enqueueNDRangeKernel(*kernel_reduce_dose_replicas_[j], 0, global_wi, local_wi, nullptr, &reduce_event);
+      opencl_manager.CheckOpenCLError(reduce_status, "GGEMSDosimetryCalculator", "ComputeDose");
+
+      std::ostringstream oss_reduce(std::ostringstream::out);
+      oss_reduce << "GGEMSDosimetryCalculator::ReduceDoseReplicas in " << device_name << ", index " << device_index;
+      GGEMSProfilerManager::GetInstance().HandleEvent(reduce_event, oss_reduce.str());
+    }
+  }
+
+  for (GGsize j = 0; j < number_activated_devices_; ++j) opencl_manager.GetCommandQueue(j)->finish();
+
+  // Raw accumulators of all devices are merged in buffers of first device, dose and uncertainty are computed once from merged sums
+  if (number_activated_devices_ > 1) {
+    ChronoTime start_time = GGEMSChrono::Now();
+
+    if (is_fixed_point_) {
+      bool is_overflow = SumOverDevices<GGulong>(dose_recording_.edep_);
+      is_overflow |= SumOverDevices<GGulong>(dose_recording_.edep_squared_);
+
+      // Sums of devices can wrap even if each device did not
+      if (is_overflow) {
+        GGwarn("GGEMSDosimetryCalculator", "ComputeDose", 0) << "Overflow of fixed-point energy sums merging devices!!! Increase energy of a quantum (SetFixedPointScoring)" << GGendl;
+      }
+    }
+    else {
+      SumOverDevices<GGDosiType>(dose_recording_.edep_);
+      SumOverDevices<GGDosiType>(dose_recording_.edep_squared_);
+    }
+    SumOverDevices<GGint>(dose_recording_.hit_);
+    SumOverDevices<GGint>(dose_recording_.photon_tracking_);
+
+    GGcout("GGEMSDosimetryCalculator", "ComputeDose", 2) << "Dose maps of " << number_activated_devices_ << " devices merged in " << std::chrono::duration_cast<Ms>(GGEMSChrono::Now() - start_time).count() << " ms" << GGendl;
+  }
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(0);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSDosimetryCalculator::ComputeDose in " << device_name << ", index " << device_index;
+
   // Getting kernel, and setting parameters
-  kernel_compute_dose_[thread_index]->setArg(0, number_of_dosels);
-  kernel_compute_dose_[thread_index]->setArg(1, *dose_params_[thread_index]);
-  kernel_compute_dose_[thread_index]->setArg(2, *dose_recording_.edep_[thread_index]);
-  if (!dose_recording_.hit_[thread_index]) kernel_compute_dose_[thread_index]->setArg(3, sizeof(cl_mem), nullptr);
-  else kernel_compute_dose_[thread_index]->setArg(3, *dose_recording_.hit_[thread_index]);
-  if (!dose_recording_.edep_squared_[thread_index]) kernel_compute_dose_[thread_index]->setArg(4, sizeof(cl_mem), nullptr);
-  else kernel_compute_dose_[thread_index]->setArg(4, *dose_recording_.edep_squared_[thread_index]);
-  kernel_compute_dose_[thread_index]->setArg(5, *navigator_->GetSolids(0)->GetSolidData(thread_index)); // 1 solid in voxelized phantom
-  kernel_compute_dose_[thread_index]->setArg(6, *navigator_->GetSolids(0)->GetLabelData(thread_index));
-  kernel_compute_dose_[thread_index]->setArg(7, *navigator_->GetMaterials()->GetMaterialTables(thread_index));
-  kernel_compute_dose_[thread_index]->setArg(8, *dose_recording_.dose_[thread_index]);
-  if (!dose_recording_.uncertainty_dose_[thread_index]) kernel_compute_dose_[thread_index]->setArg(9, sizeof(cl_mem), nullptr);
-  else kernel_compute_dose_[thread_index]->setArg(9, *dose_recording_.uncertainty_dose_[thread_index]);
-  kernel_compute_dose_[thread_index]->setArg(10, scale_factor_);
-  kernel_compute_dose_[thread_index]->setArg(11, is_water_reference_);
-  kernel_compute_dose_[thread_index]->setArg(12, minimum_density_);
+  kernel_compute_dose_[0]->setArg(0, total_number_of_dosels_);
+  kernel_compute_dose_[0]->setArg(1, *dose_params_[0]);
+  kernel_compute_dose_[0]->setArg(2, *dose_recording_.edep_[0]);
+  if (!dose_recording_.hit_[0]) kernel_compute_dose_[0]->setArg(3, sizeof(cl_mem), nullptr);
+  else kernel_compute_dose_[0]->setArg(3, *dose_recording_.hit_[0]);
+  if (!dose_recording_.edep_squared_[0]) kernel_compute_dose_[0]->setArg(4, sizeof(cl_mem), nullptr);
+  else kernel_compute_dose_[0]->setArg(4, *dose_recording_.edep_squared_[0]);
+  kernel_compute_dose_[0]->setArg(5, *navigator_->GetSolids(0)->GetSolidData(0)); // 1 solid in voxelized phantom
+  kernel_compute_dose_[0]->setArg(6, *navigator_->GetSolids(0)->GetLabelData(0));
+  kernel_compute_dose_[0]->setArg(7, *navigator_->GetMaterials()->GetMaterialTables(0));
+  kernel_compute_dose_[0]->setArg(8, *dose_recording_.dose_[0]);
+  if (!dose_recording_.uncertainty_dose_[0]) kernel_compute_dose_[0]->setArg(9, sizeof(cl_mem), nullptr);
+  else kernel_compute_dose_[0]->setArg(9, *dose_recording_.uncertainty_dose_[0]);
+  kernel_compute_dose_[0]->setArg(10, scale_factor_);
+  kernel_compute_dose_[0]->setArg(11, is_water_reference_);
+  kernel_compute_dose_[0]->setArg(12, minimum_density_);
 
   // Launching kernel
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(0);
   cl::Event event;
-  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_compute_dose_[thread_index], 0, global_wi, local_wi, nullptr, &event);
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_compute_dose_[0], 0, global_wi, local_wi, nullptr, &event);
   opencl_manager.CheckOpenCLError(kernel_status, "GGEMSDosimetryCalculator", "ComputeDose");
   queue->finish();
 
@@ -448,26 +617,44 @@ void GGEMSDosimetryCalculator::Initialize(void)
     total_number_of_dosels_ = number_of_dosels.x_ * number_of_dosels.y_ * number_of_dosels.z_;
     dose_params_device->total_number_of_dosels_ = static_cast<GGint>(total_number_of_dosels_);
 
+    // Copies of dose maps are indexed with GGint in kernels
+    if (number_of_replicas_ * total_number_of_dosels_ > static_cast<GGsize>(std::numeric_limits<GGint>::max())) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Too many copies of dose maps (" << number_of_replicas_ << ") for " << total_number_of_dosels_ << " dosels!!!";
+      GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "Initialize", oss.str());
+    }
+    dose_params_device->number_of_replicas_ = static_cast<GGint>(number_of_replicas_);
+
+    // Fixed-point scoring needs 64 bits integer atomics
+    if (is_fixed_point_ && !opencl_manager.IsDoublePrecisionAtomicAddition(opencl_manager.GetIndexOfActivatedDevice(j))) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Your OpenCL device: " << opencl_manager.GetDeviceName(opencl_manager.GetIndexOfActivatedDevice(j)) << ", does not support 64 bits integer atomics needed by fixed-point scoring!!!";
+      GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "Initialize", oss.str());
+    }
+    dose_params_device->edep_quantum_ = edep_quantum_;
+    dose_params_device->inverse_edep_quantum_ = 1.0f / edep_quantum_;
+    dose_params_device->fixed_point_overflow_ = 0;
+
     // Release the pointer
     opencl_manager.ReleaseDeviceBuffer(dose_params_[j], dose_params_device, j);
 
     // Allocated buffers storing dose on OpenCL device
-    dose_recording_.edep_[j] = opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGDosiType), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+    dose_recording_.edep_[j] = opencl_manager.Allocate(nullptr, number_of_replicas_*total_number_of_dosels_*GetEdepTypeSize(), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
     dose_recording_.dose_[j] = opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGfloat), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
 
     dose_recording_.uncertainty_dose_[j] = is_uncertainty_ ? opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGfloat), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
-    dose_recording_.edep_squared_[j] = (is_edep_squared_||is_uncertainty_) ? opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGDosiType), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
-    dose_recording_.hit_[j] = (is_hit_tracking_||is_uncertainty_) ? opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
+    dose_recording_.edep_squared_[j] = (is_edep_squared_||is_uncertainty_) ? opencl_manager.Allocate(nullptr, number_of_replicas_*total_number_of_dosels_*GetEdepTypeSize(), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
+    dose_recording_.hit_[j] = (is_hit_tracking_||is_uncertainty_) ? opencl_manager.Allocate(nullptr, number_of_replicas_*total_number_of_dosels_*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
 
     dose_recording_.photon_tracking_[j] = is_photon_tracking_ ? opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
 
     // Set buffer to zero
-    opencl_manager.CleanBuffer(dose_recording_.edep_[j], total_number_of_dosels_*sizeof(GGDosiType), j);
+    opencl_manager.CleanBuffer(dose_recording_.edep_[j], number_of_replicas_*total_number_of_dosels_*GetEdepTypeSize(), j);
     opencl_manager.CleanBuffer(dose_recording_.dose_[j], total_number_of_dosels_*sizeof(GGfloat), j);
 
     if (is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.uncertainty_dose_[j], total_number_of_dosels_*sizeof(GGfloat), j);
-    if (is_edep_squared_||is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.edep_squared_[j], total_number_of_dosels_*sizeof(GGDosiType), j);
-    if (is_hit_tracking_||is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.hit_[j], total_number_of_dosels_*sizeof(GGint), j);
+    if (is_edep_squared_||is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.edep_squared_[j], number_of_replicas_*total_number_of_dosels_*GetEdepTypeSize(), j);
+    if (is_hit_tracking_||is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.hit_[j], number_of_replicas_*total_number_of_dosels_*sizeof(GGint), j);
 
     if (is_photon_tracking_) opencl_manager.CleanBuffer(dose_recording_.photon_tracking_[j], total_number_of_dosels_*sizeof(GGint), j);
   }
@@ -479,6 +666,195 @@ void GGEMSDosimetryCalculator::Initialize(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSDosimetryCalculator::BenchmarkScoring(GGsize const& number_of_deposits) const
+{
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  GGsize number_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
+
+  // Compiling kernels on each device, with floating-point and fixed-point deposits
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  char fixed_point_option[] = " -DDOSE_FIXED_POINT";
+  cl::Kernel** kernel_benchmark[2] = {new cl::Kernel*[number_activated_devices], new cl::Kernel*[number_activated_devices]};
+  cl::Kernel** kernel_reduce[2] = {new cl::Kernel*[number_activated_devices], new cl::Kernel*[number_activated_devices]};
+  opencl_manager.CompileKernel(openCL_kernel_path + "/BenchmarkDoseScoring.cl", "benchmark_dose_scoring", kernel_benchmark[0], nullptr, nullptr);
+  opencl_manager.CompileKernel(openCL_kernel_path + "/ReduceDoseReplicas.cl", "reduce_dose_replicas", kernel_reduce[0], nullptr, nullptr);
+
+  // Fixed-point kernels only on devices with 64 bits integer atomics
+  bool is_fixed_point_available = true;
+  for (GGsize j = 0; j < number_activated_devices; ++j) {
+    if (!opencl_manager.IsDoublePrecisionAtomicAddition(opencl_manager.GetIndexOfActivatedDevice(j))) is_fixed_point_available = false;
+  }
+  if (is_fixed_point_available) {
+    opencl_manager.CompileKernel(openCL_kernel_path + "/BenchmarkDoseScoring.cl", "benchmark_dose_scoring", kernel_benchmark[1], nullptr, fixed_point_option);
+    opencl_manager.CompileKernel(openCL_kernel_path + "/ReduceDoseReplicas.cl", "reduce_dose_replicas", kernel_reduce[1], nullptr, fixed_point_option);
+  }
+  else {
+    GGwarn("GGEMSDosimetryCalculator", "BenchmarkScoring", 0) << "64 bits integer atomics are not supported on all devices, fixed-point scoring is not benchmarked!!!" << GGendl;
+  }
+
+  // Hot-spot of 4x4x4 dosels of 1 mm
+  GGint const kHotSpotDosels = 64;
+  GGint deposits_per_work_item = 64;
+  GGsize number_of_work_items = (number_of_deposits + static_cast<GGsize>(deposits_per_work_item) - 1) / static_cast<GGsize>(deposits_per_work_item);
+  GGdouble total_deposits = static_cast<GGdouble>(number_of_work_items) * static_cast<GGdouble>(deposits_per_work_item);
+
+  // Reference energy in each dosel, replaying deposits of kernel in double precision
+  GGdouble reference_edep[kHotSpotDosels];
+  for (GGint i = 0; i < kHotSpotDosels; ++i) reference_edep[i] = 0.0;
+  for (GGsize i = 0; i < number_of_work_items; ++i) {
+    GGuint hash = static_cast<GGuint>(i) * 2654435761u + 1u;
+    for (GGint k = 0; k < deposits_per_work_item; ++k) {
+      hash ^= hash << 13;
+      hash ^= hash >> 17;
+      hash ^= hash << 5;
+      reference_edep[hash % static_cast<GGuint>(kHotSpotDosels)] += static_cast<GGdouble>((1.0f + static_cast<GGfloat>(hash >> 8) * (99.0f / 16777216.0f)) * keV);
+    }
+  }
+
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  cl::NDRange global_wi(opencl_manager.GetBestWorkItem(number_of_work_items));
+  cl::NDRange reduce_global_wi(opencl_manager.GetBestWorkItem(static_cast<GGsize>(kHotSpotDosels)));
+  cl::NDRange local_wi(work_group_size);
+
+  GGint const kReplicas[] = {1, 2, 4, 8, 16, 32};
+
+  for (GGsize j = 0; j < number_activated_devices; ++j) {
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(j);
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(j);
+    cl::Buffer* dose_params = opencl_manager.Allocate(nullptr, sizeof(GGEMSDoseParams), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+
+    for (GGint mode = 0; mode < (is_fixed_point_available ? 2 : 1); ++mode) {
+      bool is_fixed_point = mode == 1;
+      GGsize edep_type_size = is_fixed_point ? sizeof(GGulong) : sizeof(GGDosiType);
+
+      for (GGint number_of_replicas : kReplicas) {
+        GGEMSDoseParams* dose_params_device = opencl_manager.GetDeviceBuffer<GGEMSDoseParams>(dose_params, CL_TRUE, CL_MAP_WRITE, sizeof(GGEMSDoseParams), j);
+        for (GGint i = 0; i < 3; ++i) {
+          dose_params_device->size_of_dosels_.s[i] = 1.0f;
+          dose_params_device->inv_size_of_dosels_.s[i] = 1.0f;
+          dose_params_device->border_min_xyz_.s[i] = -2.0f;
+          dose_params_device->border_max_xyz_.s[i] = 2.0f;
+          dose_params_device->number_of_dosels_.s[i] = 4;
+        }
+        dose_params_device->total_number_of_dosels_ = kHotSpotDosels;
+        dose_params_device->slice_number_of_dosels_ = 16;
+        dose_params_device->number_of_replicas_ = number_of_replicas;
+        dose_params_device->edep_quantum_ = edep_quantum_;
+        dose_params_device->inverse_edep_quantum_ = 1.0f / edep_quantum_;
+        dose_params_device->fixed_point_overflow_ = 0;
+        opencl_manager.ReleaseDeviceBuffer(dose_params, dose_params_device, j);
+
+        GGsize number_of_dosels = static_cast<GGsize>(number_of_replicas * kHotSpotDosels);
+        cl::Buffer* edep = opencl_manager.Allocate(nullptr, number_of_dosels*edep_type_size, j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+        cl::Buffer* edep_squared = opencl_manager.Allocate(nullptr, number_of_dosels*edep_type_size, j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+        cl::Buffer* hit = opencl_manager.Allocate(nullptr, number_of_dosels*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+        opencl_manager.CleanBuffer(edep, number_of_dosels*edep_type_size, j);
+        opencl_manager.CleanBuffer(edep_squared, number_of_dosels*edep_type_size, j);
+        opencl_manager.CleanBuffer(hit, number_of_dosels*sizeof(GGint), j);
+
+        kernel_benchmark[mode][j]->setArg(0, number_of_work_items);
+        kernel_benchmark[mode][j]->setArg(1, deposits_per_work_item);
+        kernel_benchmark[mode][j]->setArg(2, *dose_params);
+        kernel_benchmark[mode][j]->setArg(3, *edep);
+        kernel_benchmark[mode][j]->setArg(4, *edep_squared);
+        kernel_benchmark[mode][j]->setArg(5, *hit);
+
+        // Launching kernel and timing it on device
+        cl::Event event;
+        GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_benchmark[mode][j], 0, global_wi, local_wi, nullptr, &event);
+        opencl_manager.CheckOpenCLError(kernel_status, "GGEMSDosimetryCalculator", "BenchmarkScoring");
+        event.wait();
+
+        GGulong start = 0, end = 0;
+        opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(event(), CL_PROFILING_COMMAND_START, sizeof(GGulong), &start, nullptr), "GGEMSDosimetryCalculator", "BenchmarkScoring");
+        opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(event(), CL_PROFILING_COMMAND_END, sizeof(GGulong), &end, nullptr), "GGEMSDosimetryCalculator", "BenchmarkScoring");
+
+        // Merging copies, included in timing as ComputeDose does it once by run
+        if (number_of_replicas > 1) {
+          kernel_reduce[mode][j]->setArg(0, static_cast<GGsize>(kHotSpotDosels));
+          kernel_reduce[mode][j]->setArg(1, number_of_replicas);
+          kernel_reduce[mode][j]->setArg(2, *edep);
+          kernel_reduce[mode][j]->setArg(3, *edep_squared);
+          kernel_reduce[mode][j]->setArg(4, *hit);
+
+          cl::Event reduce_event;
+          kernel_status = queue->enqueueNDRangeKernel(*kernel_reduce[mode][j], 0, reduce_global_wi, local_wi, nullptr, &reduce_event);
+          opencl_manager.CheckOpenCLError(kernel_status, "GGEMSDosimetryCalculator", "BenchmarkScoring");
+          reduce_event.wait();
+
+          GGulong reduce_start = 0, reduce_end = 0;
+          opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(reduce_event(), CL_PROFILING_COMMAND_START, sizeof(GGulong), &reduce_start, nullptr), "GGEMSDosimetryCalculator", "BenchmarkScoring");
+          opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(reduce_event(), CL_PROFILING_COMMAND_END, sizeof(GGulong), &reduce_end, nullptr), "GGEMSDosimetryCalculator", "BenchmarkScoring");
+          end += reduce_end - reduce_start;
+        }
+
+        // Every deposit has to be found in the merged dose map
+        GGint* hit_device = opencl_manager.GetDeviceBuffer<GGint>(hit, CL_TRUE, CL_MAP_READ, number_of_dosels*sizeof(GGint), j);
+        GGdouble total_hits = 0.0;
+        for (GGint i = 0; i < kHotSpotDosels; ++i) total_hits += static_cast<GGdouble>(hit_device[i]);
+        opencl_manager.ReleaseDeviceBuffer(hit, hit_device, j);
+
+        // Largest relative error of energy in a dosel compared to reference
+        GGdouble max_relative_error = 0.0;
+        if (is_fixed_point) {
+          GGulong* edep_device = opencl_manager.GetDeviceBuffer<GGulong>(edep, CL_TRUE, CL_MAP_READ, number_of_dosels*sizeof(GGulong), j);
+          for (GGint i = 0; i < kHotSpotDosels; ++i) {
+            GGdouble edep_dosel = static_cast<GGdouble>(edep_device[i]) * static_cast<GGdouble>(edep_quantum_);
+            if (reference_edep[i] > 0.0) max_relative_error = std::max(max_relative_error, std::fabs(edep_dosel - reference_edep[i]) / reference_edep[i]);
+          }
+          opencl_manager.ReleaseDeviceBuffer(edep, edep_device, j);
+        }
+        else {
+          GGDosiType* edep_device = opencl_manager.GetDeviceBuffer<GGDosiType>(edep, CL_TRUE, CL_MAP_READ, number_of_dosels*sizeof(GGDosiType), j);
+          for (GGint i = 0; i < kHotSpotDosels; ++i) {
+            GGdouble edep_dosel = static_cast<GGdouble>(edep_device[i]);
+            if (reference_edep[i] > 0.0) max_relative_error = std::max(max_relative_error, std::fabs(edep_dosel - reference_edep[i]) / reference_edep[i]);
+          }
+          opencl_manager.ReleaseDeviceBuffer(edep, edep_device, j);
+        }
+
+        // Sums of quanta are wrong after an overflow
+        dose_params_device = opencl_manager.GetDeviceBuffer<GGEMSDoseParams>(dose_params, CL_TRUE, CL_MAP_READ, sizeof(GGEMSDoseParams), j);
+        bool is_overflow = dose_params_device->fixed_point_overflow_ != 0;
+        opencl_manager.ReleaseDeviceBuffer(dose_params, dose_params_device, j);
+
+        GGdouble elapsed_seconds = static_cast<GGdouble>(end - start) * 1.0e-9;
+        std::ostringstream backend_name(std::ostringstream::out);
+        if (number_of_replicas == 1) backend_name << "atomic";
+        else backend_name << "replicated (" << number_of_replicas << " copies)";
+        if (is_fixed_point) backend_name << ", fixed-point (quantum " << edep_quantum_/eV << " eV)";
+        else backend_name << ", floating-point (" << sizeof(GGDosiType)*8 << " bits)";
+        GGcout("GGEMSDosimetryCalculator", "BenchmarkScoring", 0) << backend_name.str() << " on " << opencl_manager.GetDeviceName(device_index) << ": "
+          << total_deposits / elapsed_seconds << " deposits/s (" << total_deposits << " deposits in " << elapsed_seconds * 1.0e3 << " ms), max relative error of edep: " << max_relative_error << GGendl;
+
+        if (total_hits != total_deposits) {
+          GGwarn("GGEMSDosimetryCalculator", "BenchmarkScoring", 0) << "Backend " << backend_name.str() << " scored " << total_hits << " hits instead of " << total_deposits << "!!!" << GGendl;
+        }
+
+        if (is_overflow) {
+          GGwarn("GGEMSDosimetryCalculator", "BenchmarkScoring", 0) << "Backend " << backend_name.str() << " overflowed!!! Increase energy of a quantum" << GGendl;
+        }
+
+        opencl_manager.Deallocate(edep, number_of_dosels*edep_type_size, j, "GGEMSDosimetryCalculator");
+        opencl_manager.Deallocate(edep_squared, number_of_dosels*edep_type_size, j, "GGEMSDosimetryCalculator");
+        opencl_manager.Deallocate(hit, number_of_dosels*sizeof(GGint), j, "GGEMSDosimetryCalculator");
+      }
+    }
+
+    opencl_manager.Deallocate(dose_params, sizeof(GGEMSDoseParams), j, "GGEMSDosimetryCalculator");
+  }
+
+  for (GGint mode = 0; mode < 2; ++mode) {
+    delete[] kernel_benchmark[mode];
+    delete[] kernel_reduce[mode];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSDosimetryCalculator::SaveResults(void) const
 {
   SaveDose();
@@ -519,17 +895,13 @@ void GGEMSDosimetryCalculator::SavePhotonTracking(void) const
   // Release the pointer
   opencl_manager.ReleaseDeviceBuffer(dose_params_[0], dose_params_device, 0);
 
-  // Loop over all activated device
-  for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGint* photon_tracking_device = opencl_manager.GetDeviceBuffer<GGint>(dose_recording_.photon_tracking_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGint), j);
-
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) photon_tracking[i] += photon_tracking_device[i];
-    opencl_manager.ReleaseDeviceBuffer(dose_recording_.photon_tracking_[j], photon_tracking_device, j);
-  }
+  // Photon tracking of all devices merged on first device
+  GGint* photon_tracking_device = opencl_manager.GetDeviceBuffer<GGint>(dose_recording_.photon_tracking_[0], CL_TRUE, CL_MAP_READ, total_number_of_dosels*sizeof(GGint), 0);
+  std::memcpy(photon_tracking, photon_tracking_device, total_number_of_dosels*sizeof(GGint));
+  opencl_manager.ReleaseDeviceBuffer(dose_recording_.photon_tracking_[0], photon_tracking_device, 0);
 
   // Writing data
-  mhdImage.Write<GGint>(photon_tracking);
-  delete[] photon_tracking;
+  mhdImage.WriteAsync<GGint>(photon_tracking);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -562,18 +934,13 @@ void GGEMSDosimetryCalculator::SaveHit(void) const
   // Release the pointer
   opencl_manager.ReleaseDeviceBuffer(dose_params_[0], dose_params_device, 0);
 
-  // Loop over all activated device
-  for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGint* hit_device = opencl_manager.GetDeviceBuffer<GGint>(dose_recording_.hit_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGint), j);
-
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) hit_tracking[i] = hit_device[i];
-
-    opencl_manager.ReleaseDeviceBuffer(dose_recording_.hit_[j], hit_device, j);
-  }
+  // Hits of all devices merged on first device
+  GGint* hit_device = opencl_manager.GetDeviceBuffer<GGint>(dose_recording_.hit_[0], CL_TRUE, CL_MAP_READ, total_number_of_dosels*sizeof(GGint), 0);
+  std::memcpy(hit_tracking, hit_device, total_number_of_dosels*sizeof(GGint));
+  opencl_manager.ReleaseDeviceBuffer(dose_recording_.hit_[0], hit_device, 0);
 
   // Writing data
-  mhdImage.Write<GGint>(hit_tracking);
-  delete[] hit_tracking;
+  mhdImage.WriteAsync<GGint>(hit_tracking);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -607,18 +974,21 @@ void GGEMSDosimetryCalculator::SaveEdep(void) const
   // Release the pointer
   opencl_manager.ReleaseDeviceBuffer(dose_params_[0], dose_params_device, 0);
 
-  // Loop over all activated device
-  for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGDosiType* edep_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGDosiType), j);
-
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_tracking[i] = edep_device[i];
-
-    opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_[j], edep_device, j);
+  // Energy deposits of all devices merged on first device
+  if (is_fixed_point_) {
+    // Numbers of quanta converted to energy
+    GGulong* edep_device = opencl_manager.GetDeviceBuffer<GGulong>(dose_recording_.edep_[0], CL_TRUE, CL_MAP_READ, total_number_of_dosels*sizeof(GGulong), 0);
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_tracking[i] = static_cast<GGDosiType>(edep_device[i]) * static_cast<GGDosiType>(edep_quantum_);
+    opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_[0], edep_device, 0);
+  }
+  else {
+    GGDosiType* edep_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_[0], CL_TRUE, CL_MAP_READ, total_number_of_dosels*sizeof(GGDosiType), 0);
+    std::memcpy(edep_tracking, edep_device, total_number_of_dosels*sizeof(GGDosiType));
+    opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_[0], edep_device, 0);
   }
 
   // Writing data
-  mhdImage.Write<GGDosiType>(edep_tracking);
-  delete[] edep_tracking;
+  mhdImage.WriteAsync<GGDosiType>(edep_tracking);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -652,18 +1022,21 @@ void GGEMSDosimetryCalculator::SaveEdepSquared(void) const
   // Release the pointer
   opencl_manager.ReleaseDeviceBuffer(dose_params_[0], dose_params_device, 0);
 
-  // Loop over all activated device
-  for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGDosiType* edep_squared_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_squared_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGDosiType), j);
-
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_squared_tracking[i] = edep_squared_device[i];
-
-    opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_squared_[j], edep_squared_device, j);
+  // Energy deposits squared of all devices merged on first device
+  if (is_fixed_point_) {
+    // Numbers of quanta converted to energy squared
+    GGulong* edep_squared_device = opencl_manager.GetDeviceBuffer<GGulong>(dose_recording_.edep_squared_[0], CL_TRUE, CL_MAP_READ, total_number_of_dosels*sizeof(GGulong), 0);
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_squared_tracking[i] = static_cast<GGDosiType>(edep_squared_device[i]) * static_cast<GGDosiType>(edep_quantum_)*static_cast<GGDosiType>(edep_quantum_);
+    opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_squared_[0], edep_squared_device, 0);
+  }
+  else {
+    GGDosiType* edep_squared_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_squared_[0], CL_TRUE, CL_MAP_READ, total_number_of_dosels*sizeof(GGDosiType), 0);
+    std::memcpy(edep_squared_tracking, edep_squared_device, total_number_of_dosels*sizeof(GGDosiType));
+    opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_squared_[0], edep_squared_device, 0);
   }
 
   // Writing data
-  mhdImage.Write<GGDosiType>(edep_squared_tracking);
-  delete[] edep_squared_tracking;
+  mhdImage.WriteAsync<GGDosiType>(edep_squared_tracking);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -696,18 +1069,13 @@ void GGEMSDosimetryCalculator::SaveDose(void) const
   // Release the pointer
   opencl_manager.ReleaseDeviceBuffer(dose_params_[0], dose_params_device, 0);
 
-  // Loop over all activated device
-  for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGfloat* dose_device = opencl_manager.GetDeviceBuffer<GGfloat>(dose_recording_.dose_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGfloat), j);
-
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) dose[i] += dose_device[i];
-
-    opencl_manager.ReleaseDeviceBuffer(dose_recording_.dose_[j], dose_device, j);
-  }
+  // Dose computed once on first device from merged energy deposits
+  GGfloat* dose_device = opencl_manager.GetDeviceBuffer<GGfloat>(dose_recording_.dose_[0], CL_TRUE, CL_MAP_READ, total_number_of_dosels*sizeof(GGfloat), 0);
+  std::memcpy(dose, dose_device, total_number_of_dosels*sizeof(GGfloat));
+  opencl_manager.ReleaseDeviceBuffer(dose_recording_.dose_[0], dose_device, 0);
 
   // Writing data
-  mhdImage.Write<GGfloat>(dose);
-  delete[] dose;
+  mhdImage.WriteAsync<GGfloat>(dose);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -740,18 +1108,13 @@ void GGEMSDosimetryCalculator::SaveUncertainty(void) const
   // Release the pointer
   opencl_manager.ReleaseDeviceBuffer(dose_params_[0], dose_params_device, 0);
 
-  // Loop over all activated device
-  for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGfloat* uncertainty_device = opencl_manager.GetDeviceBuffer<GGfloat>(dose_recording_.uncertainty_dose_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGfloat), j);
-
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) uncertainty[i] = uncertainty_device[i];
-
-    opencl_manager.ReleaseDeviceBuffer(dose_recording_.uncertainty_dose_[j], uncertainty_device, j);
-  }
+  // Uncertainty computed once on first device from merged energy deposits
+  GGfloat* uncertainty_device = opencl_manager.GetDeviceBuffer<GGfloat>(dose_recording_.uncertainty_dose_[0], CL_TRUE, CL_MAP_READ, total_number_of_dosels*sizeof(GGfloat), 0);
+  std::memcpy(uncertainty, uncertainty_device, total_number_of_dosels*sizeof(GGfloat));
+  opencl_manager.ReleaseDeviceBuffer(dose_recording_.uncertainty_dose_[0], uncertainty_device, 0);
 
   // Writing data
-  mhdImage.Write<GGfloat>(uncertainty);
-  delete[] uncertainty;
+  mhdImage.WriteAsync<GGfloat>(uncertainty);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -860,6 +1223,33 @@ void dose_tle_navigator(GGEMSDosimetryCalculator* dose_calculator, bool const is
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void scoring_backend_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, char const* scoring_backend, GGsize const number_of_replicas)
+{
+  dose_calculator->SetScoringBackend(scoring_backend, number_of_replicas);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void fixed_point_scoring_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated, GGfloat const quantum, char const* unit)
+{
+  dose_calculator->SetFixedPointScoring(is_activated, quantum, unit);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void benchmark_scoring_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGsize const number_of_deposits)
+{
+  dose_calculator->BenchmarkScoring(number_of_deposits);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void water_reference_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated)
 {
   dose_calculator->SetWaterReference(is_activated);
@@ -29,6 +29,8 @@
 */
 
 #include "GGEMS/geometries/GGEMSVoxelizedSolid.hh"
+#include "GGEMS/geometries/GGEMSSolidBox.hh"
+#include "GGEMS/geometries/GGEMSSolidBoxData.hh"
 #include "GGEMS/physics/GGEMSCrossSections.hh"
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 #include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
@@ -86,6 +88,16 @@ GGEMSNavigator::GGEMSNavigator(std::string const& navigator_name)
   custom_material_rgb_.clear();
   material_visible_.clear();
 
+  // Multi-solid navigation, buffers allocated only if navigator is compatible
+  is_multi_solid_ = true;
+  multi_solid_data_ = nullptr;
+  multi_solid_histogram_ = nullptr;
+  multi_solid_scatter_histogram_ = nullptr;
+  multi_solid_histogram_stride_ = 0;
+  is_multi_solid_local_histogram_ = false;
+  kernel_multi_solid_project_to_solid_ = nullptr;
+  kernel_multi_solid_track_through_solid_ = nullptr;
+
   GGcout("GGEMSNavigator", "GGEMSNavigator", 3) << "GGEMSNavigator created!!!" << GGendl;
 }
 
@@ -123,6 +135,42 @@ GGEMSNavigator::~GGEMSNavigator(void)
     attenuations_ = nullptr;
   }
 
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  if (multi_solid_data_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(multi_solid_data_[i], number_of_solids_*sizeof(GGEMSSolidBoxData), i);
+    }
+    delete[] multi_solid_data_;
+    multi_solid_data_ = nullptr;
+  }
+
+  if (multi_solid_histogram_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(multi_solid_histogram_[i], number_of_solids_*multi_solid_histogram_stride_*sizeof(GGint), i);
+    }
+    delete[] multi_solid_histogram_;
+    multi_solid_histogram_ = nullptr;
+  }
+
+  if (multi_solid_scatter_histogram_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      if (multi_solid_scatter_histogram_[i]) opencl_manager.Deallocate(multi_solid_scatter_histogram_[i], number_of_solids_*multi_solid_histogram_stride_*sizeof(GGint), i);
+    }
+    delete[] multi_solid_scatter_histogram_;
+    multi_solid_scatter_histogram_ = nullptr;
+  }
+
+  if (kernel_multi_solid_project_to_solid_) {
+    delete[] kernel_multi_solid_project_to_solid_;
+    kernel_multi_solid_project_to_solid_ = nullptr;
+  }
+
+  if (kernel_multi_solid_track_through_solid_) {
+    delete[] kernel_multi_solid_track_through_solid_;
+    kernel_multi_solid_track_through_solid_ = nullptr;
+  }
+
   GGcout("GGEMSNavigator", "~GGEMSNavigator", 3) << "GGEMSNavigator erased!!!" << GGendl;
 }
 
@@ -255,6 +303,15 @@ void GGEMSNavigator::SetMaterialVisible(std::string const& material_name, bool c
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSNavigator::SetMultiSolidNavigation(bool const& is_multi_solid)
+{
+  is_multi_solid_ = is_multi_solid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSNavigator::CheckParameters(void) const
 {
   GGcout("GGEMSNavigator", "CheckParameters", 3) << "Checking the mandatory parameters..." << GGendl;
@@ -293,6 +350,125 @@ void GGEMSNavigator::Initialize(void)
 
   // Initialization of attenuations
   attenuations_->Initialize();
+
+  // Packing solid boxes to navigate them with a single kernel launch
+  if (is_multi_solid_ && IsMultiSolidCompatible()) InitializeMultiSolid();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSNavigator::IsMultiSolidCompatible(void) const
+{
+  // A single solid does not need batching
+  if (number_of_solids_ < 2) return false;
+
+  for (GGsize i = 0; i < number_of_solids_; ++i) {
+    // Only solid boxes storing histogram
+    if (!dynamic_cast<GGEMSSolidBox*>(solids_[i])) return false;
+    if (solids_[i]->GetRegisteredDataType() != "HISTOGRAM") return false;
+
+    // Same histogram size and same kernel options for all solids
+    if (solids_[i]->GetNumberOfHistogramElements() != solids_[0]->GetNumberOfHistogramElements()) return false;
+    if (solids_[i]->GetKernelOption() != solids_[0]->GetKernelOption()) return false;
+
+    // Solid ids must be consecutive, the kernel uses solid id to find data in packed buffer
+    for (GGsize j = 0; j < number_activated_devices_; ++j) {
+      if (solids_[i]->GetSolidID(j) != solids_[0]->GetSolidID(j) + static_cast<GGint>(i)) return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigator::InitializeMultiSolid(void)
+{
+  GGcout("GGEMSNavigator", "InitializeMultiSolid", 3) << "Initializing multi-solid navigation..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  multi_solid_histogram_stride_ = solids_[0]->GetNumberOfHistogramElements();
+  GGsize solid_data_size = number_of_solids_*sizeof(GGEMSSolidBoxData);
+  GGsize histogram_size = number_of_solids_*multi_solid_histogram_stride_*sizeof(GGint);
+
+  multi_solid_data_ = new cl::Buffer*[number_activated_devices_];
+  multi_solid_histogram_ = new cl::Buffer*[number_activated_devices_];
+  multi_solid_scatter_histogram_ = new cl::Buffer*[number_activated_devices_];
+
+  // Loop over number of device
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(d);
+
+    multi_solid_data_[d] = opencl_manager.Allocate(nullptr, solid_data_size, d, CL_MEM_READ_WRITE, "GGEMSNavigator");
+    multi_solid_histogram_[d] = opencl_manager.Allocate(nullptr, histogram_size, d, CL_MEM_READ_WRITE, "GGEMSNavigator");
+    opencl_manager.CleanBuffer(multi_solid_histogram_[d], histogram_size, d);
+
+    multi_solid_scatter_histogram_[d] = nullptr;
+    if (solids_[0]->GetScatterHistogram(d)) {
+      multi_solid_scatter_histogram_[d] = opencl_manager.Allocate(nullptr, histogram_size, d, CL_MEM_READ_WRITE, "GGEMSNavigator");
+      opencl_manager.CleanBuffer(multi_solid_scatter_histogram_[d], histogram_size, d);
+    }
+
+    // Copying data of each solid in packed buffer, solid data are already on device
+    for (GGsize i = 0; i < number_of_solids_; ++i) {
+      GGint copy_status = queue->enqueueCopyBuffer(*solids_[i]->GetSolidData(d), *multi_solid_data_[d], 0, i*sizeof(GGEMSSolidBoxData), sizeof(GGEMSSolidBoxData));
+      opencl_manager.CheckOpenCLError(copy_status, "GGEMSNavigator", "InitializeMultiSolid");
+    }
+    queue->finish();
+  }
+
+  // Compiling kernels with options of solids
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string project_to_filename = openCL_kernel_path + "/ProjectToGGEMSMultiSolidBox.cl";
+  std::string track_through_filename = openCL_kernel_path + "/TrackThroughGGEMSMultiSolidBox.cl";
+  std::string kernel_option = solids_[0]->GetKernelOption();
+
+  // Packed histograms counted in local memory if they fit in local memory
+  GGsize local_histogram_size = multi_solid_scatter_histogram_[0] ? 2*histogram_size : histogram_size;
+  is_multi_solid_local_histogram_ = opencl_manager.IsLocalMemoryFitting(local_histogram_size);
+  std::string track_through_option = kernel_option + (is_multi_solid_local_histogram_ ? " -DLOCAL_HISTOGRAM" : "");
+
+  kernel_multi_solid_project_to_solid_ = new cl::Kernel*[number_activated_devices_];
+  kernel_multi_solid_track_through_solid_ = new cl::Kernel*[number_activated_devices_];
+
+  opencl_manager.CompileKernel(project_to_filename, "project_to_ggems_multi_solid_box", kernel_multi_solid_project_to_solid_, nullptr, const_cast<char*>(kernel_option.c_str()));
+  opencl_manager.CompileKernel(track_through_filename, "track_through_ggems_multi_solid_box", kernel_multi_solid_track_through_solid_, nullptr, const_cast<char*>(track_through_option.c_str()));
+
+  GGcout("GGEMSNavigator", "InitializeMultiSolid", 2) << "Navigator " << navigator_name_ << ": " << number_of_solids_ << " solids navigated with a single kernel launch" << GGendl;
+  GGcout("GGEMSNavigator", "InitializeMultiSolid", 2) << "Navigator " << navigator_name_ << ": histograms counted in " << (is_multi_solid_local_histogram_ ? "local memory by work-group" : "global memory") << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigator::UnpackMultiSolidHistograms(void)
+{
+  if (!multi_solid_histogram_) return;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  GGsize histogram_size = multi_solid_histogram_stride_*sizeof(GGint);
+
+  // Loop over number of device
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(d);
+
+    for (GGsize i = 0; i < number_of_solids_; ++i) {
+      GGint copy_status = queue->enqueueCopyBuffer(*multi_solid_histogram_[d], *solids_[i]->GetHistogram(d), i*histogram_size, 0, histogram_size);
+      opencl_manager.CheckOpenCLError(copy_status, "GGEMSNavigator", "UnpackMultiSolidHistograms");
+
+      if (multi_solid_scatter_histogram_[d]) {
+        copy_status = queue->enqueueCopyBuffer(*multi_solid_scatter_histogram_[d], *solids_[i]->GetScatterHistogram(d), i*histogram_size, 0, histogram_size);
+        opencl_manager.CheckOpenCLError(copy_status, "GGEMSNavigator", "UnpackMultiSolidHistograms");
+      }
+    }
+    queue->finish();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -323,7 +499,7 @@ void GGEMSNavigator::ParticleSolidDistance(GGsize const& thread_index)
   // Pointer to primary particles, and number to particles in buffer
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
@@ -346,9 +522,9 @@ void GGEMSNavigator::ParticleSolidDistance(GGsize const& thread_index)
 
     // Launching kernel
     cl::Event event;
-    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
+    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &event);
     opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "ParticleSolidDistance");
-    queue->finish();
+    opencl_manager.ChainTransportEvent(thread_index, event);
 
     // GGEMS Profiling
     GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
@@ -374,7 +550,10 @@ void GGEMSNavigator::ProjectToSolid(GGsize const& thread_index)
   // Pointer to primary particles, and number to particles in buffer
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
+
+  // Trajectories of displayed particles, only with OpenGL
+  cl::Buffer* trajectories = source_manager.GetParticles()->GetTrajectories(thread_index);
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
@@ -384,6 +563,27 @@ void GGEMSNavigator::ProjectToSolid(GGsize const& thread_index)
   cl::NDRange global_wi(number_of_work_items);
   cl::NDRange local_wi(work_group_size);
 
+  // All the solids in a single launch
+  if (multi_solid_data_) {
+    cl::Kernel* kernel = kernel_multi_solid_project_to_solid_[thread_index];
+    kernel->setArg(0, number_of_particles);
+    kernel->setArg(1, *primary_particles);
+    kernel->setArg(2, *multi_solid_data_[thread_index]);
+    kernel->setArg(3, static_cast<GGint>(number_of_solids_));
+    if (trajectories) kernel->setArg(4, *trajectories);
+
+    // Launching kernel
+    cl::Event event;
+    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &event);
+    opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "ProjectToSolid");
+    opencl_manager.ChainTransportEvent(thread_index, event);
+
+    // GGEMS Profiling
+    GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
+    GGEMSProfilerManager::GetInstance().AddSavedKernelLaunches(oss.str(), number_of_solids_-1);
+    return;
+  }
+
   // Loop over all the solids
   for (GGsize i = 0; i < number_of_solids_; ++i) {
     // Getting solid data infos
@@ -394,12 +594,13 @@ void GGEMSNavigator::ProjectToSolid(GGsize const& thread_index)
     kernel->setArg(0, number_of_particles);
     kernel->setArg(1, *primary_particles);
     kernel->setArg(2, *solid_data);
+    if (trajectories) kernel->setArg(3, *trajectories);
 
     // Launching kernel
     cl::Event event;
-    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
+    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &event);
     opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "ProjectToSolid");
-    queue->finish();
+    opencl_manager.ChainTransportEvent(thread_index, event);
 
     // GGEMS Profiling
     GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
@@ -425,7 +626,10 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
   // Pointer to primary particles, and number to particles in buffer
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
+
+  // Trajectories of displayed particles, only with OpenGL
+  cl::Buffer* trajectories = source_manager.GetParticles()->GetTrajectories(thread_index);
 
   // Getting OpenCL pointer to random number
   cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index);
@@ -447,6 +651,41 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
   cl::NDRange global_wi(number_of_work_items);
   cl::NDRange local_wi(work_group_size);
 
+  // All the solids in a single launch, only solid boxes storing histogram
+  if (multi_solid_data_) {
+    cl::Kernel* kernel = kernel_multi_solid_track_through_solid_[thread_index];
+    kernel->setArg(0, number_of_particles);
+    kernel->setArg(1, *primary_particles);
+    kernel->setArg(2, *randoms);
+    kernel->setArg(3, *multi_solid_data_[thread_index]);
+    kernel->setArg(4, static_cast<GGint>(number_of_solids_));
+    kernel->setArg(5, *cross_sections);
+    kernel->setArg(6, *materials);
+    kernel->setArg(7, threshold_);
+    kernel->setArg(8, *multi_solid_histogram_[thread_index]);
+    if (!multi_solid_scatter_histogram_[thread_index]) kernel->setArg(9, sizeof(cl_mem), nullptr);
+    else kernel->setArg(9, *multi_solid_scatter_histogram_[thread_index]);
+    kernel->setArg(10, multi_solid_histogram_stride_);
+    if (is_multi_solid_local_histogram_) {
+      // Local copies of packed histograms, scatter copy is not used without scatter histogram
+      GGsize local_histogram_size = number_of_solids_*multi_solid_histogram_stride_*sizeof(GGint);
+      kernel->setArg(11, cl::Local(local_histogram_size));
+      kernel->setArg(12, cl::Local(multi_solid_scatter_histogram_[thread_index] ? local_histogram_size : sizeof(GGint)));
+    }
+    if (trajectories) kernel->setArg(kernel->getInfo<CL_KERNEL_NUM_ARGS>()-1, *trajectories);
+
+    // Launching kernel
+    cl::Event event;
+    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &event);
+    opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "TrackThroughSolid");
+    opencl_manager.ChainTransportEvent(thread_index, event);
+
+    // GGEMS Profiling
+    GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
+    GGEMSProfilerManager::GetInstance().AddSavedKernelLaunches(oss.str(), number_of_solids_-1);
+    return;
+  }
+
   // Loop over all the solids
   for (GGsize i = 0; i < number_of_solids_; ++i) {
     // Getting solid  and label (for GGEMSVoxelizedSolid) data infos
@@ -495,6 +734,12 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
       kernel->setArg(9, *histogram);
       if (!scatter_histogram) kernel->setArg(10, sizeof(cl_mem), nullptr);
       else kernel->setArg(10, *scatter_histogram);
+      if (solids_[i]->IsLocalHistogram()) {
+        // Local copies of histogram, scatter copy is not used without scatter histogram
+        GGsize local_histogram_size = solids_[i]->GetNumberOfHistogramElements()*sizeof(GGint);
+        kernel->setArg(11, cl::Local(local_histogram_size));
+        kernel->setArg(12, cl::Local(scatter_histogram ? local_histogram_size : sizeof(GGint)));
+      }
     }
     else if (data_reg_type == "DOSIMETRY") {
       kernel->setArg(9, *dosimetry_params);
@@ -509,14 +754,17 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
       else kernel->setArg(13, *photon_tracking_dosimetry);
     }
 
+    // Trajectories are the last argument, after registered data depending on mode of simulation
+    if (trajectories) kernel->setArg(kernel->getInfo<CL_KERNEL_NUM_ARGS>()-1, *trajectories);
+
     // Launching kernel
     cl::Event event;
-    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
+    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &event);
     opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "TrackThroughSolid");
+    opencl_manager.ChainTransportEvent(thread_index, event);
 
     // GGEMS Profiling
     GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
-    queue->finish();
   }
 }
 
@@ -524,9 +772,9 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSNavigator::ComputeDose(GGsize const& thread_index)
+void GGEMSNavigator::ComputeDose(void)
 {
-  if (is_dosimetry_mode_) dose_calculator_->ComputeDose(thread_index);
+  if (is_dosimetry_mode_) dose_calculator_->ComputeDose();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
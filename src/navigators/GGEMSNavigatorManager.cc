@@ -28,9 +28,134 @@
   \date Tuesday February 11, 2020
 */
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "GGEMS/physics/GGEMSRangeCutsManager.hh"
 #include "GGEMS/geometries/GGEMSSolid.hh"
 #include "GGEMS/sources/GGEMSSourceManager.hh"
+#include "GGEMS/geometries/GGEMSBVHData.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
+#include "GGEMS/tools/GGEMSChrono.hh"
+
+/*!
+  \brief empty namespace storing BVH building functions
+*/
+namespace {
+  GGfloat const BVH_MARGIN = 1.0f*mm; /*!< Margin added to AABB of solids, covering tolerance of ray tracing on device */
+
+  /*!
+    \fn GGint BuildBVHNode(std::vector<GGEMSBVHNode>& nodes, std::vector<GGint>& solid_indices, std::vector<GGEMSBVHNode> const& solid_aabbs, GGsize const& begin, GGsize const& end, GGsize const& depth, GGsize& max_depth)
+    \param nodes - nodes of BVH
+    \param solid_indices - indices of solids sorted during building
+    \param solid_aabbs - AABB of each solid in global frame
+    \param begin - first solid of node in solid_indices
+    \param end - last solid (excluded) of node in solid_indices
+    \param depth - depth of node
+    \param max_depth - maximum depth of BVH
+    \return index of node
+    \brief build recursively a BVH node splitting solids at median along the largest axis of centroids
+  */
+  GGint BuildBVHNode(std::vector<GGEMSBVHNode>& nodes, std::vector<GGint>& solid_indices, std::vector<GGEMSBVHNode> const& solid_aabbs, GGsize const& begin, GGsize const& end, GGsize const& depth, GGsize& max_depth)
+  {
+    if (depth > max_depth) max_depth = depth;
+
+    GGint node_index = static_cast<GGint>(nodes.size());
+    nodes.push_back(GGEMSBVHNode());
+
+    // AABB of node, and bounds of solid centers
+    GGEMSBVHNode node;
+    GGfloat center_min[3] = {std::numeric_limits<GGfloat>::max(), std::numeric_limits<GGfloat>::max(), std::numeric_limits<GGfloat>::max()};
+    GGfloat center_max[3] = {std::numeric_limits<GGfloat>::lowest(), std::numeric_limits<GGfloat>::lowest(), std::numeric_limits<GGfloat>::lowest()};
+    for (GGsize j = 0; j < 3; ++j) {
+      node.border_min_xyz_.s[j] = std::numeric_limits<GGfloat>::max();
+      node.border_max_xyz_.s[j] = std::numeric_limits<GGfloat>::lowest();
+    }
+
+    for (GGsize i = begin; i < end; ++i) {
+      GGEMSBVHNode const& aabb = solid_aabbs[static_cast<GGsize>(solid_indices[i])];
+      for (GGsize j = 0; j < 3; ++j) {
+        node.border_min_xyz_.s[j] = std::min(node.border_min_xyz_.s[j], aabb.border_min_xyz_.s[j]);
+        node.border_max_xyz_.s[j] = std::max(node.border_max_xyz_.s[j], aabb.border_max_xyz_.s[j]);
+        GGfloat center = 0.5f*(aabb.border_min_xyz_.s[j] + aabb.border_max_xyz_.s[j]);
+        center_min[j] = std::min(center_min[j], center);
+        center_max[j] = std::max(center_max[j], center);
+      }
+    }
+
+    // Leaf storing one solid
+    if (end - begin == 1) {
+      node.left_child_ = -1;
+      node.right_child_ = -1;
+      node.solid_index_ = solid_indices[begin];
+      nodes[static_cast<GGsize>(node_index)] = node;
+      return node_index;
+    }
+
+    // Splitting at median along largest axis
+    GGsize axis = 0;
+    for (GGsize j = 1; j < 3; ++j) {
+      if (center_max[j] - center_min[j] > center_max[axis] - center_min[axis]) axis = j;
+    }
+
+    GGsize middle = begin + (end - begin) / 2;
+    std::nth_element(
+      solid_indices.begin() + static_cast<std::ptrdiff_t>(begin),
+      solid_indices.begin() + static_cast<std::ptrdiff_t>(middle),
+      solid_indices.begin() + static_cast<std::ptrdiff_t>(end),
+      [&solid_aabbs, axis](GGint const& a, GGint const& b) {
+        GGEMSBVHNode const& aabb_a = solid_aabbs[static_cast<GGsize>(a)];
+        GGEMSBVHNode const& aabb_b = solid_aabbs[static_cast<GGsize>(b)];
+        GGfloat center_a = aabb_a.border_min_xyz_.s[axis] + aabb_a.border_max_xyz_.s[axis];
+        GGfloat center_b = aabb_b.border_min_xyz_.s[axis] + aabb_b.border_max_xyz_.s[axis];
+        return center_a < center_b || (center_a == center_b && a < b);
+      }
+    );
+
+    node.solid_index_ = -1;
+    node.left_child_ = BuildBVHNode(nodes, solid_indices, solid_aabbs, begin, middle, depth+1, max_depth);
+    node.right_child_ = BuildBVHNode(nodes, solid_indices, solid_aabbs, middle, end, depth+1, max_depth);
+    nodes[static_cast<GGsize>(node_index)] = node;
+
+    return node_index;
+  }
+
+  /*!
+    \fn void BuildBVH(GGEMSBVHSolid const* solids, GGsize const& number_of_solids, std::vector<GGEMSBVHNode>& nodes, GGsize& depth)
+    \param solids - solids in navigator order
+    \param number_of_solids - number of solids
+    \param nodes - nodes of BVH, root is the first node
+    \param depth - depth of BVH
+    \brief build BVH over AABB of OBB of solids in global frame
+  */
+  void BuildBVH(GGEMSBVHSolid const* solids, GGsize const& number_of_solids, std::vector<GGEMSBVHNode>& nodes, GGsize& depth)
+  {
+    std::vector<GGEMSBVHNode> solid_aabbs(number_of_solids);
+    for (GGsize i = 0; i < number_of_solids; ++i) {
+      // AABB of OBB in global frame, global = R * local + T
+      GGEMSOBB const& obb = solids[i].obb_geometry_;
+      GGfloat const* rows[3] = {obb.matrix_transformation_.m0_, obb.matrix_transformation_.m1_, obb.matrix_transformation_.m2_};
+      for (GGsize k = 0; k < 3; ++k) {
+        GGfloat center = rows[k][3];
+        GGfloat half_size = BVH_MARGIN;
+        for (GGsize l = 0; l < 3; ++l) {
+          center += rows[k][l] * 0.5f * (obb.border_min_xyz_.s[l] + obb.border_max_xyz_.s[l]);
+          half_size += std::fabs(rows[k][l]) * 0.5f * (obb.border_max_xyz_.s[l] - obb.border_min_xyz_.s[l]);
+        }
+        solid_aabbs[i].border_min_xyz_.s[k] = center - half_size;
+        solid_aabbs[i].border_max_xyz_.s[k] = center + half_size;
+      }
+    }
+
+    nodes.clear();
+    nodes.reserve(2*number_of_solids-1);
+    std::vector<GGint> solid_indices(number_of_solids);
+    for (GGsize i = 0; i < number_of_solids; ++i) solid_indices[i] = static_cast<GGint>(i);
+    depth = 0;
+    BuildBVHNode(nodes, solid_indices, solid_aabbs, 0, number_of_solids, 1, depth);
+  }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,10 +164,19 @@
 GGEMSNavigatorManager::GGEMSNavigatorManager(void)
 : navigators_(nullptr),
   number_of_navigators_(0),
-  world_(nullptr)
+  world_(nullptr),
+  bvh_nodes_(nullptr),
+  bvh_solids_(nullptr),
+  number_of_bvh_nodes_(0),
+  number_of_bvh_solids_(0),
+  bvh_depth_(0),
+  kernel_particle_solid_distance_bvh_(nullptr)
 {
   GGcout("GGEMSNavigatorManager", "GGEMSNavigatorManager", 3) << "GGEMSNavigatorManager creating..." << GGendl;
 
+  // Get the number of activated device
+  number_activated_devices_ = GGEMSOpenCLManager::GetInstance().GetNumberOfActivatedDevice();
+
   GGcout("GGEMSNavigatorManager", "GGEMSNavigatorManager", 3) << "GGEMSNavigatorManager created!!!" << GGendl;
 }
 
@@ -59,6 +193,29 @@ GGEMSNavigatorManager::~GGEMSNavigatorManager(void)
     navigators_ = nullptr;
   }
 
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  if (bvh_nodes_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(bvh_nodes_[i], number_of_bvh_nodes_*sizeof(GGEMSBVHNode), i);
+    }
+    delete[] bvh_nodes_;
+    bvh_nodes_ = nullptr;
+  }
+
+  if (bvh_solids_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(bvh_solids_[i], number_of_bvh_solids_*sizeof(GGEMSBVHSolid), i);
+    }
+    delete[] bvh_solids_;
+    bvh_solids_ = nullptr;
+  }
+
+  if (kernel_particle_solid_distance_bvh_) {
+    delete[] kernel_particle_solid_distance_bvh_;
+    kernel_particle_solid_distance_bvh_ = nullptr;
+  }
+
   GGcout("GGEMSNavigatorManager", "~GGEMSNavigatorManager", 3) << "GGEMSNavigatorManager erased!!!" << GGendl;
 }
 
@@ -120,6 +277,7 @@ void GGEMSNavigatorManager::StoreWorld(GGEMSWorld* world)
 void GGEMSNavigatorManager::SaveResults(void) const
 {
   for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    navigators_[i]->UnpackMultiSolidHistograms();
     navigators_[i]->SaveResults();
   }
 
@@ -131,7 +289,7 @@ void GGEMSNavigatorManager::SaveResults(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSNavigatorManager::Initialize(bool const& is_tracking) const
+void GGEMSNavigatorManager::Initialize(bool const& is_tracking)
 {
   GGcout("GGEMSNavigatorManager", "Initialize", 3) << "Initializing the GGEMS navigator(s)..." << GGendl;
 
@@ -152,6 +310,209 @@ void GGEMSNavigatorManager::Initialize(bool const& is_tracking) const
     if (is_tracking) navigators_[i]->EnableTracking();
     navigators_[i]->Initialize();
   }
+
+  // BVH replacing particle - solid distance kernels of each navigator
+  if (GetNumberOfRegisteredSolids() > 1) InitializeBVH();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigatorManager::InitializeBVH(void)
+{
+  GGcout("GGEMSNavigatorManager", "InitializeBVH", 3) << "Building BVH over solids..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Solids in navigator order, the order used to select a solid when distances are equal
+  number_of_bvh_solids_ = GetNumberOfRegisteredSolids();
+  GGEMSBVHSolid* solids = new GGEMSBVHSolid[number_of_bvh_solids_];
+
+  GGsize solid_index = 0;
+  for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    for (GGsize j = 0; j < navigators_[i]->GetNumberOfSolids(); ++j) {
+      // Geometry is the same on each device
+      solids[solid_index].obb_geometry_ = navigators_[i]->GetSolids(j)->GetOBBGeometry(0);
+      solids[solid_index].solid_id_ = navigators_[i]->GetSolids(j)->GetSolidID(0);
+      ++solid_index;
+    }
+  }
+
+  // Building BVH on host
+  std::vector<GGEMSBVHNode> nodes;
+  BuildBVH(solids, number_of_bvh_solids_, nodes, bvh_depth_);
+  number_of_bvh_nodes_ = nodes.size();
+
+  if (bvh_depth_ >= BVH_STACK_SIZE) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "BVH depth (" << bvh_depth_ << ") is greater than stack size on OpenCL device (" << BVH_STACK_SIZE << ")!!!";
+    GGEMSMisc::ThrowException("GGEMSNavigatorManager", "InitializeBVH", oss.str());
+  }
+
+  // Copying BVH on each device
+  bvh_nodes_ = new cl::Buffer*[number_activated_devices_];
+  bvh_solids_ = new cl::Buffer*[number_activated_devices_];
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    bvh_nodes_[d] = opencl_manager.Allocate(nullptr, number_of_bvh_nodes_*sizeof(GGEMSBVHNode), d, CL_MEM_READ_ONLY, "GGEMSNavigatorManager");
+    GGEMSBVHNode* nodes_device = opencl_manager.GetDeviceBuffer<GGEMSBVHNode>(bvh_nodes_[d], CL_TRUE, CL_MAP_WRITE, number_of_bvh_nodes_*sizeof(GGEMSBVHNode), d);
+    for (GGsize i = 0; i < number_of_bvh_nodes_; ++i) nodes_device[i] = nodes[i];
+    opencl_manager.ReleaseDeviceBuffer(bvh_nodes_[d], nodes_device, d);
+
+    bvh_solids_[d] = opencl_manager.Allocate(nullptr, number_of_bvh_solids_*sizeof(GGEMSBVHSolid), d, CL_MEM_READ_ONLY, "GGEMSNavigatorManager");
+    GGEMSBVHSolid* solids_device = opencl_manager.GetDeviceBuffer<GGEMSBVHSolid>(bvh_solids_[d], CL_TRUE, CL_MAP_WRITE, number_of_bvh_solids_*sizeof(GGEMSBVHSolid), d);
+    for (GGsize i = 0; i < number_of_bvh_solids_; ++i) solids_device[i] = solids[i];
+    opencl_manager.ReleaseDeviceBuffer(bvh_solids_[d], solids_device, d);
+  }
+
+  delete[] solids;
+
+  // Compiling kernel
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string particle_solid_distance_filename = openCL_kernel_path + "/ParticleSolidDistanceGGEMSBVH.cl";
+  kernel_particle_solid_distance_bvh_ = new cl::Kernel*[number_activated_devices_];
+  opencl_manager.CompileKernel(particle_solid_distance_filename, "particle_solid_distance_ggems_bvh", kernel_particle_solid_distance_bvh_, nullptr, nullptr);
+
+  GGcout("GGEMSNavigatorManager", "InitializeBVH", 1) << "BVH over " << number_of_bvh_solids_ << " solids: " << number_of_bvh_nodes_ << " nodes, depth " << bvh_depth_ << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigatorManager::BenchmarkFindSolid(GGsize const& number_of_rays) const
+{
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Compiling kernels on each device
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string filename = openCL_kernel_path + "/BenchmarkFindSolid.cl";
+  cl::Kernel** kernel_linear = new cl::Kernel*[number_activated_devices_];
+  cl::Kernel** kernel_bvh = new cl::Kernel*[number_activated_devices_];
+  opencl_manager.CompileKernel(filename, "benchmark_find_solid_linear", kernel_linear, nullptr, nullptr);
+  opencl_manager.CompileKernel(filename, "benchmark_find_solid_bvh", kernel_bvh, nullptr, nullptr);
+
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  cl::NDRange global_wi(opencl_manager.GetBestWorkItem(number_of_rays));
+  cl::NDRange local_wi(work_group_size);
+
+  GGfloat ring_radius = 500.0f*mm;
+  std::string method_names[3] = {"one launch per module (linear FindSolid)", "one launch testing all modules", "BVH"};
+
+  for (GGsize number_of_solids = 1; number_of_solids <= 512; number_of_solids *= 2) {
+    // CT modules on a ring around Z axis, module thickness along radius
+    GGEMSBVHSolid* solids = new GGEMSBVHSolid[number_of_solids];
+    GGfloat module_width = std::min(0.9f * TWO_PI * ring_radius / static_cast<GGfloat>(number_of_solids), ring_radius);
+    for (GGsize i = 0; i < number_of_solids; ++i) {
+      GGfloat angle = TWO_PI * static_cast<GGfloat>(i) / static_cast<GGfloat>(number_of_solids);
+      GGfloat cos_angle = std::cos(angle);
+      GGfloat sin_angle = std::sin(angle);
+      GGEMSOBB& obb = solids[i].obb_geometry_;
+      obb.matrix_transformation_ = {
+        {cos_angle, -sin_angle, 0.0f, ring_radius * cos_angle},
+        {sin_angle, cos_angle, 0.0f, ring_radius * sin_angle},
+        {0.0f, 0.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f, 1.0f}
+      };
+      obb.border_min_xyz_.s[0] = -5.0f*mm;
+      obb.border_min_xyz_.s[1] = -0.5f*module_width;
+      obb.border_min_xyz_.s[2] = -50.0f*mm;
+      obb.border_max_xyz_.s[0] = 5.0f*mm;
+      obb.border_max_xyz_.s[1] = 0.5f*module_width;
+      obb.border_max_xyz_.s[2] = 50.0f*mm;
+      solids[i].solid_id_ = static_cast<GGint>(i);
+    }
+
+    std::vector<GGEMSBVHNode> nodes;
+    GGsize depth = 0;
+    BuildBVH(solids, number_of_solids, nodes, depth);
+
+    for (GGsize j = 0; j < number_activated_devices_; ++j) {
+      cl::CommandQueue* queue = opencl_manager.GetCommandQueue(j);
+      GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(j);
+
+      // Copying ring and its BVH on device
+      cl::Buffer* solids_buffer = opencl_manager.Allocate(nullptr, number_of_solids*sizeof(GGEMSBVHSolid), j, CL_MEM_READ_ONLY, "GGEMSNavigatorManager");
+      GGEMSBVHSolid* solids_device = opencl_manager.GetDeviceBuffer<GGEMSBVHSolid>(solids_buffer, CL_TRUE, CL_MAP_WRITE, number_of_solids*sizeof(GGEMSBVHSolid), j);
+      for (GGsize i = 0; i < number_of_solids; ++i) solids_device[i] = solids[i];
+      opencl_manager.ReleaseDeviceBuffer(solids_buffer, solids_device, j);
+
+      cl::Buffer* nodes_buffer = opencl_manager.Allocate(nullptr, nodes.size()*sizeof(GGEMSBVHNode), j, CL_MEM_READ_ONLY, "GGEMSNavigatorManager");
+      GGEMSBVHNode* nodes_device = opencl_manager.GetDeviceBuffer<GGEMSBVHNode>(nodes_buffer, CL_TRUE, CL_MAP_WRITE, nodes.size()*sizeof(GGEMSBVHNode), j);
+      for (GGsize i = 0; i < nodes.size(); ++i) nodes_device[i] = nodes[i];
+      opencl_manager.ReleaseDeviceBuffer(nodes_buffer, nodes_device, j);
+
+      cl::Buffer* closest_distance = opencl_manager.Allocate(nullptr, number_of_rays*sizeof(GGfloat), j, CL_MEM_READ_WRITE, "GGEMSNavigatorManager");
+      cl::Buffer* closest_solid_id = opencl_manager.Allocate(nullptr, number_of_rays*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSNavigatorManager");
+
+      std::vector<GGint> reference_solid_ids(number_of_rays);
+      for (GGint method = 0; method < 3; ++method) {
+        // First pass is not timed, warming up kernels and buffers
+        DurationNano elapsed_time = DurationNano::zero();
+        for (GGint pass = 0; pass < 2; ++pass) {
+          ChronoTime start_time = GGEMSChrono::Now();
+
+          GGint kernel_status = CL_SUCCESS;
+          if (method == 2) {
+            kernel_bvh[j]->setArg(0, number_of_rays);
+            kernel_bvh[j]->setArg(1, *nodes_buffer);
+            kernel_bvh[j]->setArg(2, *solids_buffer);
+            kernel_bvh[j]->setArg(3, *closest_distance);
+            kernel_bvh[j]->setArg(4, *closest_solid_id);
+            kernel_status = queue->enqueueNDRangeKernel(*kernel_bvh[j], 0, global_wi, local_wi);
+            opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigatorManager", "BenchmarkFindSolid");
+          }
+          else {
+            // One launch per module as each navigator did, or a single launch looping over modules
+            GGsize solids_per_launch = method == 0 ? 1 : number_of_solids;
+            for (GGsize first_solid = 0; first_solid < number_of_solids; first_solid += solids_per_launch) {
+              kernel_linear[j]->setArg(0, number_of_rays);
+              kernel_linear[j]->setArg(1, static_cast<GGint>(first_solid));
+              kernel_linear[j]->setArg(2, static_cast<GGint>(solids_per_launch));
+              kernel_linear[j]->setArg(3, *solids_buffer);
+              kernel_linear[j]->setArg(4, *closest_distance);
+              kernel_linear[j]->setArg(5, *closest_solid_id);
+              kernel_status = queue->enqueueNDRangeKernel(*kernel_linear[j], 0, global_wi, local_wi);
+              opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigatorManager", "BenchmarkFindSolid");
+            }
+          }
+          queue->finish();
+
+          elapsed_time = GGEMSChrono::Now() - start_time;
+        }
+
+        // Every method has to find the same solids as one launch per module
+        GGint* solid_ids_device = opencl_manager.GetDeviceBuffer<GGint>(closest_solid_id, CL_TRUE, CL_MAP_READ, number_of_rays*sizeof(GGint), j);
+        GGsize number_of_differences = 0;
+        for (GGsize i = 0; i < number_of_rays; ++i) {
+          if (method == 0) reference_solid_ids[i] = solid_ids_device[i];
+          else if (solid_ids_device[i] != reference_solid_ids[i]) ++number_of_differences;
+        }
+        opencl_manager.ReleaseDeviceBuffer(closest_solid_id, solid_ids_device, j);
+
+        GGdouble elapsed_seconds = static_cast<GGdouble>(elapsed_time.count()) * 1.0e-9;
+        GGcout("GGEMSNavigatorManager", "BenchmarkFindSolid", 0) << number_of_solids << " modules, " << method_names[method] << " on " << opencl_manager.GetDeviceName(device_index) << ": "
+          << static_cast<GGdouble>(number_of_rays) / elapsed_seconds << " rays/s (" << number_of_rays << " rays in " << elapsed_seconds * 1.0e3 << " ms)" << GGendl;
+
+        if (number_of_differences) {
+          GGwarn("GGEMSNavigatorManager", "BenchmarkFindSolid", 0) << method_names[method] << " found a different closest module for " << number_of_differences << " rays!!!" << GGendl;
+        }
+      }
+
+      opencl_manager.Deallocate(closest_solid_id, number_of_rays*sizeof(GGint), j, "GGEMSNavigatorManager");
+      opencl_manager.Deallocate(closest_distance, number_of_rays*sizeof(GGfloat), j, "GGEMSNavigatorManager");
+      opencl_manager.Deallocate(nodes_buffer, nodes.size()*sizeof(GGEMSBVHNode), j, "GGEMSNavigatorManager");
+      opencl_manager.Deallocate(solids_buffer, number_of_solids*sizeof(GGEMSBVHSolid), j, "GGEMSNavigatorManager");
+    }
+
+    GGcout("GGEMSNavigatorManager", "BenchmarkFindSolid", 1) << number_of_solids << " modules: BVH of " << nodes.size() << " nodes, depth " << depth << GGendl;
+
+    delete[] solids;
+  }
+
+  delete[] kernel_linear;
+  delete[] kernel_bvh;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -174,9 +535,51 @@ void GGEMSNavigatorManager::PrintInfos(void) const
 
 void GGEMSNavigatorManager::FindSolid(GGsize const& thread_index) const
 {
-  for (GGsize i = 0; i < number_of_navigators_; ++i) {
-    navigators_[i]->ParticleSolidDistance(thread_index);
+  if (!bvh_nodes_) {
+    for (GGsize i = 0; i < number_of_navigators_; ++i) {
+      navigators_[i]->ParticleSolidDistance(thread_index);
+    }
+    return;
   }
+
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSNavigatorManager::FindSolid on " << device_name << ", index " << device_index;
+
+  // Pointer to primary particles, and number to particles in buffer
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters
+  cl::Kernel* kernel = kernel_particle_solid_distance_bvh_[thread_index];
+  kernel->setArg(0, number_of_particles);
+  kernel->setArg(1, *primary_particles);
+  kernel->setArg(2, *bvh_nodes_[thread_index]);
+  kernel->setArg(3, *bvh_solids_[thread_index]);
+
+  // Launching kernel
+  cl::Event event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigatorManager", "FindSolid");
+  opencl_manager.ChainTransportEvent(thread_index, event);
+
+  // GGEMS Profiling
+  GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -215,9 +618,9 @@ void GGEMSNavigatorManager::WorldTracking(GGsize const& thread_index) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSNavigatorManager::ComputeDose(GGsize const& thread_index)
+void GGEMSNavigatorManager::ComputeDose(void)
 {
   for (GGsize i = 0; i < number_of_navigators_; ++i) {
-    navigators_[i]->ComputeDose(thread_index);
+    navigators_[i]->ComputeDose();
   }
 }
@@ -40,7 +40,9 @@
 GGEMSVoxelizedPhantom::GGEMSVoxelizedPhantom(std::string const& voxelized_phantom_name)
 : GGEMSNavigator(voxelized_phantom_name),
   voxelized_phantom_filename_(""),
-  range_data_filename_("")
+  range_data_filename_(""),
+  is_woodcock_(false),
+  label_layout_("linear")
 {
   GGcout("GGEMSVoxelizedPhantom", "GGEMSVoxelizedPhantom", 3) << "GGEMSVoxelizedPhantom creating..." << GGendl;
 
@@ -79,6 +81,13 @@ void GGEMSVoxelizedPhantom::CheckParameters(void) const
     oss << "You have to set a file with the range to material data!!!";
     GGEMSMisc::ThrowException("GGEMSVoxelizedPhantom", "CheckParameters", oss.str());
   }
+
+  // Woodcock tracking does not compute track length in voxels
+  if (is_woodcock_ && is_tle_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Woodcock tracking and TLE method can not be used together!!!";
+    GGEMSMisc::ThrowException("GGEMSVoxelizedPhantom", "CheckParameters", oss.str());
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -102,12 +111,17 @@ void GGEMSVoxelizedPhantom::Initialize(void)
   number_of_solids_ = 1;
 
   // Initializing voxelized solid for geometric navigation
+  GGEMSVoxelizedSolid* voxelized_solid = nullptr;
   if (is_dosimetry_mode_) {
-    solids_[0] = new GGEMSVoxelizedSolid(voxelized_phantom_filename_, range_data_filename_, "DOSIMETRY");
+    voxelized_solid = new GGEMSVoxelizedSolid(voxelized_phantom_filename_, range_data_filename_, "DOSIMETRY");
   }
   else {
-    solids_[0] = new GGEMSVoxelizedSolid(voxelized_phantom_filename_, range_data_filename_);
+    voxelized_solid = new GGEMSVoxelizedSolid(voxelized_phantom_filename_, range_data_filename_);
   }
+  solids_[0] = voxelized_solid;
+
+  // Layout of labels, applied when loading the image
+  voxelized_solid->SetLabelLayout(label_layout_);
 
   // Enabling tracking if necessary
   if (is_tracking_) solids_[0]->EnableTracking();
@@ -115,6 +129,12 @@ void GGEMSVoxelizedPhantom::Initialize(void)
   // Enabling TLE
   if (is_tle_) solids_[0]->AddKernelOption(" -DTLE");
 
+  // Enabling Woodcock tracking
+  if (is_woodcock_) solids_[0]->AddKernelOption(" -DWOODCOCK");
+
+  // Energy deposits scored as 64 bits integers
+  if (is_dosimetry_mode_ && dose_calculator_->IsFixedPointScoring()) solids_[0]->AddKernelOption(" -DDOSE_FIXED_POINT");
+
   // Load voxelized phantom from MHD file and storing materials
   solids_[0]->Initialize(materials_);
   solids_[0]->SetCustomMaterialColor(custom_material_rgb_);
@@ -146,7 +166,13 @@ void GGEMSVoxelizedPhantom::Initialize(void)
   GGEMSNavigator::Initialize();
 
   // Checking if dosimetry mode activated
-  if (is_dosimetry_mode_) dose_calculator_->Initialize();
+  if (is_dosimetry_mode_) {
+    dose_calculator_->Initialize();
+
+    if (is_woodcock_ && dose_calculator_->GetPhotonTrackingBuffer(0)) {
+      GGwarn("GGEMSVoxelizedPhantom", "Initialize", 0) << "Photon tracking is not recorded with Woodcock tracking, voxels are not crossed one by one!!!" << GGendl;
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -177,6 +203,49 @@ void GGEMSVoxelizedPhantom::SetPhantomFile(std::string const& voxelized_phantom_
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSVoxelizedPhantom::SetWoodcockTracking(bool const& is_woodcock)
+{
+  is_woodcock_ = is_woodcock;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedPhantom::SetLabelLayout(std::string const& label_layout)
+{
+  label_layout_ = label_layout;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedPhantom::BenchmarkLabelLayouts(GGsize const& number_of_rays) const
+{
+  if (!solids_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Voxelized phantom is not initialized!!!";
+    GGEMSMisc::ThrowException("GGEMSVoxelizedPhantom", "BenchmarkLabelLayouts", oss.str());
+  }
+
+  static_cast<GGEMSVoxelizedSolid*>(solids_[0])->BenchmarkLabelLayouts(number_of_rays);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedPhantom::BenchmarkLabelConversion(GGsize const& number_of_slices) const
+{
+  // Synthetic image, no need of an initialized phantom
+  GGEMSVoxelizedSolid::BenchmarkLabelConversion(number_of_slices);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGEMSVoxelizedPhantom* create_ggems_voxelized_phantom(char const* voxelized_phantom_name)
 {
   return new(std::nothrow) GGEMSVoxelizedPhantom(voxelized_phantom_name);
@@ -195,6 +264,42 @@ void set_phantom_file_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_p
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_woodcock)
+{
+  voxelized_phantom->SetWoodcockTracking(is_woodcock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_label_layout_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, char const* label_layout)
+{
+  voxelized_phantom->SetLabelLayout(label_layout);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void benchmark_label_layouts_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGsize const number_of_rays)
+{
+  voxelized_phantom->BenchmarkLabelLayouts(number_of_rays);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void benchmark_label_conversion_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGsize const number_of_slices)
+{
+  voxelized_phantom->BenchmarkLabelConversion(number_of_slices);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void set_position_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGfloat const position_x, GGfloat const position_y, GGfloat const position_z, char const* unit)
 {
   voxelized_phantom->SetPosition(position_x, position_y, position_z, unit);
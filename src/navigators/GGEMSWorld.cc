@@ -329,7 +329,7 @@ void GGEMSWorld::Tracking(GGsize const& thread_index)
   // Pointer to primary particles, and number to particles in buffer
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
@@ -373,12 +373,12 @@ void GGEMSWorld::Tracking(GGsize const& thread_index)
 
   // Launching kernel
   cl::Event event;
-  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_world_tracking_[thread_index], 0, global_wi, local_wi, nullptr, &event);
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_world_tracking_[thread_index], 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &event);
   opencl_manager.CheckOpenCLError(kernel_status, "GGEMSWorld", "Tracking");
+  opencl_manager.ChainTransportEvent(thread_index, event);
 
   // GGEMS Profiling
   GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
-  queue->finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -416,14 +416,13 @@ void GGEMSWorld::SavePhotonTracking(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGint* photon_tracking_device = opencl_manager.GetDeviceBuffer<GGint>(world_recording_.photon_tracking_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGint), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) photon_tracking[i] = photon_tracking_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) photon_tracking[i] += photon_tracking_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.photon_tracking_[j], photon_tracking_device, j);
   }
 
   // Writing data
-  mhdImage.Write<GGint>(photon_tracking);
-  delete[] photon_tracking;
+  mhdImage.WriteAsync<GGint>(photon_tracking);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -450,14 +449,13 @@ void GGEMSWorld::SaveEnergyTracking(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* edep_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.energy_tracking_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) edep_tracking[i] = edep_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) edep_tracking[i] += edep_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.energy_tracking_[j], edep_device, j);
   }
 
   // Writing data
-  mhdImage.Write<GGDosiType>(edep_tracking);
-  delete[] edep_tracking;
+  mhdImage.WriteAsync<GGDosiType>(edep_tracking);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -484,14 +482,13 @@ void GGEMSWorld::SaveEnergySquaredTracking(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* edep_squared_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.energy_squared_tracking_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) edep_squared_tracking[i] = edep_squared_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) edep_squared_tracking[i] += edep_squared_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.energy_squared_tracking_[j], edep_squared_device, j);
   }
 
   // Writing data
-  mhdImage.Write<GGDosiType>(edep_squared_tracking);
-  delete[] edep_squared_tracking;
+  mhdImage.WriteAsync<GGDosiType>(edep_squared_tracking);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -539,40 +536,37 @@ void GGEMSWorld::SaveMomentum(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* momentum_x_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.momentum_x_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_x[i] = momentum_x_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_x[i] += momentum_x_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.momentum_x_[j], momentum_x_device, j);
   }
 
   // Writing data
-  mhdImage_momentum_x.Write<GGDosiType>(momentum_x);
-  delete[] momentum_x;
+  mhdImage_momentum_x.WriteAsync<GGDosiType>(momentum_x);
 
   // Loop over all activated device
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* momentum_y_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.momentum_y_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_y[i] = momentum_y_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_y[i] += momentum_y_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.momentum_y_[j], momentum_y_device, j);
   }
 
   // Writing data
-  mhdImage_momentum_y.Write<GGDosiType>(momentum_y);
-  delete[] momentum_y;
+  mhdImage_momentum_y.WriteAsync<GGDosiType>(momentum_y);
 
   // Loop over all activated device
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* momentum_z_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.momentum_z_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_z[i] = momentum_z_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_z[i] += momentum_z_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.momentum_z_[j], momentum_z_device, j);
   }
 
   // Writing data
-  mhdImage_momentum_z.Write<GGDosiType>(momentum_z);
-  delete[] momentum_z;
+  mhdImage_momentum_z.WriteAsync<GGDosiType>(momentum_z);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -154,16 +154,11 @@ void GGEMSAttenuations::Initialize(void)
     // Getting the OpenCL pointer on Mu tables
     GGEMSMuMuEnData* mu_table_device = opencl_manager.GetDeviceBuffer<GGEMSMuMuEnData>(mu_tables_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMuMuEnData), d);
 
-    cl::Buffer* particle_cs = cross_sections_->GetCrossSections(d);
-    GGEMSParticleCrossSections* particle_cs_device =  opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cs, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSParticleCrossSections), d);
-
-    mu_table_device->number_of_materials_ = static_cast<GGint>(particle_cs_device->number_of_materials_);
+    mu_table_device->number_of_materials_ = static_cast<GGint>(materials_->GetNumberOfMaterials());
     mu_table_device->energy_max_ = ATTENUATION_ENERGY_MAX;
     mu_table_device->energy_min_ = ATTENUATION_ENERGY_MIN;
     mu_table_device->number_of_bins_ = ATTENUATION_TABLE_NUMBER_BINS;
 
-    opencl_manager.ReleaseDeviceBuffer(particle_cs, particle_cs_device, d);
-
     // Fill energy table with log scale
     GGfloat slope = logf(mu_table_device->energy_max_ / mu_table_device->energy_min_);
     GGint i = 0;
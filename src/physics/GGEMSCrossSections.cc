@@ -28,12 +28,16 @@
   \date Tuesday March 31, 2020
 */
 
+#include <algorithm>
+#include <cstring>
+
 #include "GGEMS/physics/GGEMSCrossSections.hh"
 #include "GGEMS/physics/GGEMSComptonScattering.hh"
 #include "GGEMS/physics/GGEMSPhotoElectricEffect.hh"
 #include "GGEMS/physics/GGEMSRayleighScattering.hh"
 #include "GGEMS/materials/GGEMSMaterials.hh"
 #include "GGEMS/physics/GGEMSProcessesManager.hh"
+#include "GGEMS/physics/GGEMSPhysicTablesRegistry.hh"
 #include "GGEMS/tools/GGEMSRAMManager.hh"
 #include "GGEMS/maths/GGEMSMathAlgorithms.hh"
 
@@ -55,14 +59,11 @@ GGEMSCrossSections::GGEMSCrossSections(GGEMSMaterials* materials)
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
 
-  // Allocating memory for cross section tables on host and device
-  particle_cross_sections_ = new cl::Buffer*[number_activated_devices_];
-  for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    particle_cross_sections_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSParticleCrossSections), i, CL_MEM_READ_WRITE, "GGEMSCrossSections");
-  }
-
-  // Useful to avoid memory transfer between host and OpenCL
-  particle_cross_sections_host_ = new GGEMSParticleCrossSections();
+  // Cross section tables are allocated during initialization, size depends on materials and bins
+  particle_cross_sections_ = nullptr;
+  particle_cross_sections_size_ = 0;
+  particle_cross_sections_host_ = nullptr;
+  physic_tables_key_.clear();
 
   materials_ = materials;
 
@@ -87,7 +88,7 @@ GGEMSCrossSections::~GGEMSCrossSections(void)
   }
 
   if (particle_cross_sections_host_) {
-    delete particle_cross_sections_host_;
+    delete[] reinterpret_cast<GGchar*>(particle_cross_sections_host_);
     particle_cross_sections_host_ = nullptr;
   }
 
@@ -102,13 +103,9 @@ void GGEMSCrossSections::Clean(void)
 {
   GGcout("GGEMSCrossSections", "Clean", 3) << "GGEMSCrossSections cleaning..." << GGendl;
 
-  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-
+  // Tables are deallocated by registry when no more navigator uses them
   if (particle_cross_sections_) {
-    for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(particle_cross_sections_[i], sizeof(GGEMSParticleCrossSections), i);
-    }
-    delete[] particle_cross_sections_;
+    GGEMSPhysicTablesRegistry::GetInstance().ReleaseCrossSections(physic_tables_key_);
     particle_cross_sections_ = nullptr;
   }
 
@@ -178,19 +175,50 @@ void GGEMSCrossSections::Initialize(void)
   // Get the process manager
   GGEMSProcessesManager& process_manager = GGEMSProcessesManager::GetInstance();
 
+  // Get the physic tables registry
+  GGEMSPhysicTablesRegistry& physic_tables_registry = GGEMSPhysicTablesRegistry::GetInstance();
+
   // Storing information for process manager
   GGsize number_of_bins = process_manager.GetCrossSectionTableNumberOfBins();
   GGfloat min_energy = process_manager.GetCrossSectionTableMinEnergy();
   GGfloat max_energy = process_manager.GetCrossSectionTableMaxEnergy();
+  GGsize number_of_materials = materials_->GetNumberOfMaterials();
+
+  // Tables depend only on energy grid, activated processes and materials
+  std::ostringstream key(std::ostringstream::out);
+  key << "[" << number_of_bins << " bins, " << min_energy << "-" << max_energy << " MeV] processes:";
+  for (GGsize i = 0; i < number_of_activated_processes_; ++i) key << " " << em_processes_list_[i]->GetProcessName();
+  key << ", materials:";
+  for (GGsize i = 0; i < number_of_materials; ++i) key << " " << materials_->GetMaterialName(i);
+  physic_tables_key_ = key.str();
+
+  particle_cross_sections_size_ = GetParticleCrossSectionsSize(number_of_bins, number_of_materials);
+
+  // Sharing tables if already built by another navigator
+  particle_cross_sections_ = physic_tables_registry.GetCrossSections(physic_tables_key_);
+  if (particle_cross_sections_) {
+    GGcout("GGEMSCrossSections", "Initialize", 1) << "Sharing cross section tables " << physic_tables_key_ << GGendl;
+    LoadPhysicTablesOnHost();
+    return;
+  }
+
+  ChronoTime start_time = GGEMSChrono::Now();
+
+  // Allocating memory for cross section tables on device, only used materials and bins
+  particle_cross_sections_ = new cl::Buffer*[number_activated_devices_];
+  for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    particle_cross_sections_[j] = opencl_manager.Allocate(nullptr, particle_cross_sections_size_, j, CL_MEM_READ_WRITE, "GGEMSCrossSections");
+  }
 
   // Initialize physics on each device
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGEMSParticleCrossSections* particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSParticleCrossSections), j);
+    GGEMSParticleCrossSections* particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, particle_cross_sections_size_, j);
 
     particle_cross_sections_device->number_of_bins_ = number_of_bins;
     particle_cross_sections_device->min_energy_ = min_energy;
     particle_cross_sections_device->max_energy_ = max_energy;
-    for (GGsize i = 0; i < materials_->GetNumberOfMaterials(); ++i) {
+    particle_cross_sections_device->number_of_activated_photon_processes_ = 0;
+    for (GGsize i = 0; i < number_of_materials; ++i) {
       #ifdef _WIN32
       strcpy_s(reinterpret_cast<char*>(particle_cross_sections_device->material_names_[i]), 32, (materials_->GetMaterialName(i)).c_str());
       #else
@@ -199,7 +227,7 @@ void GGEMSCrossSections::Initialize(void)
     }
 
     // Storing information from materials
-    particle_cross_sections_device->number_of_materials_ = static_cast<GGuchar>(materials_->GetNumberOfMaterials());
+    particle_cross_sections_device->number_of_materials_ = number_of_materials;
 
     // Filling energy table with log scale
     GGfloat slope = logf(max_energy/min_energy);
@@ -207,14 +235,27 @@ void GGEMSCrossSections::Initialize(void)
       particle_cross_sections_device->energy_bins_[i] = min_energy * expf(slope * (static_cast<float>(i) / (static_cast<GGfloat>(number_of_bins)-1.0f))) * MeV;
     }
 
+    // Parameters of log grid for direct computation of bin index
+    particle_cross_sections_device->log_min_energy_ = logf(min_energy * MeV);
+    particle_cross_sections_device->inverse_log_energy_step_ = (static_cast<GGfloat>(number_of_bins)-1.0f) / slope;
+
+    // Cross sections of processes not activated stay at 0 in material records
+    std::fill(particle_cross_sections_device->photon_cross_sections_, particle_cross_sections_device->photon_cross_sections_ + PHOTON_CROSS_SECTION_RECORD_SIZE*number_of_materials*number_of_bins, 0.0f);
+
     // Release pointer
     opencl_manager.ReleaseDeviceBuffer(particle_cross_sections_[j], particle_cross_sections_device, j);
 
     // Loop over the activated physic processes and building tables
     for (GGsize i = 0; i < number_of_activated_processes_; ++i)
-      em_processes_list_[i]->BuildCrossSectionTables(particle_cross_sections_[j], materials_->GetMaterialTables(j), j);
+      em_processes_list_[i]->BuildCrossSectionTables(particle_cross_sections_[j], particle_cross_sections_size_, materials_->GetMaterialTables(j), j);
+
+    // Total and majorant cross sections from built tables
+    BuildTotalCrossSections(j);
   }
 
+  // Registry owns the tables, other navigators with same materials and processes use them
+  physic_tables_registry.StoreCrossSections(physic_tables_key_, particle_cross_sections_, particle_cross_sections_size_, GGEMSChrono::Now() - start_time);
+
   // Copy data from device to RAM memory (optimization for python users)
   LoadPhysicTablesOnHost();
 }
@@ -223,47 +264,55 @@ void GGEMSCrossSections::Initialize(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSCrossSections::LoadPhysicTablesOnHost(void)
+void GGEMSCrossSections::BuildTotalCrossSections(GGsize const& thread_index)
 {
-  GGcout("GGEMSCrossSections", "LoadPhysicTablesOnHost", 1) << "Loading physic tables from OpenCL device to host (RAM)..." << GGendl;
+  GGcout("GGEMSCrossSections", "BuildTotalCrossSections", 3) << "Building total and majorant cross section tables..." << GGendl;
 
   // Get the OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
-  GGEMSParticleCrossSections* particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[0], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSParticleCrossSections), 0);
+  GGEMSParticleCrossSections* particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, particle_cross_sections_size_, thread_index);
 
-  particle_cross_sections_host_->number_of_bins_ = particle_cross_sections_device->number_of_bins_;
-  particle_cross_sections_host_->number_of_materials_ = particle_cross_sections_device->number_of_materials_;
-  particle_cross_sections_host_->min_energy_ = particle_cross_sections_device->min_energy_;
-  particle_cross_sections_host_->max_energy_ = particle_cross_sections_device->max_energy_;
+  GGsize number_of_bins = particle_cross_sections_device->number_of_bins_;
+  GGsize number_of_materials = particle_cross_sections_device->number_of_materials_;
 
-  for(GGuchar i = 0; i < particle_cross_sections_host_->number_of_materials_; ++i) {
-    for(GGuchar j = 0; j < 32; ++j) {
-      particle_cross_sections_host_->material_names_[i][j] = particle_cross_sections_device->material_names_[i][j];
+  for (GGsize i = 0; i < number_of_bins; ++i) {
+    GGfloat majorant_cross_section = 0.0f;
+
+    // Loop over materials, summing activated photon processes
+    for (GGsize j = 0; j < number_of_materials; ++j) {
+      GGfloat total_cross_section = 0.0f;
+      for (GGsize k = 0; k < particle_cross_sections_device->number_of_activated_photon_processes_; ++k) {
+        GGchar process_id = particle_cross_sections_device->photon_cs_id_[k];
+        total_cross_section += particle_cross_sections_device->photon_cross_sections_[PhotonCrossSectionIndex(number_of_bins, static_cast<GGsize>(process_id), j, i)];
+      }
+      particle_cross_sections_device->photon_cross_sections_[PhotonTotalCrossSectionIndex(number_of_bins, j, i)] = total_cross_section;
+      majorant_cross_section = std::max(majorant_cross_section, total_cross_section);
     }
-  }
 
-  for(GGushort i = 0; i < particle_cross_sections_host_->number_of_bins_; ++i) {
-    particle_cross_sections_host_->energy_bins_[i] = particle_cross_sections_device->energy_bins_[i];
+    particle_cross_sections_device->photon_majorant_cross_sections_[i] = majorant_cross_section;
   }
 
-  particle_cross_sections_host_->number_of_activated_photon_processes_ = particle_cross_sections_device->number_of_activated_photon_processes_;
+  // Release pointer
+  opencl_manager.ReleaseDeviceBuffer(particle_cross_sections_[thread_index], particle_cross_sections_device, thread_index);
+}
 
-  for(GGuchar i = 0; i < NUMBER_PHOTON_PROCESSES; ++i) {
-    particle_cross_sections_host_->photon_cs_id_[i] = particle_cross_sections_device->photon_cs_id_[i];
-  }
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-  for(GGuchar j = 0; j < NUMBER_PHOTON_PROCESSES; ++j) {
-    for(GGuint i = 0; i < 256*MAX_CROSS_SECTION_TABLE_NUMBER_BINS; ++i) {
-      particle_cross_sections_host_->photon_cross_sections_[j][i] = particle_cross_sections_device->photon_cross_sections_[j][i];
-    }
-  }
+void GGEMSCrossSections::LoadPhysicTablesOnHost(void)
+{
+  GGcout("GGEMSCrossSections", "LoadPhysicTablesOnHost", 1) << "Loading physic tables from OpenCL device to host (RAM)..." << GGendl;
 
-  for(GGuchar j = 0; j < NUMBER_PHOTON_PROCESSES; ++j) {
-    for(GGuint i = 0; i < 101*MAX_CROSS_SECTION_TABLE_NUMBER_BINS; ++i) {
-      particle_cross_sections_host_->photon_cross_sections_per_atom_[j][i] = particle_cross_sections_device->photon_cross_sections_per_atom_[j][i];
-    }
-  }
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGEMSParticleCrossSections* particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[0], CL_TRUE, CL_MAP_READ, particle_cross_sections_size_, 0);
+
+  // Host table has the same size than device table
+  if (!particle_cross_sections_host_) particle_cross_sections_host_ = reinterpret_cast<GGEMSParticleCrossSections*>(new GGchar[particle_cross_sections_size_]);
+  std::memcpy(particle_cross_sections_host_, particle_cross_sections_device, particle_cross_sections_size_);
 
   // Release pointer
   opencl_manager.ReleaseDeviceBuffer(particle_cross_sections_[0], particle_cross_sections_device, 0);
@@ -324,13 +373,13 @@ GGfloat GGEMSCrossSections::GetPhotonCrossSection(std::string const& process_nam
   GGfloat density = material_database_manager.GetMaterial(material_name).density_;
 
   // Computing the energy bin
-  GGsize energy_bin = static_cast<GGsize>(BinarySearchLeft(e_MeV, particle_cross_sections_host_->energy_bins_, static_cast<GGint>(number_of_bins), 0, 0));
+  GGsize energy_bin = static_cast<GGsize>(LogUniformBinIndex(e_MeV, particle_cross_sections_host_->energy_bins_, static_cast<GGint>(number_of_bins), particle_cross_sections_host_->log_min_energy_, particle_cross_sections_host_->inverse_log_energy_step_));
 
   // Compute cross section using linear interpolation
   GGfloat energy_a = particle_cross_sections_host_->energy_bins_[energy_bin];
   GGfloat energy_b = particle_cross_sections_host_->energy_bins_[energy_bin+1];
-  GGfloat cross_section_a = particle_cross_sections_host_->photon_cross_sections_[process_id][energy_bin + number_of_bins*mat_id];
-  GGfloat cross_section_b = particle_cross_sections_host_->photon_cross_sections_[process_id][energy_bin+1 + number_of_bins*mat_id];
+  GGfloat cross_section_a = particle_cross_sections_host_->photon_cross_sections_[PhotonCrossSectionIndex(number_of_bins, process_id, mat_id, energy_bin)];
+  GGfloat cross_section_b = particle_cross_sections_host_->photon_cross_sections_[PhotonCrossSectionIndex(number_of_bins, process_id, mat_id, energy_bin+1)];
 
   GGfloat cross_section = LinearInterpolation(energy_a, cross_section_a, energy_b, cross_section_b, e_MeV);
 
@@ -341,6 +390,82 @@ GGfloat GGEMSCrossSections::GetPhotonCrossSection(std::string const& process_nam
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSCrossSections::BenchmarkEnergyBinLookup(GGsize const& number_of_lookups) const
+{
+  if (!particle_cross_sections_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Cross section tables are not initialized!!!";
+    GGEMSMisc::ThrowException("GGEMSCrossSections", "BenchmarkEnergyBinLookup", oss.str());
+  }
+
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Compiling kernel on each device
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string filename = openCL_kernel_path + "/BenchmarkEnergyBinLookup.cl";
+  cl::Kernel** kernel_benchmark = new cl::Kernel*[number_activated_devices_];
+  opencl_manager.CompileKernel(filename, "benchmark_energy_bin_lookup", kernel_benchmark, nullptr, nullptr);
+
+  // Each work-item does several lookups to hide launch overhead
+  GGint lookups_per_work_item = 64;
+  GGsize number_of_work_items = std::max(number_of_lookups / static_cast<GGsize>(lookups_per_work_item), static_cast<GGsize>(1));
+  GGdouble total_lookups = static_cast<GGdouble>(number_of_work_items * static_cast<GGsize>(lookups_per_work_item));
+
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  cl::NDRange global_wi(opencl_manager.GetBestWorkItem(number_of_work_items));
+  cl::NDRange local_wi(work_group_size);
+
+  std::string method_names[2] = {"BinarySearchLeft", "LogUniformBinIndex"};
+
+  for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(j);
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(j);
+    cl::Buffer* checksum = opencl_manager.Allocate(nullptr, sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSCrossSections");
+
+    GGint checksums[2] = {0, 0};
+    for (GGchar is_log_uniform = 0; is_log_uniform < 2; ++is_log_uniform) {
+      opencl_manager.CleanBuffer(checksum, sizeof(GGint), j);
+
+      kernel_benchmark[j]->setArg(0, number_of_work_items);
+      kernel_benchmark[j]->setArg(1, lookups_per_work_item);
+      kernel_benchmark[j]->setArg(2, *particle_cross_sections_[j]);
+      kernel_benchmark[j]->setArg(3, is_log_uniform);
+      kernel_benchmark[j]->setArg(4, *checksum);
+
+      // Launching kernel and timing it on device
+      cl::Event event;
+      GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_benchmark[j], 0, global_wi, local_wi, nullptr, &event);
+      opencl_manager.CheckOpenCLError(kernel_status, "GGEMSCrossSections", "BenchmarkEnergyBinLookup");
+      event.wait();
+
+      GGulong start = 0, end = 0;
+      opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(event(), CL_PROFILING_COMMAND_START, sizeof(GGulong), &start, nullptr), "GGEMSCrossSections", "BenchmarkEnergyBinLookup");
+      opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(event(), CL_PROFILING_COMMAND_END, sizeof(GGulong), &end, nullptr), "GGEMSCrossSections", "BenchmarkEnergyBinLookup");
+
+      GGint* checksum_device = opencl_manager.GetDeviceBuffer<GGint>(checksum, CL_TRUE, CL_MAP_READ, sizeof(GGint), j);
+      checksums[is_log_uniform] = checksum_device[0];
+      opencl_manager.ReleaseDeviceBuffer(checksum, checksum_device, j);
+
+      GGdouble elapsed_seconds = static_cast<GGdouble>(end - start) * 1.0e-9;
+      GGcout("GGEMSCrossSections", "BenchmarkEnergyBinLookup", 0) << method_names[is_log_uniform] << " on " << opencl_manager.GetDeviceName(device_index) << ": "
+        << total_lookups / elapsed_seconds << " lookups/s (" << total_lookups << " lookups in " << elapsed_seconds * 1.0e3 << " ms)" << GGendl;
+    }
+
+    if (checksums[0] != checksums[1]) {
+      GGwarn("GGEMSCrossSections", "BenchmarkEnergyBinLookup", 0) << "BinarySearchLeft and LogUniformBinIndex found different bins!!!" << GGendl;
+    }
+
+    opencl_manager.Deallocate(checksum, sizeof(GGint), j, "GGEMSCrossSections");
+  }
+
+  delete[] kernel_benchmark;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGEMSCrossSections* create_ggems_cross_sections(GGEMSMaterials* materials)
 {
   return new(std::nothrow) GGEMSCrossSections(materials);
@@ -377,6 +502,15 @@ GGfloat get_cs_ggems_cross_sections(GGEMSCrossSections* cross_sections, char con
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void benchmark_energy_bin_lookup_ggems_cross_sections(GGEMSCrossSections* cross_sections, GGsize const number_of_lookups)
+{
+  cross_sections->BenchmarkEnergyBinLookup(number_of_lookups);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void clean_ggems_cross_sections(GGEMSCrossSections* cross_sections)
 {
   cross_sections->Clean();
@@ -62,7 +62,7 @@ GGEMSEMProcess::~GGEMSEMProcess(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index)
+void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections, GGsize const& particle_cross_sections_size, cl::Buffer* material_tables, GGsize const& thread_index)
 {
   // Getting OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
@@ -71,7 +71,7 @@ void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections
   GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 3) << "Building cross section table for process " << process_name_ << " on device: " << opencl_manager.GetDeviceName(device_index) << GGendl;
 
   // Set missing information in cross section table
-  GGEMSParticleCrossSections* cross_section_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSParticleCrossSections), thread_index);
+  GGEMSParticleCrossSections* cross_section_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, particle_cross_sections_size, thread_index);
 
   // Store index of activated process
   cross_section_device->photon_cs_id_[cross_section_device->number_of_activated_photon_processes_] = process_id_;
@@ -88,7 +88,7 @@ void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections
   for (GGsize j = 0; j < materials_device->number_of_materials_; ++j) {
     // Loop over the number of bins
     for (GGsize i = 0; i < number_of_bins; ++i) {
-      cross_section_device->photon_cross_sections_[process_id_][i + j*number_of_bins] = ComputeCrossSectionPerMaterial(cross_section_device, materials_device, j, i);
+      cross_section_device->photon_cross_sections_[PhotonCrossSectionIndex(number_of_bins, static_cast<GGsize>(process_id_), j, i)] = ComputeCrossSectionPerMaterial(cross_section_device, materials_device, j, i);
     }
   }
 
@@ -105,13 +105,13 @@ void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections
       // Loop over number of bins (energy)
       for (GGsize i = 0; i < number_of_bins; ++i) {
         GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "        + Energy: " << cross_section_device->energy_bins_[i]/keV << " keV, cross section: "
-          << (cross_section_device->photon_cross_sections_[process_id_][i + j*number_of_bins]/materials_device->density_of_material_[j])/(cm2/g) << " cm2.g-1" << GGendl;
+          << (cross_section_device->photon_cross_sections_[PhotonCrossSectionIndex(number_of_bins, static_cast<GGsize>(process_id_), j, i)]/materials_device->density_of_material_[j])/(cm2/g) << " cm2.g-1" << GGendl;
         // Loop over elements
         for (GGsize k = 0; k < materials_device->number_of_chemical_elements_[j]; ++k) {
           GGuchar atomic_number = materials_device->atomic_number_Z_[k+id_elt];
           GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "            # Element (Z): " << atomic_number
             << ", atomic number density: " << materials_device->atomic_number_density_[k+id_elt]/(1/cm3) << " atom/cm3, cross section per atom: "
-            << cross_section_device->photon_cross_sections_per_atom_[process_id_][i + atomic_number*number_of_bins]/(cm2)<< " cm2" << GGendl;
+            << cross_section_device->photon_cross_sections_[PhotonCrossSectionPerAtomIndex(number_of_bins, materials_device->number_of_materials_, static_cast<GGsize>(process_id_), atomic_number, i)]/(cm2)<< " cm2" << GGendl;
         }
       }
     }
@@ -136,7 +136,7 @@ GGfloat GGEMSEMProcess::ComputeCrossSectionPerMaterial(GGEMSParticleCrossSection
   for (GGsize i = 0; i < material_tables->number_of_chemical_elements_[material_index]; ++i) {
     GGuchar atomic_number = material_tables->atomic_number_Z_[i+index_of_offset];
     GGfloat cross_section_per_atom = ComputeCrossSectionPerAtom(energy, atomic_number);
-    cross_section_device->photon_cross_sections_per_atom_[process_id_][energy_index + atomic_number*cross_section_device->number_of_bins_] = cross_section_per_atom;
+    cross_section_device->photon_cross_sections_[PhotonCrossSectionPerAtomIndex(cross_section_device->number_of_bins_, cross_section_device->number_of_materials_, static_cast<GGsize>(process_id_), atomic_number, energy_index)] = cross_section_per_atom;
     cross_section_material += material_tables->atomic_number_density_[i+index_of_offset] * cross_section_per_atom;
   }
   return cross_section_material;
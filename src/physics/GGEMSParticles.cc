@@ -28,10 +28,14 @@
   \date Thrusday October 3, 2019
 */
 
+#include <algorithm>
+#include <vector>
+
 #include "GGEMS/physics/GGEMSPrimaryParticles.hh"
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 #include "GGEMS/tools/GGEMSRAMManager.hh"
 #include "GGEMS/tools/GGEMSProfilerManager.hh"
+#include "GGEMS/graphics/GGEMSOpenGLManager.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -40,10 +44,27 @@
 GGEMSParticles::GGEMSParticles(void)
 : number_of_particles_(nullptr),
   primary_particles_(nullptr),
+  next_primary_particles_(nullptr),
+  trajectories_(nullptr),
+  next_trajectories_(nullptr),
+  alive_count_host_(nullptr),
+  alive_count_(nullptr),
+  alive_count_event_(nullptr),
+  is_alive_count_enqueued_(nullptr),
   kernel_alive_(nullptr)
 {
   GGcout("GGEMSParticles", "GGEMSParticles", 3) << "GGEMSParticles creating..." << GGendl;
 
+  #ifdef PARTICLE_COMPACTION
+  number_of_live_particles_ = nullptr;
+  block_count_ = nullptr;
+  number_of_blocks_ = 0;
+  kernel_count_live_ = nullptr;
+  kernel_scan_live_ = nullptr;
+  kernel_add_live_offsets_ = nullptr;
+  kernel_compact_live_ = nullptr;
+  #endif
+
   GGcout("GGEMSParticles", "GGEMSParticles", 3) << "GGEMSParticles created!!!" << GGendl;
 }
 
@@ -64,20 +85,85 @@ GGEMSParticles::~GGEMSParticles(void)
 
   if (primary_particles_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(primary_particles_[i], sizeof(GGEMSPrimaryParticles), i);
+      GGsize primary_particles_size = GetPrimaryParticlesSize(opencl_manager.GetParticleStackSize(i));
+      opencl_manager.Deallocate(primary_particles_[i], primary_particles_size, i);
+      opencl_manager.Deallocate(next_primary_particles_[i], primary_particles_size, i);
       opencl_manager.Deallocate(status_[i], sizeof(GGint), i);
     }
     delete[] primary_particles_;
     primary_particles_ = nullptr;
+    delete[] next_primary_particles_;
+    next_primary_particles_ = nullptr;
     delete[] status_;
     status_ = nullptr;
   }
 
+  if (trajectories_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(trajectories_[i], sizeof(GGEMSParticleTrajectories), i);
+      opencl_manager.Deallocate(next_trajectories_[i], sizeof(GGEMSParticleTrajectories), i);
+    }
+    delete[] trajectories_;
+    trajectories_ = nullptr;
+    delete[] next_trajectories_;
+    next_trajectories_ = nullptr;
+  }
+
+  if (alive_count_host_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.ReleaseDeviceBuffer(alive_count_host_[i], alive_count_[i], i);
+      opencl_manager.Deallocate(alive_count_host_[i], sizeof(GGint), i);
+    }
+    delete[] alive_count_host_;
+    alive_count_host_ = nullptr;
+    delete[] alive_count_;
+    alive_count_ = nullptr;
+    delete[] alive_count_event_;
+    alive_count_event_ = nullptr;
+    delete[] is_alive_count_enqueued_;
+    is_alive_count_enqueued_ = nullptr;
+  }
+
   if (kernel_alive_) {
     delete[] kernel_alive_;
     kernel_alive_ = nullptr;
   }
 
+  #ifdef PARTICLE_COMPACTION
+  if (number_of_live_particles_) {
+    delete[] number_of_live_particles_;
+    number_of_live_particles_ = nullptr;
+  }
+
+  if (block_count_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(block_count_[i], number_of_blocks_*sizeof(GGint), i);
+    }
+    delete[] block_count_;
+    block_count_ = nullptr;
+  }
+
+  if (kernel_count_live_) {
+    delete[] kernel_count_live_;
+    kernel_count_live_ = nullptr;
+  }
+
+  if (kernel_scan_live_) {
+    delete[] kernel_scan_live_;
+    kernel_scan_live_ = nullptr;
+  }
+
+  if (kernel_add_live_offsets_) {
+    delete[] kernel_add_live_offsets_;
+    kernel_add_live_offsets_ = nullptr;
+  }
+
+  if (kernel_compact_live_) {
+    delete[] kernel_compact_live_;
+    kernel_compact_live_ = nullptr;
+  }
+  #endif
+
   GGcout("GGEMSParticles", "~GGEMSParticles", 3) << "GGEMSParticles erased!!!" << GGendl;
 }
 
@@ -88,6 +174,21 @@ GGEMSParticles::~GGEMSParticles(void)
 void GGEMSParticles::SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles)
 {
   number_of_particles_[thread_index] = number_of_particles;
+
+  // New batch, all particles are live
+  #ifdef PARTICLE_COMPACTION
+  number_of_live_particles_[thread_index] = number_of_particles;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::SwapBuffers(GGsize const& thread_index)
+{
+  std::swap(primary_particles_[thread_index], next_primary_particles_[thread_index]);
+  if (trajectories_) std::swap(trajectories_[thread_index], next_trajectories_[thread_index]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +212,19 @@ void GGEMSParticles::InitializeKernel(void)
 
   // Compiling kernel on each device
   opencl_manager.CompileKernel(filename, "is_alive", kernel_alive_, nullptr, nullptr);
+
+  // Kernels for compaction of live particles
+  #ifdef PARTICLE_COMPACTION
+  filename = openCL_kernel_path + "/CompactParticles.cl";
+  kernel_count_live_ = new cl::Kernel*[number_activated_devices_];
+  kernel_scan_live_ = new cl::Kernel*[number_activated_devices_];
+  kernel_add_live_offsets_ = new cl::Kernel*[number_activated_devices_];
+  kernel_compact_live_ = new cl::Kernel*[number_activated_devices_];
+  opencl_manager.CompileKernel(filename, "count_live_particles", kernel_count_live_, nullptr, nullptr);
+  opencl_manager.CompileKernel(filename, "scan_live_blocks", kernel_scan_live_, nullptr, nullptr);
+  opencl_manager.CompileKernel(filename, "add_live_block_offsets", kernel_add_live_offsets_, nullptr, nullptr);
+  opencl_manager.CompileKernel(filename, "compact_live_particles", kernel_compact_live_, nullptr, nullptr);
+  #endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -128,6 +242,10 @@ void GGEMSParticles::Initialize(void)
 
   number_of_particles_ = new GGsize[number_activated_devices_];
 
+  #ifdef PARTICLE_COMPACTION
+  number_of_live_particles_ = new GGsize[number_activated_devices_];
+  #endif
+
   // Allocation of the PrimaryParticle structure
   AllocatePrimaryParticles();
 
@@ -139,12 +257,19 @@ void GGEMSParticles::Initialize(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-bool GGEMSParticles::IsAlive(GGsize const& thread_index) const
+void GGEMSParticles::EnqueueAliveCount(GGsize const& thread_index) const
 {
   // Get command queue and event
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
 
+  // Get the counter of alive particles
+  cl::Buffer* status = status_[thread_index];
+
+  #ifdef PARTICLE_COMPACTION
+  // Compaction stage counts live particles in same time
+  CompactParticles(thread_index);
+  #else
   // Get Device name and storing methode name + device
   GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
   std::string device_name = opencl_manager.GetDeviceName(device_index);
@@ -153,7 +278,6 @@ bool GGEMSParticles::IsAlive(GGsize const& thread_index) const
 
   // Get the OpenCL buffers
   cl::Buffer* particles = primary_particles_[thread_index];
-  cl::Buffer* status = status_[thread_index];
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
@@ -163,33 +287,158 @@ bool GGEMSParticles::IsAlive(GGsize const& thread_index) const
   cl::NDRange global_wi(number_of_work_items);
   cl::NDRange local_wi(work_group_size);
 
+  // Reset counter, not blocking, after previous stage of transport
+  cl::Event clean_event;
+  GGint clean_status = queue->enqueueFillBuffer(*status, 0, 0, sizeof(GGint), opencl_manager.GetTransportWaitList(thread_index), &clean_event);
+  opencl_manager.CheckOpenCLError(clean_status, "GGEMSParticles", "EnqueueAliveCount");
+  opencl_manager.ChainTransportEvent(thread_index, clean_event);
+
   // Set parameters for kernel
   kernel_alive_[thread_index]->setArg(0, number_of_particles_[thread_index]);
   kernel_alive_[thread_index]->setArg(1, *particles);
   kernel_alive_[thread_index]->setArg(2, *status);
+  kernel_alive_[thread_index]->setArg(3, work_group_size*sizeof(GGint), nullptr);
 
   // Launching kernel
   cl::Event event;
-  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_alive_[thread_index], 0, global_wi, local_wi, nullptr, &event);
-  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "IsAlive");
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_alive_[thread_index], 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "EnqueueAliveCount");
+  opencl_manager.ChainTransportEvent(thread_index, event);
 
   // GGEMS Profiling
   GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
-  queue->finish();
+  #endif
 
-  // Get status from OpenCL device
-  GGint* status_device = opencl_manager.GetDeviceBuffer<GGint>(status_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGint), thread_index);
+  // Reading counter in pinned host memory without blocking
+  GGint read_status = queue->enqueueReadBuffer(*status, CL_FALSE, 0, sizeof(GGint), alive_count_[thread_index], opencl_manager.GetTransportWaitList(thread_index), &alive_count_event_[thread_index]);
+  opencl_manager.CheckOpenCLError(read_status, "GGEMSParticles", "EnqueueAliveCount");
+  opencl_manager.ChainTransportEvent(thread_index, alive_count_event_[thread_index]);
+  is_alive_count_enqueued_[thread_index] = true;
+}
 
-  GGint status_from_device = status_device[0];
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-  // Release the pointer
-  opencl_manager.ReleaseDeviceBuffer(status_[thread_index], status_device, thread_index);
+#ifdef PARTICLE_COMPACTION
+void GGEMSParticles::CompactParticles(GGsize const& thread_index) const
+{
+  // Get command queue
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
 
-  // Cleaning buffer
-  opencl_manager.CleanBuffer(status_[thread_index], sizeof(GGint), thread_index);
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSParticles::CompactParticles on " << device_name << ", index " << device_index;
+
+  // Get the OpenCL buffers
+  cl::Buffer* particles = primary_particles_[thread_index];
+  cl::Buffer* block_count = block_count_[thread_index];
+  cl::Buffer* live_counter = status_[thread_index];
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles_[thread_index]);
+  GGsize number_of_blocks = number_of_work_items / work_group_size;
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Pass 1: counting live particles in each work-group
+  kernel_count_live_[thread_index]->setArg(0, number_of_particles_[thread_index]);
+  kernel_count_live_[thread_index]->setArg(1, *particles);
+  kernel_count_live_[thread_index]->setArg(2, *block_count);
+  kernel_count_live_[thread_index]->setArg(3, work_group_size*sizeof(GGint), nullptr);
+
+  cl::Event count_event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_count_live_[thread_index], 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &count_event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "CompactParticles");
+  opencl_manager.ChainTransportEvent(thread_index, count_event);
+
+  // Pass 2: hierarchical prefix sum of work-group counts, each level stores the sum of its work-groups in the next level
+  // until a level fits in a single work-group, its total is the number of live particles
+  std::vector<GGsize> level_size(1, number_of_blocks);
+  std::vector<GGsize> level_offset(1, 0);
+  std::vector<cl::Event> scan_events;
+  while (true) {
+    GGsize number_of_groups = (level_size.back() + work_group_size - 1) / work_group_size;
+    GGsize sum_offset = level_offset.back() + level_size.back();
+
+    kernel_scan_live_[thread_index]->setArg(0, level_size.back());
+    kernel_scan_live_[thread_index]->setArg(1, *block_count);
+    kernel_scan_live_[thread_index]->setArg(2, level_offset.back());
+    kernel_scan_live_[thread_index]->setArg(3, sum_offset);
+    kernel_scan_live_[thread_index]->setArg(4, *live_counter);
+    kernel_scan_live_[thread_index]->setArg(5, work_group_size*sizeof(GGint), nullptr);
+
+    cl::Event scan_event;
+    kernel_status = queue->enqueueNDRangeKernel(*kernel_scan_live_[thread_index], 0, cl::NDRange(number_of_groups*work_group_size), local_wi, opencl_manager.GetTransportWaitList(thread_index), &scan_event);
+    opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "CompactParticles");
+    opencl_manager.ChainTransportEvent(thread_index, scan_event);
+    scan_events.push_back(scan_event);
+
+    if (number_of_groups == 1) break;
+
+    level_size.push_back(number_of_groups);
+    level_offset.push_back(sum_offset);
+  }
+
+  // Adding offsets of work-groups from upper level to lower level
+  for (GGsize level = level_size.size() - 1; level > 0; --level) {
+    GGsize number_of_groups = (level_size[level-1] + work_group_size - 1) / work_group_size;
+
+    kernel_add_live_offsets_[thread_index]->setArg(0, level_size[level-1]);
+    kernel_add_live_offsets_[thread_index]->setArg(1, *block_count);
+    kernel_add_live_offsets_[thread_index]->setArg(2, level_offset[level-1]);
+    kernel_add_live_offsets_[thread_index]->setArg(3, level_offset[level]);
+
+    cl::Event add_event;
+    kernel_status = queue->enqueueNDRangeKernel(*kernel_add_live_offsets_[thread_index], 0, cl::NDRange(number_of_groups*work_group_size), local_wi, opencl_manager.GetTransportWaitList(thread_index), &add_event);
+    opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "CompactParticles");
+    opencl_manager.ChainTransportEvent(thread_index, add_event);
+    scan_events.push_back(add_event);
+  }
+
+  // Pass 3: writing dense list of live particles
+  kernel_compact_live_[thread_index]->setArg(0, number_of_particles_[thread_index]);
+  kernel_compact_live_[thread_index]->setArg(1, *particles);
+  kernel_compact_live_[thread_index]->setArg(2, *block_count);
+  kernel_compact_live_[thread_index]->setArg(3, work_group_size*sizeof(GGint), nullptr);
+
+  cl::Event compact_event;
+  kernel_status = queue->enqueueNDRangeKernel(*kernel_compact_live_[thread_index], 0, global_wi, local_wi, opencl_manager.GetTransportWaitList(thread_index), &compact_event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "CompactParticles");
+  opencl_manager.ChainTransportEvent(thread_index, compact_event);
+
+  // GGEMS Profiling
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(count_event, oss.str());
+  for (auto&& scan_event : scan_events) profiler_manager.HandleEvent(scan_event, oss.str());
+  profiler_manager.HandleEvent(compact_event, oss.str());
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-  if (status_from_device == static_cast<GGint>(number_of_particles_[thread_index])) return false;
-  else return true;
+bool GGEMSParticles::IsAlive(GGsize const& thread_index) const
+{
+  if (!is_alive_count_enqueued_[thread_index]) EnqueueAliveCount(thread_index);
+
+  // Waiting only for the reading of counter
+  alive_count_event_[thread_index].wait();
+  is_alive_count_enqueued_[thread_index] = false;
+
+  // Next navigation kernels are dispatched only over live particles
+  #ifdef PARTICLE_COMPACTION
+  number_of_live_particles_[thread_index] = static_cast<GGsize>(alive_count_[thread_index][0]);
+  #endif
+
+  return alive_count_[thread_index][0] != 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -204,12 +453,55 @@ void GGEMSParticles::AllocatePrimaryParticles(void)
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
   primary_particles_ = new cl::Buffer*[number_activated_devices_];
+  next_primary_particles_ = new cl::Buffer*[number_activated_devices_];
   status_ = new cl::Buffer*[number_activated_devices_];
+  alive_count_host_ = new cl::Buffer*[number_activated_devices_];
+  alive_count_ = new GGint*[number_activated_devices_];
+  alive_count_event_ = new cl::Event[number_activated_devices_];
+  is_alive_count_enqueued_ = new bool[number_activated_devices_];
 
   // Loop over activated device and allocate particle buffer on each device
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    primary_particles_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSPrimaryParticles), i, CL_MEM_READ_WRITE, "GGEMSParticles");
+    GGsize primary_particles_size = GetPrimaryParticlesSize(opencl_manager.GetParticleStackSize(i));
+    primary_particles_[i] = opencl_manager.Allocate(nullptr, primary_particles_size, i, CL_MEM_READ_WRITE, "GGEMSParticles");
+    next_primary_particles_[i] = opencl_manager.Allocate(nullptr, primary_particles_size, i, CL_MEM_READ_WRITE, "GGEMSParticles");
     status_[i] = opencl_manager.Allocate(nullptr, sizeof(GGint), i, CL_MEM_READ_WRITE, "GGEMSParticles");
     opencl_manager.CleanBuffer(status_[i], sizeof(GGint), i);
+
+    // Pinned host memory receiving number of alive particles, mapped once
+    alive_count_host_[i] = opencl_manager.Allocate(nullptr, sizeof(GGint), i, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, "GGEMSParticles");
+    alive_count_[i] = opencl_manager.GetDeviceBuffer<GGint>(alive_count_host_[i], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGint), i);
+    alive_count_[i][0] = 0;
+    is_alive_count_enqueued_[i] = false;
+  }
+
+  // Trajectories of displayed particles, only if OpenGL is activated
+  #ifdef OPENGL_VISUALIZATION
+  if (GGEMSOpenGLManager::IsOpenGLActivated()) {
+    trajectories_ = new cl::Buffer*[number_activated_devices_];
+    next_trajectories_ = new cl::Buffer*[number_activated_devices_];
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      trajectories_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSParticleTrajectories), i, CL_MEM_READ_WRITE, "GGEMSParticles");
+      next_trajectories_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSParticleTrajectories), i, CL_MEM_READ_WRITE, "GGEMSParticles");
+    }
+  }
+  #endif
+
+  // Buffers storing number of live particles per work-group for compaction, followed by sums of upper levels of prefix sum
+  #ifdef PARTICLE_COMPACTION
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    GGsize level_size = opencl_manager.GetParticleStackSize(i) / work_group_size + 1;
+    GGsize number_of_blocks = level_size;
+    while (level_size > work_group_size) {
+      level_size = (level_size + work_group_size - 1) / work_group_size;
+      number_of_blocks += level_size;
+    }
+    number_of_blocks_ = std::max(number_of_blocks_, number_of_blocks);
+  }
+  block_count_ = new cl::Buffer*[number_activated_devices_];
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    block_count_[i] = opencl_manager.Allocate(nullptr, number_of_blocks_*sizeof(GGint), i, CL_MEM_READ_WRITE, "GGEMSParticles");
   }
+  #endif
 }
@@ -0,0 +1,145 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSPhysicTablesRegistry.cc
+
+  \brief GGEMS singleton storing the physic tables built on OpenCL devices, a table is built once for a set of materials, processes and energy grid and shared by navigators
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/physics/GGEMSPhysicTablesRegistry.hh"
+#include "GGEMS/physics/GGEMSParticleCrossSections.hh"
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGEMSPhysicTablesRegistry::GGEMSPhysicTablesRegistry(void)
+{
+  GGcout("GGEMSPhysicTablesRegistry", "GGEMSPhysicTablesRegistry", 3) << "GGEMSPhysicTablesRegistry creating..." << GGendl;
+
+  cross_sections_.clear();
+
+  GGcout("GGEMSPhysicTablesRegistry", "GGEMSPhysicTablesRegistry", 3) << "GGEMSPhysicTablesRegistry created!!!" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGEMSPhysicTablesRegistry::~GGEMSPhysicTablesRegistry(void)
+{
+  GGcout("GGEMSPhysicTablesRegistry", "~GGEMSPhysicTablesRegistry", 3) << "GGEMSPhysicTablesRegistry erasing..." << GGendl;
+
+  GGcout("GGEMSPhysicTablesRegistry", "~GGEMSPhysicTablesRegistry", 3) << "GGEMSPhysicTablesRegistry erased!!!" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+cl::Buffer** GGEMSPhysicTablesRegistry::GetCrossSections(std::string const& key)
+{
+  PhysicTableMap::iterator iter = cross_sections_.find(key);
+  if (iter == cross_sections_.end()) return nullptr;
+
+  iter->second.number_of_users_ += 1;
+  return iter->second.buffers_;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSPhysicTablesRegistry::StoreCrossSections(std::string const& key, cl::Buffer** cross_sections, GGsize const& size, DurationNano const& build_time)
+{
+  if (cross_sections_.find(key) != cross_sections_.end()) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Cross section tables '" << key << "' are already stored!!!";
+    GGEMSMisc::ThrowException("GGEMSPhysicTablesRegistry", "StoreCrossSections", oss.str());
+  }
+
+  GGEMSPhysicTable table;
+  table.buffers_ = cross_sections;
+  table.size_ = size;
+  table.number_of_users_ = 1;
+  table.build_time_ = build_time;
+
+  cross_sections_.insert(std::make_pair(key, table));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSPhysicTablesRegistry::ReleaseCrossSections(std::string const& key)
+{
+  PhysicTableMap::iterator iter = cross_sections_.find(key);
+  if (iter == cross_sections_.end()) return;
+
+  iter->second.number_of_users_ -= 1;
+  if (iter->second.number_of_users_ > 0) return;
+
+  GGcout("GGEMSPhysicTablesRegistry", "ReleaseCrossSections", 3) << "Deallocating cross section tables '" << key << "'..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  for (GGsize i = 0; i < opencl_manager.GetNumberOfActivatedDevice(); ++i) {
+    opencl_manager.Deallocate(iter->second.buffers_[i], iter->second.size_, i, "GGEMSCrossSections");
+  }
+  delete[] iter->second.buffers_;
+
+  cross_sections_.erase(iter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSPhysicTablesRegistry::PrintInfos(void) const
+{
+  GGsize number_of_users = 0;
+  GGsize allocated_memory = 0;
+  DurationNano build_time = GGEMSChrono::Zero();
+  DurationNano build_time_without_sharing = GGEMSChrono::Zero();
+
+  GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << "Physic tables:" << GGendl;
+  GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << "--------------" << GGendl;
+  for (auto&& i : cross_sections_) {
+    GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << "    * Cross sections " << i.first << GGendl;
+    GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << "        - Shared by " << i.second.number_of_users_ << " navigator(s)" << GGendl;
+    GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << "        - Size on each device: " << BestDigitalUnit(i.second.size_) << GGendl;
+    GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << "        - Build time: " << std::chrono::duration_cast<Ms>(i.second.build_time_).count() << " ms" << GGendl;
+
+    number_of_users += i.second.number_of_users_;
+    allocated_memory += i.second.size_;
+    build_time += i.second.build_time_;
+    build_time_without_sharing += i.second.build_time_ * static_cast<int64_t>(i.second.number_of_users_);
+  }
+
+  // Before registry, each navigator allocated a fixed size table and built it
+  GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << "    * Memory on each device: " << BestDigitalUnit(allocated_memory) << " (" << BestDigitalUnit(number_of_users*sizeof(GGEMSParticleCrossSections)) << " with a fixed size table by navigator)" << GGendl;
+  GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << "    * Initialization time: " << std::chrono::duration_cast<Ms>(build_time).count() << " ms (" << std::chrono::duration_cast<Ms>(build_time_without_sharing).count() << " ms with a table built by navigator)" << GGendl;
+  GGcout("GGEMSPhysicTablesRegistry", "PrintInfos", 0) << GGendl;
+}
@@ -28,12 +28,11 @@
   \date Monday December 16, 2019
 */
 
-#include <random>
-
 #include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
 #include "GGEMS/randoms/GGEMSRandom.hh"
 
 #include "GGEMS/tools/GGEMSRAMManager.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
 
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 
@@ -50,7 +49,9 @@
 
 GGEMSPseudoRandomGenerator::GGEMSPseudoRandomGenerator(void)
 : pseudo_random_numbers_(nullptr),
-  seed_(0)
+  next_pseudo_random_numbers_(nullptr),
+  seed_(0),
+  kernel_initialize_batch_random_(nullptr)
 {
   GGcout("GGEMSPseudoRandomGenerator", "GGEMSPseudoRandomGenerator", 3) << "GGEMSPseudoRandomGenerator creating..." << GGendl;
 
@@ -69,10 +70,19 @@ GGEMSPseudoRandomGenerator::~GGEMSPseudoRandomGenerator(void)
 
   if (pseudo_random_numbers_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(pseudo_random_numbers_[i], sizeof(GGEMSRandom), i);
+      GGsize random_size = GetRandomSize(opencl_manager.GetParticleStackSize(i));
+      opencl_manager.Deallocate(pseudo_random_numbers_[i], random_size, i);
+      opencl_manager.Deallocate(next_pseudo_random_numbers_[i], random_size, i);
     }
     delete[] pseudo_random_numbers_;
     pseudo_random_numbers_ = nullptr;
+    delete[] next_pseudo_random_numbers_;
+    next_pseudo_random_numbers_ = nullptr;
+  }
+
+  if (kernel_initialize_batch_random_) {
+    delete[] kernel_initialize_batch_random_;
+    kernel_initialize_batch_random_ = nullptr;
   }
 
   GGcout("GGEMSPseudoRandomGenerator", "~GGEMSPseudoRandomGenerator", 3) << "GGEMSPseudoRandomGenerator erased!!!" << GGendl;
@@ -129,41 +139,79 @@ void GGEMSPseudoRandomGenerator::Initialize(GGuint const& seed)
   // Allocation of the Random structure
   AllocateRandom();
 
-  // Generate seeds for each particle
-  InitializeSeeds();
+  // Kernel for random substream of batch
+  InitializeKernel();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSPseudoRandomGenerator::InitializeSeeds(void)
+void GGEMSPseudoRandomGenerator::InitializeKernel(void)
 {
-  GGcout("GGEMSPseudoRandomGenerator", "InitializeSeeds", 1) << "Initialization of seeds for each particles..." << GGendl;
+  GGcout("GGEMSPseudoRandomGenerator", "InitializeKernel", 3) << "Initializing kernel..." << GGendl;
 
-  // Initialize the Mersenne Twister engine
-  std::mt19937 mt_gen(seed_);
+  // Getting the path to kernel
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string filename = openCL_kernel_path + "/InitializeBatchRandom.cl";
 
-  // Get the OpenCL manager
+  // Storing a kernel for each device
+  kernel_initialize_batch_random_ = new cl::Kernel*[number_activated_devices_];
+
+  // Compiling kernel on each device
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  opencl_manager.CompileKernel(filename, "initialize_batch_random", kernel_initialize_batch_random_, nullptr, nullptr);
+}
 
-  // Loop over activated device
-  for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    // Get the pointer on device
-    GGEMSRandom* random_device = opencl_manager.GetDeviceBuffer<GGEMSRandom>(pseudo_random_numbers_[i], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSRandom), i);
-
-    // For each particle a seed is generated
-    for (GGsize j = 0; j < MAXIMUM_PARTICLES; ++j) {
-      random_device->prng_state_1_[j] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_2_[j] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_3_[j] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_4_[j] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_5_[j] = 0;
-    }
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    // Release the pointer, mandatory step!!!
-    opencl_manager.ReleaseDeviceBuffer(pseudo_random_numbers_[i], random_device, i);
-  }
+cl::Event GGEMSPseudoRandomGenerator::InitializeBatch(GGsize const& thread_index, GGsize const& source_index, GGsize const& first_particle, GGsize const& number_of_particles) const
+{
+  // Get generation command queue and event
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetGenerationCommandQueue(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSPseudoRandomGenerator::InitializeBatch on " << device_name << ", index " << device_index;
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Set parameters for kernel
+  kernel_initialize_batch_random_[thread_index]->setArg(0, number_of_particles);
+  kernel_initialize_batch_random_[thread_index]->setArg(1, *next_pseudo_random_numbers_[thread_index]);
+  kernel_initialize_batch_random_[thread_index]->setArg(2, seed_);
+  kernel_initialize_batch_random_[thread_index]->setArg(3, static_cast<GGuint>(source_index));
+  kernel_initialize_batch_random_[thread_index]->setArg(4, first_particle);
+
+  // Launching kernel
+  cl::Event event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_initialize_batch_random_[thread_index], 0, global_wi, local_wi, nullptr, &event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSPseudoRandomGenerator", "InitializeBatch");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
+
+  return event;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSPseudoRandomGenerator::SwapBuffers(GGsize const& thread_index)
+{
+  std::swap(pseudo_random_numbers_[thread_index], next_pseudo_random_numbers_[thread_index]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -182,8 +230,11 @@ void GGEMSPseudoRandomGenerator::AllocateRandom(void)
 
   // Allocation of memory on OpenCL device
   pseudo_random_numbers_ = new cl::Buffer*[number_activated_devices_];
+  next_pseudo_random_numbers_ = new cl::Buffer*[number_activated_devices_];
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    pseudo_random_numbers_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSRandom), i, CL_MEM_READ_WRITE, "GGEMSPseudoRandomGenerator");
+    GGsize random_size = GetRandomSize(opencl_manager.GetParticleStackSize(i));
+    pseudo_random_numbers_[i] = opencl_manager.Allocate(nullptr, random_size, i, CL_MEM_READ_WRITE, "GGEMSPseudoRandomGenerator");
+    next_pseudo_random_numbers_[i] = opencl_manager.Allocate(nullptr, random_size, i, CL_MEM_READ_WRITE, "GGEMSPseudoRandomGenerator");
   }
 }
 
@@ -199,39 +250,15 @@ void GGEMSPseudoRandomGenerator::PrintInfos(void) const
   // Getting OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
-  // Loop over the activated devices
+  // States are set on device for each batch, from seed, source index and particle index in source
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
     GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
-
-    GGEMSRandom* random_device = opencl_manager.GetDeviceBuffer<GGEMSRandom>(pseudo_random_numbers_[i], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSRandom), i);
-
-    GGuint state[2][5] = {
-      {
-        random_device->prng_state_1_[0],
-        random_device->prng_state_2_[0],
-        random_device->prng_state_3_[0],
-        random_device->prng_state_4_[0],
-        random_device->prng_state_5_[0]
-      },
-      {
-        random_device->prng_state_1_[1],
-        random_device->prng_state_2_[1],
-        random_device->prng_state_3_[1],
-        random_device->prng_state_4_[1],
-        random_device->prng_state_5_[1]
-      }
-    };
-
-    // Release the pointer, mandatory step!!!
-    opencl_manager.ReleaseDeviceBuffer(pseudo_random_numbers_[i], random_device, i);
-
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Device: " << opencl_manager.GetDeviceName(device_index) << GGendl;
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "-------" << GGendl;
-    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Random state of two first particles for JKISS engine:" << GGendl;
-    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 0: " << state[0][0] << " " << state[1][0] << GGendl;
-    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 1: " << state[0][1] << " " << state[1][1] << GGendl;
-    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 2: " << state[0][2] << " " << state[1][2] << GGendl;
-    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 3: " << state[0][3] << " " << state[1][3] << GGendl;
-    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 4: " << state[0][4] << " " << state[1][4] << GGendl;
+    #ifdef PHILOX_RANDOM
+    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Philox4x32-10 engine, key: seed and source index, counter: particle index in source and number of draws" << GGendl;
+    #else
+    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "JKISS engine, states of each particle hashed from seed, source index and particle index in source" << GGendl;
+    #endif
   }
 }
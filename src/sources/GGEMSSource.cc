@@ -41,9 +41,6 @@
 GGEMSSource::GGEMSSource(std::string const& source_name)
 : source_name_(source_name),
   number_of_particles_(0),
-  number_of_particles_by_device_(nullptr),
-  number_of_particles_in_batch_(nullptr),
-  number_of_batchs_(nullptr),
   particle_type_(99),
   tracking_kernel_option_("")
 {
@@ -78,30 +75,11 @@ GGEMSSource::~GGEMSSource(void)
     geometry_transformation_ = nullptr;
   }
 
-  if (number_of_batchs_) {
-    delete number_of_batchs_;
-    number_of_batchs_ = nullptr;
-  }
-
-  if (number_of_particles_by_device_) {
-    delete number_of_particles_by_device_;
-    number_of_particles_by_device_ = nullptr;
-  }
-
   if (kernel_get_primaries_) {
     delete[] kernel_get_primaries_;
     kernel_get_primaries_ = nullptr;
   }
 
-  if (number_of_particles_in_batch_) {
-    for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      delete number_of_particles_in_batch_[i];
-      number_of_particles_in_batch_[i] = nullptr;
-    }
-    delete[] number_of_particles_in_batch_;
-    number_of_particles_in_batch_ = nullptr;
-  }
-
   GGcout("GGEMSSource", "~GGEMSSource", 3) << "GGEMSSource erased!!!" << GGendl;
 }
 
@@ -223,67 +201,6 @@ void GGEMSSource::CheckParameters(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSSource::OrganizeParticlesInBatch(void)
-{
-  GGcout("GGEMSSource", "OrganizeParticlesInBatch", 3) << "Organizing the number of particles in batch..." << GGendl;
-
-  // Getting OpenCL singleton
-  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-
-  // Computing number of particles to simulate for each device
-  number_of_particles_by_device_ = new GGsize[number_activated_devices_];
-  if (opencl_manager.GetNumberDeviceBalancing() == 0) {
-    for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      number_of_particles_by_device_[i] = number_of_particles_ / number_activated_devices_;
-    }
-
-    // Adding the remaing particles
-    for (GGsize i = 0; i < number_of_particles_ % number_activated_devices_; ++i) {
-      number_of_particles_by_device_[i]++;
-    }
-  }
-  else {
-    GGsize tmp_number_of_particles = 0;
-    for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      number_of_particles_by_device_[i] = static_cast<GGsize>(static_cast<GGfloat>(number_of_particles_) * opencl_manager.GetDeviceBalancing(i));
-      tmp_number_of_particles += number_of_particles_by_device_[i];
-    }
-
-    // Checking number of particle
-    if (tmp_number_of_particles != number_of_particles_) {
-      number_of_particles_by_device_[0] += static_cast<GGsize>(abs(static_cast<GGlong>(number_of_particles_ - tmp_number_of_particles)));
-    }
-  }
-
-  // Computing number of batch for each device
-  number_of_particles_in_batch_ = new GGsize*[number_activated_devices_];
-  number_of_batchs_ = new GGsize[number_activated_devices_];
-  for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    number_of_batchs_[i] = static_cast<GGsize>(std::ceil(static_cast<GGfloat>(number_of_particles_by_device_[i]) / MAXIMUM_PARTICLES));
-
-    number_of_particles_in_batch_[i] = new GGsize[number_of_batchs_[i]];
-
-    // Computing the number of simulated particles in batch
-    if (number_of_batchs_[i] == 1) {
-      number_of_particles_in_batch_[i][0] = number_of_particles_by_device_[i];
-    }
-    else {
-      for (GGsize j = 0; j < number_of_batchs_[i]; ++j) {
-        number_of_particles_in_batch_[i][j] = number_of_particles_by_device_[i] / number_of_batchs_[i];
-      }
-
-      // Adding the remaing particles
-      for (GGsize j = 0; j < number_of_particles_by_device_[i] % number_of_batchs_[i]; ++j) {
-        number_of_particles_in_batch_[i][j]++;
-      }
-    }
-  }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-
 void GGEMSSource::Initialize(bool const& is_tracking)
 {
   GGcout("GGEMSSource", "Initialize", 3) << "Initializing the a GGEMS source..." << GGendl;
@@ -291,11 +208,8 @@ void GGEMSSource::Initialize(bool const& is_tracking)
   // Checking the parameters of Source
   CheckParameters();
 
-  // Organize the particles in batch
-  OrganizeParticlesInBatch();
-
   // Enable tracking
   if (is_tracking) EnableTracking();
 
-  GGcout("GGEMSSource", "Initialize", 0) << "Particles arranged in batch OK" << GGendl;
+  GGcout("GGEMSSource", "Initialize", 0) << "Source initialized OK" << GGendl;
 }
@@ -28,9 +28,22 @@
   \date Thursday January 16, 2020
 */
 
+#include <mutex>
+#include <algorithm>
+#include <cmath>
+
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 #include "GGEMS/physics/GGEMSPrimaryParticles.hh"
 #include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
+
+/*!
+  \namespace
+  \brief empty namespace storing mutex
+*/
+namespace {
+  std::mutex mutex; /*!< Mutex variable */
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -38,7 +51,17 @@
 
 GGEMSSourceManager::GGEMSSourceManager(void)
 : sources_(nullptr),
-  number_of_sources_(0)
+  number_of_sources_(0),
+  number_activated_devices_(0),
+  next_particle_(nullptr),
+  initial_device_share_(nullptr),
+  device_throughput_(nullptr),
+  next_number_of_particles_(nullptr),
+  generation_start_event_(nullptr),
+  generation_end_event_(nullptr),
+  transport_start_event_(nullptr),
+  transport_end_event_(nullptr),
+  is_transport_started_(nullptr)
 {
   GGcout("GGEMSSourceManager", "GGEMSSourceManager", 3) << "GGEMSSourceManager creating..." << GGendl;
 
@@ -80,6 +103,51 @@ void GGEMSSourceManager::Clean(void)
     pseudo_random_generator_ = nullptr;
   }
 
+  if (next_particle_) {
+    delete[] next_particle_;
+    next_particle_ = nullptr;
+  }
+
+  if (initial_device_share_) {
+    delete[] initial_device_share_;
+    initial_device_share_ = nullptr;
+  }
+
+  if (device_throughput_) {
+    delete[] device_throughput_;
+    device_throughput_ = nullptr;
+  }
+
+  if (next_number_of_particles_) {
+    delete[] next_number_of_particles_;
+    next_number_of_particles_ = nullptr;
+  }
+
+  if (generation_start_event_) {
+    delete[] generation_start_event_;
+    generation_start_event_ = nullptr;
+  }
+
+  if (generation_end_event_) {
+    delete[] generation_end_event_;
+    generation_end_event_ = nullptr;
+  }
+
+  if (transport_start_event_) {
+    delete[] transport_start_event_;
+    transport_start_event_ = nullptr;
+  }
+
+  if (transport_end_event_) {
+    delete[] transport_end_event_;
+    transport_end_event_ = nullptr;
+  }
+
+  if (is_transport_started_) {
+    delete[] is_transport_started_;
+    is_transport_started_ = nullptr;
+  }
+
   GGcout("GGEMSSourceManager", "Clean", 3) << "GGEMSSourceManager cleaned!!!" << GGendl;
 }
 
@@ -127,29 +195,205 @@ void GGEMSSourceManager::PrintInfos(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-GGsize GGEMSSourceManager::GetTotalNumberOfBatchs(void) const
+GGsize GGEMSSourceManager::GetTotalNumberOfParticles(void) const
 {
-  // Getting the number of activated device
+  GGsize total_number_of_particles = 0;
+  for (GGsize i = 0; i < number_of_sources_; ++i) total_number_of_particles += sources_[i]->GetNumberOfParticles();
+
+  return total_number_of_particles;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::InitializeBatchQueue(void)
+{
+  GGcout("GGEMSSourceManager", "InitializeBatchQueue", 3) << "Initializing the batch queue..." << GGendl;
+
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-  GGsize number_of_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
-
-  // Loop over number of sources
-  GGsize total_number_of_batchs = 0;
-  for (GGsize i = 0; i < number_of_sources_; ++i) {
-    // Loop over the number of activated devices
-    for (GGsize j = 0; j < number_of_activated_devices; ++j) {
-      total_number_of_batchs += sources_[i]->GetNumberOfBatchs(j);
+  number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
+
+  // First particle to simulate for each source
+  next_particle_ = new GGsize[number_of_sources_];
+  for (GGsize i = 0; i < number_of_sources_; ++i) next_particle_[i] = 0;
+
+  // Share of devices using device balancing if defined, throughput unknown before first batch
+  initial_device_share_ = new GGdouble[number_activated_devices_];
+  device_throughput_ = new GGdouble[number_activated_devices_];
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    if (opencl_manager.GetNumberDeviceBalancing() == 0) {
+      initial_device_share_[i] = 1.0 / static_cast<GGdouble>(number_activated_devices_);
+    }
+    else {
+      initial_device_share_[i] = static_cast<GGdouble>(opencl_manager.GetDeviceBalancing(i));
     }
+    device_throughput_[i] = 0.0;
   }
 
-  return total_number_of_batchs;
+  // Double buffering, next batch is generated during transport of current batch
+  next_number_of_particles_ = new GGsize[number_activated_devices_];
+  generation_start_event_ = new cl::Event[number_activated_devices_];
+  generation_end_event_ = new cl::Event[number_activated_devices_];
+  transport_start_event_ = new cl::Event[number_activated_devices_];
+  transport_end_event_ = new cl::Event[number_activated_devices_];
+  is_transport_started_ = new bool[number_activated_devices_];
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    next_number_of_particles_[i] = 0;
+    is_transport_started_[i] = false;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking, GGint const& particle_tracking_id) const
+bool GGEMSSourceManager::GetNextBatch(GGsize const& source_index, GGsize const& thread_index, GGsize& first_particle, GGsize& number_of_particles)
+{
+  mutex.lock();
+
+  GGsize remaining_particles = sources_[source_index]->GetNumberOfParticles() - next_particle_[source_index];
+  if (remaining_particles == 0) {
+    mutex.unlock();
+    return false;
+  }
+
+  // Share of device, computed from throughput when all devices are measured
+  GGdouble device_share = initial_device_share_[thread_index];
+  GGdouble total_throughput = 0.0;
+  bool is_measured = true;
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    if (device_throughput_[i] == 0.0) is_measured = false;
+    total_throughput += device_throughput_[i];
+  }
+  if (is_measured) device_share = device_throughput_[thread_index] / total_throughput;
+
+  // Share of remaining particles for the device (guided scheduling), batchs are smaller at the end and devices finish together
+  GGsize particle_stack_size = GGEMSOpenCLManager::GetInstance().GetParticleStackSize(thread_index);
+  GGsize minimum_batch_size = std::max(particle_stack_size / 64, static_cast<GGsize>(1));
+  GGsize batch_size = static_cast<GGsize>(std::ceil(static_cast<GGdouble>(remaining_particles) * device_share));
+  batch_size = std::max(batch_size, minimum_batch_size);
+  batch_size = std::min(batch_size, particle_stack_size);
+  batch_size = std::min(batch_size, remaining_particles);
+
+  first_particle = next_particle_[source_index];
+  number_of_particles = batch_size;
+  next_particle_[source_index] += batch_size;
+
+  mutex.unlock();
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::UpdateDeviceThroughput(GGsize const& thread_index, GGsize const& number_of_particles, DurationNano const& elapsed_time)
+{
+  GGdouble elapsed_seconds = static_cast<GGdouble>(elapsed_time.count()) * 1.0e-9;
+  if (elapsed_seconds <= 0.0) return;
+
+  GGdouble throughput = static_cast<GGdouble>(number_of_particles) / elapsed_seconds;
+
+  mutex.lock();
+  // Smoothing throughput between batchs
+  device_throughput_[thread_index] = device_throughput_[thread_index] == 0.0 ? throughput : 0.5 * (device_throughput_[thread_index] + throughput);
+  mutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& first_particle, GGsize const& number_of_particles)
+{
+  next_number_of_particles_[thread_index] = number_of_particles;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* generation_queue = opencl_manager.GetGenerationCommandQueue(thread_index);
+
+  // Buffers of next batch were used by transport of previous batch, generation queue waits for its end
+  if (is_transport_started_[thread_index]) {
+    std::vector<cl::Event> transport_end(1, transport_end_event_[thread_index]);
+    GGint barrier_status = generation_queue->enqueueBarrierWithWaitList(&transport_end, nullptr);
+    opencl_manager.CheckOpenCLError(barrier_status, "GGEMSSourceManager", "GetPrimaries");
+  }
+
+  // Random substream of batch, independent of device and size of batch
+  generation_start_event_[thread_index] = pseudo_random_generator_->InitializeBatch(thread_index, source_index, first_particle, number_of_particles);
+
+  sources_[source_index]->GetPrimaries(thread_index, number_of_particles);
+
+  // Marker of end of generation, not blocking
+  GGint marker_status = generation_queue->enqueueMarkerWithWaitList(nullptr, &generation_end_event_[thread_index]);
+  opencl_manager.CheckOpenCLError(marker_status, "GGEMSSourceManager", "GetPrimaries");
+
+  // Old behavior, host waits for the end of generation
+  if (opencl_manager.IsBlockingStages()) generation_end_event_[thread_index].wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::SwapParticleBuffers(GGsize const& thread_index)
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+
+  // End of transport of previous batch, last command of its event chain
+  GGint marker_status = queue->enqueueMarkerWithWaitList(opencl_manager.GetTransportWaitList(thread_index), &transport_end_event_[thread_index]);
+  opencl_manager.CheckOpenCLError(marker_status, "GGEMSSourceManager", "SwapParticleBuffers");
+  opencl_manager.ChainTransportEvent(thread_index, transport_end_event_[thread_index]);
+  transport_end_event_[thread_index].wait();
+
+  // Waiting for generation of next batch only to read its profiling infos, transport of next batch depends on it by event
+  generation_end_event_[thread_index].wait();
+
+  // Overlap between generation of next batch and transport of previous batch, using device timer
+  if (is_transport_started_[thread_index]) {
+    GGulong generation_start = 0, generation_end = 0, transport_start = 0, transport_end = 0;
+    opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(generation_start_event_[thread_index](), CL_PROFILING_COMMAND_START, sizeof(GGulong), &generation_start, nullptr), "GGEMSSourceManager", "SwapParticleBuffers");
+    opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(generation_end_event_[thread_index](), CL_PROFILING_COMMAND_END, sizeof(GGulong), &generation_end, nullptr), "GGEMSSourceManager", "SwapParticleBuffers");
+    opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(transport_start_event_[thread_index](), CL_PROFILING_COMMAND_END, sizeof(GGulong), &transport_start, nullptr), "GGEMSSourceManager", "SwapParticleBuffers");
+    opencl_manager.CheckOpenCLError(clGetEventProfilingInfo(transport_end_event_[thread_index](), CL_PROFILING_COMMAND_END, sizeof(GGulong), &transport_end, nullptr), "GGEMSSourceManager", "SwapParticleBuffers");
+
+    GGulong overlap_start = std::max(generation_start, transport_start);
+    GGulong overlap_end = std::min(generation_end, transport_end);
+    GGulong overlap = overlap_end > overlap_start ? overlap_end - overlap_start : 0;
+    GGulong generation = generation_end > generation_start ? generation_end - generation_start : 0;
+
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "GGEMSSourceManager::GetPrimaries on " << opencl_manager.GetDeviceName(device_index) << ", index " << device_index;
+    GGEMSProfilerManager::GetInstance().AddOverlapTime(oss.str(), DurationNano(static_cast<int64_t>(overlap)), DurationNano(static_cast<int64_t>(generation)));
+  }
+
+  // Particles and random numbers of next batch become the transported ones
+  particles_->SwapBuffers(thread_index);
+  pseudo_random_generator_->SwapBuffers(thread_index);
+  particles_->SetNumberOfParticles(thread_index, next_number_of_particles_[thread_index]);
+
+  // First stage of new batch waits for its generation, enqueued on generation command queue
+  opencl_manager.AddTransportDependency(thread_index, generation_end_event_[thread_index]);
+
+  // Identity list of live particles for the new batch
+  #ifdef PARTICLE_COMPACTION
+  particles_->CompactParticles(thread_index);
+  #endif
+
+  // Start of transport of new batch
+  marker_status = queue->enqueueMarkerWithWaitList(opencl_manager.GetTransportWaitList(thread_index), &transport_start_event_[thread_index]);
+  opencl_manager.CheckOpenCLError(marker_status, "GGEMSSourceManager", "SwapParticleBuffers");
+  opencl_manager.ChainTransportEvent(thread_index, transport_start_event_[thread_index]);
+  is_transport_started_[thread_index] = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking, GGint const& particle_tracking_id)
 {
   GGcout("GGEMSSourceManager", "Initialize", 3) << "Initializing the GGEMS source(s)..." << GGendl;
 
@@ -170,6 +414,9 @@ void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking,
   // Initialization of sources
   for (GGsize i = 0; i < number_of_sources_; ++i) sources_[i]->Initialize(is_tracking);
 
+  // Initialization of batch queue shared by devices
+  InitializeBatchQueue();
+
   // If tracking activated, set the particle id to track
   if (is_tracking) {
     // Get the OpenCL manager
@@ -178,12 +425,17 @@ void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking,
     // Loop over activated device
     for (GGsize i = 0; i < opencl_manager.GetNumberOfActivatedDevice(); ++i) {
       // Get pointer on OpenCL device for particles
-      GGEMSPrimaryParticles* primary_particles_device = opencl_manager.GetDeviceBuffer<GGEMSPrimaryParticles>(particles_->GetPrimaryParticles(i), CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSPrimaryParticles), i);
+      GGEMSPrimaryParticles* primary_particles_device = opencl_manager.GetDeviceBuffer<GGEMSPrimaryParticles>(particles_->GetPrimaryParticles(i), CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, GetPrimaryParticlesFixedSize(), i);
 
       primary_particles_device->particle_tracking_id = particle_tracking_id;
 
       // Release the pointer
       opencl_manager.ReleaseDeviceBuffer(particles_->GetPrimaryParticles(i), primary_particles_device, i);
+
+      // Same id for buffer of next batch
+      primary_particles_device = opencl_manager.GetDeviceBuffer<GGEMSPrimaryParticles>(particles_->GetNextPrimaryParticles(i), CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, GetPrimaryParticlesFixedSize(), i);
+      primary_particles_device->particle_tracking_id = particle_tracking_id;
+      opencl_manager.ReleaseDeviceBuffer(particles_->GetNextPrimaryParticles(i), primary_particles_device, i);
     }
   }
 }
@@ -192,6 +444,15 @@ void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking,
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSSourceManager::EnqueueAliveCount(GGsize const& thread_index) const
+{
+  particles_->EnqueueAliveCount(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 bool GGEMSSourceManager::IsAlive(GGsize const& thread_index) const
 {
   // Check if all particles are DEAD in OpenCL particle buffer
@@ -138,9 +138,9 @@ void GGEMSXRaySource::InitializeKernel(void)
 
 void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& number_of_particles)
 {
-  // Get command queue and event
+  // Get generation command queue and event, primaries are generated in same time as transport of current batch
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::CommandQueue* queue = opencl_manager.GetGenerationCommandQueue(thread_index);
 
   // Get Device name and storing methode name + device
   GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
@@ -148,11 +148,12 @@ void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& num
   std::ostringstream oss(std::ostringstream::out);
   oss << "GGEMSXRaySource::GetPrimaries on " << device_name << ", index " << device_index;
 
-  // Get the OpenCL buffers
+  // Get the OpenCL buffers of next batch
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
-  cl::Buffer* particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index);
+  cl::Buffer* particles = source_manager.GetParticles()->GetNextPrimaryParticles(thread_index);
+  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetNextPseudoRandomNumbers(thread_index);
   cl::Buffer* matrix_transformation = geometry_transformation_->GetTransformationMatrix(thread_index);
+  cl::Buffer* trajectories = source_manager.GetParticles()->GetNextTrajectories(thread_index);
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
@@ -173,6 +174,7 @@ void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& num
   kernel_get_primaries_[thread_index]->setArg(7, beam_aperture_);
   kernel_get_primaries_[thread_index]->setArg(8, focal_spot_size_);
   kernel_get_primaries_[thread_index]->setArg(9, *matrix_transformation);
+  if (trajectories) kernel_get_primaries_[thread_index]->setArg(10, *trajectories); // Only with OpenGL
 
   // Launching kernel
   cl::Event event;
@@ -182,7 +184,6 @@ void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& num
   // GGEMS Profiling
   GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
   profiler_manager.HandleEvent(event, oss.str());
-  queue->finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -217,8 +218,7 @@ void GGEMSXRaySource::PrintInfos(void) const
     else if (particle_type_ == POSITRON) {
       std::cout << "Positron" << std::endl;
     }
-    GGcout("GGEMSXRaySource", "PrintInfos", 0) << "* Number of particles: " << number_of_particles_by_device_[j] << GGendl;
-    GGcout("GGEMSXRaySource", "PrintInfos", 0) << "* Number of batches: " << number_of_batchs_[j] << GGendl;
+    GGcout("GGEMSXRaySource", "PrintInfos", 0) << "* Number of particles: " << number_of_particles_ << ", batches are shared between devices" << GGendl;
     GGcout("GGEMSXRaySource", "PrintInfos", 0) << "* Energy mode: ";
     if (is_monoenergy_mode_) {
       std::cout << "Monoenergy" << std::endl;
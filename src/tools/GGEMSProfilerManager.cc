@@ -49,6 +49,8 @@ GGEMSProfilerManager::GGEMSProfilerManager(void)
   GGcout("GGEMSProfilerManager", "GGEMSProfilerManager", 3) << "GGEMSProfilerManager creating..." << GGendl;
 
   profilers_.clear();
+  saved_launches_.clear();
+  overlaps_.clear();
 
   GGcout("GGEMSProfilerManager", "GGEMSProfilerManager", 3) << "GGEMSProfilerManager created!!!" << GGendl;
 }
@@ -62,6 +64,8 @@ GGEMSProfilerManager::~GGEMSProfilerManager(void)
   GGcout("GGEMSProfilerManager", "~GGEMSProfilerManager", 3) << "GGEMSProfilerManager erasing!!!" << GGendl;
 
   profilers_.clear();
+  saved_launches_.clear();
+  overlaps_.clear();
 
   GGcout("GGEMSProfilerManager", "~GGEMSProfilerManager", 3) << "GGEMSProfilerManager erased!!!" << GGendl;
 }
@@ -101,9 +105,50 @@ void GGEMSProfilerManager::HandleEvent(cl::Event event, std::string const& profi
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSProfilerManager::AddSavedKernelLaunches(std::string const& profile_name, GGsize const& number_of_launches)
+{
+  mutex.lock();
+
+  saved_launches_[profile_name] += number_of_launches;
+
+  mutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSProfilerManager::AddOverlapTime(std::string const& profile_name, DurationNano const& overlapped_time, DurationNano const& total_time)
+{
+  mutex.lock();
+
+  if (overlaps_.find(profile_name) == overlaps_.end()) {
+    overlaps_.insert(std::make_pair(profile_name, std::make_pair(DurationNano::zero(), DurationNano::zero())));
+  }
+
+  overlaps_[profile_name].first += overlapped_time;
+  overlaps_[profile_name].second += total_time;
+
+  mutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSProfilerManager::PrintSummaryProfile(void) const
 {
   for (auto&& p: profilers_) GGEMSChrono::DisplayTime(p.second.GetSummaryTime(), p.first);
+
+  for (auto&& s: saved_launches_) {
+    GGcout("GGEMSProfilerManager", "PrintSummaryProfile", 0) << s.first << ": " << s.second << " kernel launches saved" << GGendl;
+  }
+
+  for (auto&& o: overlaps_) {
+    GGdouble overlap_percent = o.second.second.count() > 0 ? 100.0 * static_cast<GGdouble>(o.second.first.count()) / static_cast<GGdouble>(o.second.second.count()) : 0.0;
+    GGcout("GGEMSProfilerManager", "PrintSummaryProfile", 0) << o.first << ": " << overlap_percent << " % overlapped with transport" << GGendl;
+    GGEMSChrono::DisplayTime(o.second.first, o.first + " (overlapped)");
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -113,6 +158,8 @@ void GGEMSProfilerManager::PrintSummaryProfile(void) const
 void GGEMSProfilerManager::Reset(void)
 {
   profilers_.clear();
+  saved_launches_.clear();
+  overlaps_.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////